@@ -0,0 +1,336 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "binaryconfig.hpp"
+#include <magnet/errno.hpp>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace dynamo
+{
+  namespace binaryconfig
+  {
+    const char extension[] = ".dyn";
+
+    namespace {
+      const char magic[8] = {'D', 'y', 'n', 'a', 'm', 'O', 'B', 'C'};
+    }
+
+    bool isBinaryFile(const std::string& fileName)
+    {
+      const size_t len = std::strlen(extension);
+      return (fileName.size() > len)
+	&& (fileName.compare(fileName.size() - len, len, extension) == 0);
+    }
+  }
+
+  using namespace binaryconfig;
+
+  BinaryConfigWriter::BinaryConfigWriter():
+    _fileName("memory"),
+    _toMemory(true),
+    _pos(0),
+    _inBlock(false)
+  {
+    writeEmptyHeader();
+  }
+
+  BinaryConfigWriter::BinaryConfigWriter(const std::string& fileName):
+    _fileName(fileName),
+    _file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc),
+    _toMemory(false),
+    _pos(0),
+    _inBlock(false)
+  {
+    if (!_file)
+      M_throw() << "Could not open " << fileName << " for writing";
+
+    writeEmptyHeader();
+  }
+
+  void
+  BinaryConfigWriter::writeEmptyHeader()
+  {
+    //The header is written again by finish(), until then the magic
+    //is zero and the file cannot be loaded
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    write(&header, sizeof(header));
+    pad();
+  }
+
+  size_t
+  BinaryConfigWriter::beginBlock(const std::string& name, size_t elementSize)
+  {
+    if (_inBlock)
+      M_throw() << "Cannot begin the block \"" << name
+		<< "\" inside another block";
+
+    BlockEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+
+    if (name.size() >= sizeof(entry.name))
+      M_throw() << "The block name \"" << name << "\" is too long";
+
+    if (!elementSize)
+      M_throw() << "The block \"" << name << "\" has a zero element size";
+
+    std::strcpy(entry.name, name.c_str());
+    entry.offset = _pos;
+    entry.elementSize = elementSize;
+    _blocks.push_back(entry);
+    _inBlock = true;
+    return _blocks.size() - 1;
+  }
+
+  void
+  BinaryConfigWriter::write(const void* data, size_t bytes)
+  {
+    if (_toMemory)
+      _buffer.append(static_cast<const char*>(data), bytes);
+    else
+      _file.write(static_cast<const char*>(data), bytes);
+    _pos += bytes;
+  }
+
+  void
+  BinaryConfigWriter::endBlock()
+  {
+    if (!_inBlock)
+      M_throw() << "No block to end";
+
+    BlockEntry& entry = _blocks.back();
+    const uint64_t bytes = _pos - entry.offset;
+    if (bytes % entry.elementSize)
+      M_throw() << "The block \"" << entry.name << "\" holds " << bytes
+		<< " bytes, which is not a multiple of its element size of "
+		<< entry.elementSize;
+
+    entry.count = bytes / entry.elementSize;
+    _inBlock = false;
+    pad();
+  }
+
+  void
+  BinaryConfigWriter::finish()
+  {
+    if (_inBlock)
+      M_throw() << "Cannot finish the file while the block \""
+		<< _blocks.back().name << "\" is open";
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.endianTag = endianTag;
+    header.blockCount = _blocks.size();
+    header.indexOffset = _pos;
+
+    if (!_blocks.empty())
+      write(&_blocks[0], sizeof(BlockEntry) * _blocks.size());
+
+    if (_toMemory)
+      {
+	std::memcpy(&_buffer[0], &header, sizeof(header));
+	return;
+      }
+
+    _file.seekp(0);
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _file.close();
+
+    if (_file.fail())
+      M_throw() << "Failed while writing " << _fileName;
+  }
+
+  void
+  BinaryConfigWriter::swapData(std::string& data)
+  {
+    if (!_toMemory)
+      M_throw() << "The binary configuration " << _fileName
+		<< " is being written to a file, not to memory";
+
+    _buffer.swap(data);
+  }
+
+  void
+  BinaryConfigWriter::copyBlocks(const BinaryConfigReader& file)
+  {
+    for (size_t id(0); id < file.getBlockCount(); ++id)
+      {
+	const size_t elementSize = file.getElementSize(id);
+	beginBlock(file.getBlockName(id), elementSize);
+	write(file.getBlockData(id, elementSize), elementSize * file.getCount(id));
+	endBlock();
+      }
+  }
+
+  void
+  BinaryConfigWriter::pad()
+  {
+    static const char zeros[alignment] = {0};
+    write(zeros, (alignment - _pos % alignment) % alignment);
+  }
+
+  BinaryConfigReader::BinaryConfigReader(const std::string& fileName):
+    _fileName(fileName),
+    _mapped(false),
+    _data(NULL),
+    _size(0),
+    _index(NULL),
+    _blockCount(0)
+  {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+      M_throw() << "Could not open " << fileName << ", "
+		<< magnet::strerror(errno);
+
+    struct stat info;
+    if (fstat(fd, &info) == -1)
+      {
+	int err = errno;
+	close(fd);
+	M_throw() << "Could not stat " << fileName << ", "
+		  << magnet::strerror(err);
+      }
+
+    _size = info.st_size;
+    if (_size < sizeof(Header))
+      {
+	close(fd);
+	M_throw() << fileName << " is too small to be a binary configuration file";
+      }
+
+    void* ptr = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd);
+    if (ptr == MAP_FAILED)
+      M_throw() << "Could not map " << fileName << " into memory, "
+		<< magnet::strerror(err);
+    _data = static_cast<const char*>(ptr);
+    _mapped = true;
+
+    try {
+      readIndex();
+    }
+    catch (...)
+      {
+	munmap(const_cast<char*>(_data), _size);
+	throw;
+      }
+  }
+
+  BinaryConfigReader::BinaryConfigReader(const char* data, size_t size):
+    _fileName("memory"),
+    _mapped(false),
+    _data(data),
+    _size(size),
+    _index(NULL),
+    _blockCount(0)
+  {
+    if (_size < sizeof(Header))
+      M_throw() << "The data is too small to be a binary configuration file";
+
+    readIndex();
+  }
+
+  void
+  BinaryConfigReader::readIndex()
+  {
+    const Header& header = *reinterpret_cast<const Header*>(_data);
+    if (std::memcmp(header.magic, magic, sizeof(magic)))
+      M_throw() << _fileName << " is not a binary configuration file"
+		<< " (or it was not completely written)";
+
+    if (header.endianTag != endianTag)
+      M_throw() << _fileName << " was written on a machine of a different endianness";
+
+    if (header.version != version)
+      M_throw() << _fileName << " is a version " << header.version
+		<< " binary configuration file, only version " << version
+		<< " is supported";
+
+    if ((header.indexOffset > _size)
+	|| (header.blockCount > (_size - header.indexOffset) / sizeof(BlockEntry)))
+      M_throw() << "The block index of " << _fileName << " is truncated";
+
+    _index = reinterpret_cast<const BlockEntry*>(_data + header.indexOffset);
+    _blockCount = header.blockCount;
+
+    for (size_t id(0); id < _blockCount; ++id)
+      {
+	const BlockEntry& block = _index[id];
+	if (!block.elementSize
+	    || (block.offset > header.indexOffset)
+	    || (block.count > (header.indexOffset - block.offset) / block.elementSize)
+	    || (std::memchr(block.name, 0, sizeof(block.name)) == NULL))
+	  M_throw() << "Block " << id << " of " << _fileName << " is corrupt";
+      }
+  }
+
+  BinaryConfigReader::~BinaryConfigReader()
+  {
+    if (_mapped)
+      munmap(const_cast<char*>(_data), _size);
+  }
+
+  bool
+  BinaryConfigReader::hasBlock(const std::string& name) const
+  {
+    for (size_t id(0); id < _blockCount; ++id)
+      if (name == _index[id].name) return true;
+    return false;
+  }
+
+  size_t
+  BinaryConfigReader::findBlock(const std::string& name) const
+  {
+    for (size_t id(0); id < _blockCount; ++id)
+      if (name == _index[id].name) return id;
+
+    M_throw() << "Could not find the block \"" << name << "\" in " << _fileName;
+  }
+
+  std::string
+  BinaryConfigReader::getBlockName(size_t id) const
+  { return entry(id).name; }
+
+  const void*
+  BinaryConfigReader::getBlockData(size_t id, size_t elementSize) const
+  {
+    const BlockEntry& block = entry(id);
+    if (block.elementSize != elementSize)
+      M_throw() << "The block \"" << block.name << "\" of " << _fileName
+		<< " has elements of " << block.elementSize
+		<< " bytes, but elements of " << elementSize << " bytes were expected";
+
+    return _data + block.offset;
+  }
+
+  const BlockEntry&
+  BinaryConfigReader::entry(size_t id) const
+  {
+    if (id >= _blockCount)
+      M_throw() << "Block " << id << " was requested but " << _fileName
+		<< " only has " << _blockCount << " blocks";
+
+    return _index[id];
+  }
+}
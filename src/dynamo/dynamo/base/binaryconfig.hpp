@@ -0,0 +1,251 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <magnet/exception.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace dynamo
+{
+  /*! \brief The on-disk layout of the binary configuration files.
+   *
+   * A binary configuration is a header, followed by a sequence of
+   * blocks of raw, native endian data, followed by an index of the
+   * blocks. Each block holds an array of fixed size elements and
+   * starts on a 64 byte boundary, so it can be used in place once the
+   * file is mapped into memory.
+   *
+   * One block, named "Metadata", holds a normal DynamOconfig XML
+   * document describing the dynamics, interactions, scheduler etc. The
+   * large per-particle arrays (positions, velocities, properties and
+   * capture maps) are stored in the other blocks, and the XML refers
+   * to them instead of holding the values (see
+   * SimData::writeXMLfile).
+   */
+  namespace binaryconfig
+  {
+    //! \brief The file name extension of binary configuration files.
+    extern const char extension[];
+
+    //! \brief The version of the container layout, bumped on any change.
+    const uint32_t version = 1;
+
+    //! \brief Used to detect a file written on a machine of the other endianness.
+    const uint32_t endianTag = 0x01020304;
+
+    //! \brief Blocks are padded to start on multiples of this many bytes.
+    const size_t alignment = 64;
+
+    struct Header
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t endianTag;
+      uint64_t blockCount;
+      uint64_t indexOffset;
+      char reserved[32];
+    };
+
+    struct BlockEntry
+    {
+      char name[40];
+      uint64_t offset;
+      uint64_t elementSize;
+      uint64_t count;
+    };
+
+    //! \brief Test if a file name has the binary configuration extension.
+    bool isBinaryFile(const std::string& fileName);
+  }
+
+  class BinaryConfigReader;
+
+  /*! \brief Writes a binary configuration file in a single pass.
+   *
+   * The blocks are streamed to the file one after another. The block
+   * index is written at the end of the file by finish(), which then
+   * fills in the header. A file which is not finished has no valid
+   * header and cannot be read.
+   * \code
+   * BinaryConfigWriter out("config.dyn");
+   * out.beginBlock("Position", sizeof(double));
+   * out.write(data, sizeof(double) * N);
+   * out.endBlock();
+   * out.finish();
+   * \endcode
+   *
+   * The default constructor builds the file in memory instead, which
+   * lets a configuration be captured quickly and written to the disk
+   * later (see SimData::writeXMLfileAsync).
+   */
+  class BinaryConfigWriter
+  {
+  public:
+    //! \brief Write the file to memory, it is fetched using swapData().
+    BinaryConfigWriter();
+
+    explicit BinaryConfigWriter(const std::string& fileName);
+
+    /*! \brief Start a new block.
+     *
+     * \param name The name of the block, used to find it when loading.
+     * \param elementSize The size of the elements in the block.
+     * \return The index of the block, which may be used to refer to
+     * blocks which do not have a unique name.
+     */
+    size_t beginBlock(const std::string& name, size_t elementSize);
+
+    //! \brief Append raw data to the current block.
+    void write(const void* data, size_t bytes);
+
+    //! \brief Append one value to the current block.
+    template<class T>
+    void write(const T& val) { write(&val, sizeof(T)); }
+
+    //! \brief Write an array of plain data as a whole block.
+    template<class T>
+    void writeBlock(const std::string& name, const std::vector<T>& data)
+    {
+      beginBlock(name, sizeof(T));
+      if (!data.empty())
+	write(&data[0], sizeof(T) * data.size());
+      endBlock();
+    }
+
+    //! \brief Write a single plain data value as a whole block.
+    template<class T>
+    void writeValue(const std::string& name, const T& val)
+    {
+      beginBlock(name, sizeof(T));
+      write(val);
+      endBlock();
+    }
+
+    //! \brief Copy every block of another file into this one.
+    void copyBlocks(const BinaryConfigReader& file);
+
+    //! \brief Close the current block, its size must be a whole number of elements.
+    void endBlock();
+
+    //! \brief Write the block index and the header.
+    void finish();
+
+    //! \brief Take the contents of a finished file written to memory.
+    void swapData(std::string& data);
+
+  private:
+    void writeEmptyHeader();
+    void pad();
+
+    std::string _fileName;
+    std::ofstream _file;
+    std::string _buffer;
+    bool _toMemory;
+    std::vector<binaryconfig::BlockEntry> _blocks;
+    uint64_t _pos;
+    bool _inBlock;
+  };
+
+  /*! \brief Maps a binary configuration file into memory.
+   *
+   * The blocks are accessed in place, so only the pages of the file
+   * which are used are read from the disk, and no memory beyond the
+   * page cache is needed to hold the file. The pointers returned
+   * by getBlock are only valid while the reader exists.
+   */
+  class BinaryConfigReader
+  {
+  public:
+    explicit BinaryConfigReader(const std::string& fileName);
+
+    /*! \brief Read a file held in memory (e.g., from
+     * BinaryConfigWriter::swapData), which must outlive the reader.
+     */
+    BinaryConfigReader(const char* data, size_t size);
+
+    ~BinaryConfigReader();
+
+    size_t getBlockCount() const { return _blockCount; }
+
+    //! \brief Test if there is a block with the passed name.
+    bool hasBlock(const std::string& name) const;
+
+    //! \brief Returns the index of the first block with the passed name.
+    size_t findBlock(const std::string& name) const;
+
+    //! \brief The name of a block.
+    std::string getBlockName(size_t id) const;
+
+    //! \brief The number of elements in a block.
+    size_t getCount(size_t id) const { return entry(id).count; }
+
+    //! \brief The size of the elements of a block.
+    size_t getElementSize(size_t id) const { return entry(id).elementSize; }
+
+    /*! \brief Returns a pointer to the elements of a block.
+     *
+     * \tparam T The element type, its size must match the element
+     * size of the block.
+     */
+    template<class T>
+    const T* getBlock(size_t id) const
+    { return static_cast<const T*>(getBlockData(id, sizeof(T))); }
+
+    //! \brief Returns a pointer to the raw data of a block of elements of size \p elementSize.
+    const void* getBlockData(size_t id, size_t elementSize) const;
+
+    //! \brief Copy the named block of plain data into an array.
+    template<class T>
+    void readBlock(const std::string& name, std::vector<T>& data) const
+    {
+      const size_t id = findBlock(name);
+      const T* values = getBlock<T>(id);
+      data.assign(values, values + getCount(id));
+    }
+
+    //! \brief Read a block written by BinaryConfigWriter::writeValue.
+    template<class T>
+    T readValue(const std::string& name) const
+    {
+      const size_t id = findBlock(name);
+      if (getCount(id) != 1)
+	M_throw() << "The block \"" << name << "\" of " << _fileName
+		  << " holds " << getCount(id) << " values, not one";
+      return *getBlock<T>(id);
+    }
+
+  private:
+    BinaryConfigReader(const BinaryConfigReader&);
+    BinaryConfigReader& operator=(const BinaryConfigReader&);
+
+    const binaryconfig::BlockEntry& entry(size_t id) const;
+
+    //! \brief Check the header and the block index of the file.
+    void readIndex();
+
+    std::string _fileName;
+    bool _mapped;
+    const char* _data;
+    size_t _size;
+    const binaryconfig::BlockEntry* _index;
+    size_t _blockCount;
+  };
+}
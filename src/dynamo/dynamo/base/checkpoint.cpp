@@ -0,0 +1,128 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "checkpoint.hpp"
+#include <magnet/stream/bzip2.hpp>
+#include <magnet/errno.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <time.h>
+
+namespace dynamo
+{
+  namespace {
+    double now()
+    {
+      timespec t;
+      clock_gettime(CLOCK_MONOTONIC, &t);
+      return double(t.tv_sec) + 1e-9 * double(t.tv_nsec);
+    }
+  }
+
+  CheckpointWriter::CheckpointWriter(magnet::thread::WorkStealingPool* pool):
+    _pool(pool),
+    _running(false),
+    _count(0),
+    _totalStall(0),
+    _maxStall(0),
+    _lastStall(0)
+  {}
+
+  CheckpointWriter::~CheckpointWriter()
+  {
+    try { wait(); }
+    catch (std::exception& err)
+      { std::cerr << err.what() << std::endl; }
+  }
+
+  double
+  CheckpointWriter::write(const std::string& fileName, std::string& image)
+  {
+    const double start = now();
+    wait();
+    const double waited = now() - start;
+
+    _fileName = fileName;
+    _image.clear();
+    _image.swap(image);
+    _running = true;
+    _thread.startTask(magnet::function::Task::makeTask(&CheckpointWriter::run, this));
+    return waited;
+  }
+
+  void
+  CheckpointWriter::wait()
+  {
+    if (!_running) return;
+
+    _thread.join();
+    _running = false;
+    //Release the memory of the image
+    std::string().swap(_image);
+
+    if (!_error.empty())
+      {
+	std::string error;
+	error.swap(_error);
+	M_throw() << "Failed to write the configuration " << _fileName
+		  << " in the background\n" << error;
+      }
+  }
+
+  void
+  CheckpointWriter::addStall(double seconds)
+  {
+    ++_count;
+    _totalStall += seconds;
+    _maxStall = std::max(_maxStall, seconds);
+    _lastStall = seconds;
+  }
+
+  void
+  CheckpointWriter::run()
+  {
+    namespace io = boost::iostreams;
+    const std::string tmpName = _fileName + ".tmp";
+
+    try {
+      {
+	io::filtering_ostream file;
+	if ((_fileName.size() > 4)
+	    && (std::string(_fileName.end() - 4, _fileName.end()) == ".bz2"))
+	  file.push(magnet::stream::ParallelBzip2Compressor(_pool));
+	file.push(io::file_sink(tmpName, std::ios::out | std::ios::binary));
+
+	file.write(_image.data(), _image.size());
+	file.flush();
+	if (!file)
+	  M_throw() << "Failed while writing " << tmpName;
+      }
+
+      if (std::rename(tmpName.c_str(), _fileName.c_str()))
+	M_throw() << "Could not rename " << tmpName << " to " << _fileName
+		  << ", " << magnet::strerror(errno);
+    }
+    catch (std::exception& err)
+      {
+	_error = err.what();
+	std::remove(tmpName.c_str());
+      }
+  }
+}
@@ -0,0 +1,99 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <magnet/thread/thread.hpp>
+#include <string>
+
+namespace magnet { namespace thread { class WorkStealingPool; } }
+
+namespace dynamo
+{
+  /*! \brief Writes captured configurations to disk on a background
+   * thread.
+   *
+   * The simulation thread captures a configuration into memory (see
+   * SimData::writeXMLfileAsync) and hands the image to write(), which
+   * returns immediately. The image is then compressed (for ".bz2"
+   * files) and written out while the simulation continues. Only one
+   * image is written at a time, a second call to write() waits for
+   * the previous image to be written first.
+   *
+   * Each file is written under a temporary name and renamed once it
+   * is complete, so a crash during a write never leaves a truncated
+   * configuration behind.
+   *
+   * This class also keeps the statistics of the time the simulation
+   * spent stalled by the checkpoints.
+   */
+  class CheckpointWriter
+  {
+  public:
+    /*! \param pool The thread pool used to compress the files, may
+     * be NULL.
+     */
+    CheckpointWriter(magnet::thread::WorkStealingPool* pool);
+
+    //! \brief Waits for the current write to finish.
+    ~CheckpointWriter();
+
+    /*! \brief Write an image to a file in the background.
+     *
+     * \param fileName The path of the file, if it ends in ".bz2" the
+     * image is compressed before it is written.
+     * \param image The contents of the file, this is swapped with an
+     * empty string.
+     * \return The time in seconds spent waiting for the previous
+     * write to complete.
+     */
+    double write(const std::string& fileName, std::string& image);
+
+    /*! \brief Wait for the current write to finish.
+     *
+     * Throws if the write failed.
+     */
+    void wait();
+
+    //! \brief Record the time a checkpoint stalled the simulation.
+    void addStall(double seconds);
+
+    size_t getCount() const { return _count; }
+    double getTotalStall() const { return _totalStall; }
+    double getMaxStall() const { return _maxStall; }
+    double getLastStall() const { return _lastStall; }
+
+  private:
+    CheckpointWriter(const CheckpointWriter&);
+    CheckpointWriter& operator=(const CheckpointWriter&);
+
+    //! \brief The body of the background thread.
+    void run();
+
+    magnet::thread::WorkStealingPool* _pool;
+    magnet::thread::Thread _thread;
+    bool _running;
+    std::string _fileName;
+    std::string _image;
+    std::string _error;
+
+    size_t _count;
+    double _totalStall;
+    double _maxStall;
+    double _lastStall;
+  };
+}
@@ -16,21 +16,44 @@
 */
 
 #include "is_simdata.hpp"
+#include "binaryconfig.hpp"
+#include "checkpoint.hpp"
 #include "../schedulers/scheduler.hpp"
 #include "../dynamics/liouvillean/liouvillean.hpp"
-#include "../schedulers/scheduler.hpp"
+#include "../dynamics/globals/global.hpp"
 #include "../dynamics/systems/system.hpp"
+#include "../dynamics/systems/reorder.hpp"
 #include "../outputplugins/0partproperty/misc.hpp"
 #include <boost/iostreams/device/file.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
-#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <magnet/stream/bzip2.hpp>
 #include <boost/iostreams/chain.hpp>
 #include <boost/filesystem.hpp>
 #include <iomanip>
+#include <sstream>
+#include <cstring>
+#include <time.h>
 
 //! The configuration file version, a version mismatch prevents an XML file load.
 const char configFileVersion[] = "1.4.0";
 
+namespace {
+  double monotonicTime()
+  {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return double(t.tv_sec) + 1e-9 * double(t.tv_nsec);
+  }
+
+  //! The "Exact/Simulation" block of an exact checkpoint.
+  struct ExactSimulation
+  {
+    long double sysTime;
+    double freestreamAcc;
+  };
+}
+
 namespace dynamo
 {
   SimData::SimData():
@@ -52,12 +75,17 @@ namespace dynamo
     lastRunMFT(0.0),
     simID(0),
     replexExchangeNumber(0),
+    threads(NULL),
+    binaryReader(NULL),
+    binaryWriter(NULL),
     status(START)
   {
   }
 
   SimData::~SimData()
   {
+    //Finish any configuration being written in the background
+    checkpointWriter.reset();
     if (ptrScheduler != NULL) delete ptrScheduler;
   }
 
@@ -69,8 +97,44 @@ namespace dynamo
       M_throw() << "Loading config at wrong time, status = " << status;
   
     using namespace magnet::xml;
-    Document doc(fileName.c_str());
-    Node mainNode = doc.getNode("DynamOconfig");
+    boost::scoped_ptr<BinaryConfigReader> binaryFile;
+    boost::scoped_ptr<Document> doc;
+
+    if (binaryconfig::isBinaryFile(fileName))
+      {
+	binaryFile.reset(new BinaryConfigReader(fileName));
+	const size_t block = binaryFile->findBlock("Metadata");
+	doc.reset(new Document(binaryFile->getBlock<char>(block),
+			       binaryFile->getCount(block)));
+      }
+    else
+      doc.reset(new Document(fileName, threads));
+
+    binaryReader = binaryFile.get();
+    try {
+      loadXML(doc->getNode("DynamOconfig"));
+    }
+    catch (...)
+      {
+	binaryReader = NULL;
+	throw;
+      }
+    binaryReader = NULL;
+
+    if (binaryFile && binaryFile->hasBlock("Exact/Simulation"))
+      {
+	//The properties are needed as the Dynamics are initialised,
+	//the remaining state is restored once they are
+	_properties.loadExactState(*binaryFile);
+	restartFile.swap(binaryFile);
+	dout << "Restarting from the exact checkpoint " << fileName << std::endl;
+      }
+  }
+
+  void
+  SimData::loadXML(const magnet::xml::Node& mainNode)
+  {
+    using namespace magnet::xml;
 
     {
       std::string version(mainNode.getAttribute("version"));
@@ -95,6 +159,9 @@ namespace dynamo
     ensemble.reset(dynamo::Ensemble::getClass(subNode.getNode("Ensemble"), this));
 
     _properties << mainNode;
+    if (binaryReader != NULL)
+      _properties.loadParticleBinaryData(*binaryReader);
+
     dynamics << mainNode;
     ptrScheduler 
       = CScheduler::getClass(subNode.getNode("Scheduler"), this);
@@ -119,20 +186,110 @@ namespace dynamo
   void
   SimData::writeXMLfile(std::string fileName, bool applyBC, bool round)
   {
-    if (status < INITIALISED || status == ERROR)
-      M_throw() << "Cannot write out configuration in this state";
-  
-    namespace io = boost::iostreams;
-    io::filtering_ostream coutputFile;
+    restoreParticleOrder();
+
+    if (binaryconfig::isBinaryFile(fileName))
+      {
+	BinaryConfigWriter file(fileName);
+	outputBinary(file, applyBC, round);
+      }
+    else
+      {
+	const std::string state = captureWriteState();
+
+	toConfigUnits();
+
+	{
+	  namespace io = boost::iostreams;
+	  io::filtering_ostream coutputFile;
 
-    if (std::string(fileName.end()-4, fileName.end()) == ".bz2")
-      coutputFile.push(io::bzip2_compressor());
+	  if (std::string(fileName.end()-4, fileName.end()) == ".bz2")
+	    coutputFile.push(magnet::stream::ParallelBzip2Compressor(threads));
   
-    coutputFile.push(io::file_sink(fileName));
+	  coutputFile.push(io::file_sink(fileName));
   
-    magnet::xml::XmlStream XML(coutputFile);
-    XML.setFormatXML(true);
+	  magnet::xml::XmlStream XML(coutputFile);
+	  XML.setFormatXML(true);
+	  outputXML(XML, applyBC, round);
+	}
+
+	toSimulationUnits();
 
+	if (!state.empty())
+	  {
+	    BinaryConfigReader stateReader(state.data(), state.size());
+	    restoreWriteState(stateReader);
+	  }
+      }
+
+    dout << "Config written to " << fileName << std::endl;
+  }
+
+  void
+  SimData::writeXMLfileAsync(std::string fileName, bool applyBC)
+  {
+    const double start = monotonicTime();
+
+    restoreParticleOrder();
+
+    if (!checkpointWriter)
+      checkpointWriter.reset(new CheckpointWriter(threads));
+
+    //Capture the configuration into memory. Binary files are a
+    //straight copy of the particle data and capture maps, the XML is
+    //generated here but compressed in the background.
+    std::string image;
+    if (binaryconfig::isBinaryFile(fileName))
+      {
+	BinaryConfigWriter file;
+	outputBinary(file, applyBC, false);
+	file.swapData(image);
+      }
+    else
+      {
+	const std::string state = captureWriteState();
+
+	toConfigUnits();
+
+	{
+	  namespace io = boost::iostreams;
+	  io::filtering_ostream imageStream;
+	  imageStream.push(io::back_inserter(image));
+	  magnet::xml::XmlStream XML(imageStream);
+	  XML.setFormatXML(true);
+	  outputXML(XML, applyBC, false);
+	}
+
+	toSimulationUnits();
+
+	if (!state.empty())
+	  {
+	    BinaryConfigReader stateReader(state.data(), state.size());
+	    restoreWriteState(stateReader);
+	  }
+      }
+
+    const double waited = checkpointWriter->write(fileName, image);
+    const double stall = monotonicTime() - start;
+    checkpointWriter->addStall(stall);
+
+    dout << "Config captured for " << fileName << " in " << stall
+	 << "s (" << waited << "s waiting for the previous write)" << std::endl;
+  }
+
+  void
+  SimData::waitForCheckpoint()
+  {
+    if (checkpointWriter)
+      checkpointWriter->wait();
+  }
+
+  void
+  SimData::toConfigUnits()
+  {
+    if (status < INITIALISED || status == ERROR)
+      M_throw() << "Cannot write out configuration in this state";
+  
     dynamics.getLiouvillean().updateAllParticles();
 
     //Rescale the properties to the configuration file units
@@ -144,7 +301,156 @@ namespace dynamo
 
     _properties.rescaleUnit(Property::Units::M, 
 			    1.0 / dynamics.units().unitMass());
+  }
 
+  void
+  SimData::toSimulationUnits()
+  {
+    //Rescale the properties back to the simulation units
+    _properties.rescaleUnit(Property::Units::L, 
+			    dynamics.units().unitLength());
+
+    _properties.rescaleUnit(Property::Units::T, 
+			    dynamics.units().unitTime());
+
+    _properties.rescaleUnit(Property::Units::M, 
+			    dynamics.units().unitMass());
+  }
+
+  void
+  SimData::outputBinary(BinaryConfigWriter& file, bool applyBC, bool round)
+  {
+    const std::string state = captureWriteState();
+    boost::scoped_ptr<BinaryConfigReader> stateReader;
+    if (!state.empty())
+      stateReader.reset(new BinaryConfigReader(state.data(), state.size()));
+
+    toConfigUnits();
+
+    //The particle data and capture maps are streamed to the blocks
+    //of the file as the XML is generated. The XML is then written
+    //to the last block.
+    binaryWriter = &file;
+    try {
+      _properties.outputParticleBinaryData(file);
+
+      std::ostringstream metadata;
+      {
+	magnet::xml::XmlStream XML(metadata);
+	XML.setFormatXML(true);
+	outputXML(XML, applyBC, round);
+      }
+
+      //The exact state makes the file a checkpoint
+      if (stateReader)
+	file.copyBlocks(*stateReader);
+
+      const std::string& xml = metadata.str();
+      file.beginBlock("Metadata", sizeof(char));
+      file.write(xml.data(), xml.size());
+      file.endBlock();
+      file.finish();
+    }
+    catch (...)
+      {
+	binaryWriter = NULL;
+	throw;
+      }
+    binaryWriter = NULL;
+
+    toSimulationUnits();
+
+    if (stateReader)
+      restoreWriteState(*stateReader);
+  }
+
+  std::string
+  SimData::captureWriteState() const
+  {
+    std::string state;
+    if ((status < INITIALISED) || (status == ERROR)
+	|| (ptrScheduler == NULL) || !ptrScheduler->hasEvents())
+      return state;
+
+    BinaryConfigWriter file;
+    outputExactState(file);
+    file.finish();
+    file.swapData(state);
+    return state;
+  }
+
+  void
+  SimData::restoreWriteState(const BinaryConfigReader& file)
+  {
+    _properties.loadExactState(file);
+    dynamics.getLiouvillean().loadExactState(file);
+  }
+
+  void
+  SimData::restoreParticleOrder()
+  {
+    BOOST_FOREACH(magnet::ClonePtr<System>& sys, dynamics.getSystemEvents())
+      {
+	SReorder* reorder = dynamic_cast<SReorder*>(sys.get_ptr());
+	if (reorder != NULL) reorder->restoreOriginalOrder();
+      }
+  }
+
+  void
+  SimData::outputExactState(BinaryConfigWriter& file) const
+  {
+    ExactSimulation state;
+    std::memset(&state, 0, sizeof(state));
+    state.sysTime = dSysTime;
+    state.freestreamAcc = freestreamAcc;
+    file.writeValue("Exact/Simulation", state);
+
+    //The random number generators are written in their text form
+    std::ostringstream rng;
+    rng << std::setprecision(std::numeric_limits<double>::digits10 + 2)
+	<< ranGenerator << " " << uniform_sampler << " " 
+	<< normal_sampler.distribution();
+    const std::string& rngState = rng.str();
+    file.writeBlock("Exact/RNG", std::vector<char>(rngState.begin(), rngState.end()));
+
+    _properties.outputExactState(file);
+    dynamics.getLiouvillean().outputExactState(file);
+
+    BOOST_FOREACH(const magnet::ClonePtr<Global>& glob, dynamics.getGlobals())
+      glob->outputExactState(file);
+
+    BOOST_FOREACH(const magnet::ClonePtr<System>& sys, dynamics.getSystemEvents())
+      sys->outputExactState(file);
+
+    ptrScheduler->outputExactState(file);
+  }
+
+  void
+  SimData::loadExactState(const BinaryConfigReader& file)
+  {
+    const ExactSimulation state = file.readValue<ExactSimulation>("Exact/Simulation");
+    dSysTime = state.sysTime;
+    freestreamAcc = state.freestreamAcc;
+
+    std::vector<char> rngState;
+    file.readBlock("Exact/RNG", rngState);
+    std::istringstream rng(std::string(rngState.begin(), rngState.end()));
+    rng >> ranGenerator >> uniform_sampler >> normal_sampler.distribution();
+    if (!rng)
+      M_throw() << "Could not restore the random number generators of the checkpoint";
+
+    dynamics.getLiouvillean().loadExactState(file);
+
+    BOOST_FOREACH(magnet::ClonePtr<Global>& glob, dynamics.getGlobals())
+      glob->loadExactState(file);
+
+    BOOST_FOREACH(magnet::ClonePtr<System>& sys, dynamics.getSystemEvents())
+      sys->loadExactState(file);
+  }
+
+  void
+  SimData::outputXML(magnet::xml::XmlStream& XML, bool applyBC, bool round)
+  {
     XML << std::scientific
       //This has a minus one due to the digit in front of the decimal
       //An extra one is added if we're rounding
@@ -182,18 +488,6 @@ namespace dynamo
     dynamics.getLiouvillean().outputParticleXMLData(XML, applyBC);
 
     XML << magnet::xml::endtag("DynamOconfig");
-
-    dout << "Config written to " << fileName << std::endl;
-
-    //Rescale the properties back to the simulation units
-    _properties.rescaleUnit(Property::Units::L, 
-			    dynamics.units().unitLength());
-
-    _properties.rescaleUnit(Property::Units::T, 
-			    dynamics.units().unitTime());
-
-    _properties.rescaleUnit(Property::Units::M, 
-			    dynamics.units().unitMass());
   }
   
   void 
@@ -40,6 +40,7 @@ class OutputPlugin;
 namespace magnet {
   template <class T>
   class ClonePtr;
+  namespace thread { class WorkStealingPool; }
 }
 
 //! \brief Holds the different phases of the simulation initialisation
@@ -56,6 +57,10 @@ typedef enum
 namespace dynamo
 {  
   typedef boost::mt19937 baseRNG;
+
+  class BinaryConfigReader;
+  class BinaryConfigWriter;
+  class CheckpointWriter;
   
   /*! \brief Fundamental collection of the Simulation data.
    *
@@ -118,21 +123,53 @@ namespace dynamo
 
     //! Loads a Simulation from the passed XML file.
     //! \param filename The path to the XML file to load. The filename must
-    //! end in either ".xml" for uncompressed xml files or ".bz2" for
-    //! bzip2 compressed configuration files.
+    //! end in either ".xml" for uncompressed xml files, ".bz2" for
+    //! bzip2 compressed configuration files or ".dyn" for binary
+    //! configuration files (see binaryconfig).
     void loadXMLfile(std::string filename);
     
     //! Writes the Simulation configuration to a file at the passed path.
     //! \param filename The path to the XML file to write (this file
     //! will either be created or overwritten). The filename must end in
-    //! either ".xml" for uncompressed xml files or ".bz2" for bzip2
-    //! compressed configuration files.
+    //! either ".xml" for uncompressed xml files, ".bz2" for bzip2
+    //! compressed configuration files or ".dyn" for binary
+    //! configuration files. Binary files store the particle data at
+    //! full precision and are much faster to load and write.
     //! \param round If true, the data in the XML file will be written
     //! out at 2 s.f. lower precision to round all the values. This is
     //! used in the test harness to remove rounding error ready for a
     //! comparison to a "correct" configuration file.
+    //!
+    //! Binary files written while the simulation is running are also
+    //! exact checkpoints (see restartFile). Writing a configuration
+    //! does not change the course of the simulation, unless the
+    //! particles have been reordered (see SReorder) and must first be
+    //! put back into their original order.
     void writeXMLfile(std::string filename, bool applyBC = true, bool round = false);
 
+    /*! \brief Writes the Simulation configuration to a file on a
+     * background thread.
+     *
+     * The configuration is captured into memory and the call returns
+     * while the file is (compressed and) written by a
+     * CheckpointWriter, so the simulation can continue. For ".dyn"
+     * files the capture is little more than a copy of the particle
+     * data and capture maps. For XML files the text is generated
+     * here, only the compression and disk writes are done in the
+     * background. The time the simulation was stalled is reported
+     * and accumulated in checkpointWriter.
+     *
+     * \param filename See writeXMLfile.
+     */
+    void writeXMLfileAsync(std::string filename, bool applyBC = true);
+
+    /*! \brief Waits for the configuration being written by
+     * writeXMLfileAsync, if any.
+     *
+     * Throws if the background write failed.
+     */
+    void waitForCheckpoint();
+
     /*! \brief The Ensemble of the Simulation. */
     boost::scoped_ptr<Ensemble> ensemble;
 
@@ -225,6 +262,59 @@ namespace dynamo
      */
     size_t replexExchangeNumber;
 
+    /*! \brief The thread pool of the process, used to parallelise
+     * the initialisation.
+     *
+     * This is set by the Engine and may be NULL, in which case all
+     * work is done by the calling thread.
+     */
+    magnet::thread::WorkStealingPool* threads;
+
+    /*! \brief The binary configuration file being loaded, if any.
+     *
+     * This is only set during loadXMLfile, so that classes loading
+     * large arrays (e.g., the capture maps) can read them from the
+     * blocks of the file.
+     */
+    BinaryConfigReader* binaryReader;
+
+    /*! \brief The binary configuration file being written, if any.
+     *
+     * This is only set during writeXMLfile. Classes writing large
+     * arrays should place them in a block of the file and refer to
+     * the block in their XML.
+     */
+    BinaryConfigWriter* binaryWriter;
+
+    /*! \brief The exact checkpoint the simulation is being restarted
+     * from, if any.
+     *
+     * Binary configuration files written by a running simulation
+     * also hold its exact state in "Exact/..." blocks: the particle
+     * data with the delayed states, the property values in the
+     * simulation units, the cell lists, the random number generator
+     * and the event queue. A simulation loaded from such a file
+     * continues the exact trajectory of the simulation which wrote
+     * it, without rebuilding its event queue. This is set by
+     * loadXMLfile and is released once the simulation is
+     * initialised (see loadExactState and
+     * CScheduler::restoreEventQueue).
+     */
+    boost::scoped_ptr<BinaryConfigReader> restartFile;
+
+    /*! \brief Restore the exact state of restartFile, other than the
+     * property values and the event queue.
+     *
+     * This is called once the Dynamics are initialised.
+     */
+    void loadExactState(const BinaryConfigReader&);
+
+    /*! \brief Writes the configurations from writeXMLfileAsync, and
+     * holds the statistics of the time they stalled the simulation.
+     *
+     * This is NULL until the first call of writeXMLfileAsync.
+     */
+    boost::scoped_ptr<CheckpointWriter> checkpointWriter;
 
     /*! \brief The current phase of the Simulation.
      */
@@ -240,6 +330,43 @@ namespace dynamo
 
     void replexerSwap(SimData&);
   private:
+    //! Loads the Simulation from the root DynamOconfig Node of a configuration.
+    void loadXML(const magnet::xml::Node&);
+
+    //! Writes the XML of the configuration, see writeXMLfile.
+    void outputXML(magnet::xml::XmlStream&, bool applyBC, bool round);
+
+    //! Writes the configuration to a binary file, see writeXMLfile.
+    void outputBinary(BinaryConfigWriter&, bool applyBC, bool round);
+
+    //! Writes the exact state of the simulation, see restartFile.
+    void outputExactState(BinaryConfigWriter&) const;
+
+    /*! \brief Capture the exact state of the simulation, if it is
+     * running, before a configuration is written.
+     *
+     * Writing a configuration brings the particles up to date and
+     * converts the properties to the units of the file and back,
+     * which perturbs the rounding of the simulation. The captured
+     * state is restored by restoreWriteState once the configuration
+     * is written.
+     * \return The exact state as an in memory binary configuration,
+     * or an empty string if the simulation is not running.
+     */
+    std::string captureWriteState() const;
+
+    //! Restores the state captured by captureWriteState.
+    void restoreWriteState(const BinaryConfigReader&);
+
+    //! Renumbers any reordered particles back to the IDs of the
+    //! configuration file before it is written, see SReorder.
+    void restoreParticleOrder();
+
+    //! Brings the particles up to date and rescales the properties to the units of the configuration files.
+    void toConfigUnits();
+
+    //! Rescales the properties back to the simulation units after toConfigUnits.
+    void toSimulationUnits();
     
     mutable std::vector<particleUpdateFunc> _particleUpdateNotify;
   };
@@ -101,9 +101,9 @@ Coordinator::parseOptions(int argc, char *argv[])
   systemopts.add_options()
     ("help", "Produces this message")
     ("n-threads,N", po::value<unsigned int>(),
-     "Number of _threads to spawn for concurrent processing. (Only utilised by certain engine/sim configurations)")
+     "Number of threads to spawn for concurrent processing. (Only utilised by certain engine/sim configurations)")
     ("out-config-file,o", po::value<std::string>(),
-     "Default config output file,(config.%ID.end.xml.bz2)")
+     "Default config output file,(config.%ID.end.xml.bz2). Use the .dyn extension for a binary configuration file")
     ("out-data-file", po::value<std::string>(),
      "Default result output file (output.%ID.xml.bz2)")
     ("config-file", po::value<std::vector<std::string> >(),
@@ -116,7 +116,8 @@ Coordinator::parseOptions(int argc, char *argv[])
      " Values:\n"
      "  1: \tStandard Engine\n"
      "  2: \tNVT Replica Exchange Engine\n"
-     "  3: \tCompression Engine")
+     "  3: \tCompression Engine\n"
+     "  4: \tDomain Decomposition Engine")
     ;
 
   basicOpts.add(systemopts).add(engineopts);
@@ -124,6 +125,7 @@ Coordinator::parseOptions(int argc, char *argv[])
   Engine::getCommonOptions(detailedEngineOpts);
   EReplicaExchangeSimulation::getOptions(detailedEngineOpts);
   ECompressingSimulation::getOptions(detailedEngineOpts);
+  EDomainDecomposition::getOptions(detailedEngineOpts);
   
   allopts.add(basicOpts).add(detailedEngineOpts);
 
@@ -187,8 +189,8 @@ Coordinator::initialise()
       sigaction (SIGUSR2, &new_action, NULL);
   }
 
-  if (vm.count("n-_threads"))
-    _threads.setThreadCount(vm["n-_threads"].as<unsigned int>());
+  if (vm.count("n-threads"))
+    _threads.setThreadCount(vm["n-threads"].as<unsigned int>());
 
   switch (vm["engine"].as<size_t>())
     {
@@ -201,6 +203,9 @@ Coordinator::initialise()
     case (3):
       _engine.set_ptr(new ECompressingSimulation(vm, _threads));
       break;
+    case (4):
+      _engine.set_ptr(new EDomainDecomposition(vm, _threads));
+      break;
     default:
       M_throw() << vm["engine"].as<size_t>()
 		<<", Unknown Engine Number Selected"; 
@@ -24,7 +24,7 @@
 
 #include "engine/engine.hpp"
 #include <boost/program_options.hpp>
-#include <magnet/thread/threadpool.hpp>
+#include <magnet/thread/workstealing.hpp>
 #include <magnet/cloneptr.hpp>
 #include <vector>
 #include <signal.h>
@@ -33,7 +33,7 @@
  *
  * This class is responsible for sorting out the correct simulation Engine to 
  * run and initialising computational node specific objects like the 
- * ThreadPool.
+ * thread pool.
  */
 class Coordinator
 {
@@ -101,15 +101,19 @@ private:
    */
   boost::program_options::variables_map vm;
 
-  /*! \brief A smart pointer to the Engine being run.
-   */
-  magnet::ClonePtr<Engine> _engine;
-
   /*! \brief A thread pool to utilise multiple cores on the computational node.
    *
-   * This ThreadPool is used/referenced by all code in a single dynarun process.
+   * This pool is used/referenced by all code in a single dynarun
+   * process. It is declared before the Engine so that it outlives
+   * it, as the simulations may still be writing configurations in the
+   * background (see SimData::writeXMLfileAsync) when they are
+   * destroyed.
    */
-  magnet::thread::ThreadPool _threads;
+  magnet::thread::WorkStealingPool _threads;
+
+  /*! \brief A smart pointer to the Engine being run.
+   */
+  magnet::ClonePtr<Engine> _engine;
 
   static Coordinator* _signal_handler;
 
@@ -34,7 +34,7 @@ ECompressingSimulation::getOptions(boost::program_options::options_description&
 }
 
 ECompressingSimulation::ECompressingSimulation(const boost::program_options::variables_map& nVM, 
-					       magnet::thread::ThreadPool& tp):
+					       magnet::thread::WorkStealingPool& tp):
   ESingleSimulation(nVM, tp)
 {
   if (vm.count("target-pack-frac") && vm.count("target-density"))
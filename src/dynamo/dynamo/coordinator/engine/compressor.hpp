@@ -38,7 +38,7 @@ public:
    * \param tp The shared thread pool.
    */
   ECompressingSimulation(const boost::program_options::variables_map& vm,
-			 magnet::thread::ThreadPool& tp);
+			 magnet::thread::WorkStealingPool& tp);
 
   /*! \brief A trivial virtual destructor
    */
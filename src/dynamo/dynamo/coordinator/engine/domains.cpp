@@ -0,0 +1,816 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "domains.hpp"
+#include "../../dynamics/globals/gcells.hpp"
+#include "../../dynamics/globals/gcellsmorton.hpp"
+#include "../../dynamics/liouvillean/liouvillean.hpp"
+#include "../../dynamics/interactions/captures.hpp"
+#include "../../dynamics/locals/AndersenWall.hpp"
+#include "../../dynamics/BC/LEBC.hpp"
+#include "../../dynamics/units/units.hpp"
+#include "../../dynamics/NparticleEventData.hpp"
+#include "../../schedulers/neighbourlist.hpp"
+#include "../../outputplugins/0partproperty/misc.hpp"
+#include <magnet/thread/workstealing.hpp>
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <typeinfo>
+#include <limits>
+#include <cmath>
+
+const size_t EDomainDecomposition::NOPARTNER = std::numeric_limits<size_t>::max();
+
+namespace {
+  //! The committed state of a particle, as sent between ranks.
+  struct HaloParticle
+  {
+    size_t ID;
+    double pos[NDIM];
+    double vel[NDIM];
+  };
+
+  void packParticle(Transport::Buffer& buf, const Particle& part)
+  {
+    HaloParticle hp;
+    hp.ID = part.getID();
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      {
+	hp.pos[iDim] = part.getPosition()[iDim];
+	hp.vel[iDim] = part.getVelocity()[iDim];
+      }
+
+    Transport::pack(buf, &hp, 1);
+  }
+
+  void unpackParticles(const Transport::Buffer& buf, Simulation& sim,
+		       std::vector<char>& current)
+  {
+    for (size_t i(0); i < Transport::count<HaloParticle>(buf); ++i)
+      {
+	const HaloParticle hp = Transport::unpack<HaloParticle>(buf, i);
+	Particle& part = sim.particleList.at(hp.ID);
+
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    part.getPosition()[iDim] = hp.pos[iDim];
+	    part.getVelocity()[iDim] = hp.vel[iDim];
+	  }
+
+	part.getPecTime() = 0;
+	current[hp.ID] = true;
+      }
+  }
+}
+
+void
+EDomainDecomposition::getOptions(boost::program_options::options_description& opts)
+{
+  boost::program_options::options_description dopts("Domain Decomposition Engine (--engine=4)");
+
+  dopts.add_options()
+    ("domains", boost::program_options::value<size_t>()->default_value(0),
+     "Number of spatial domains, 0 uses one domain per thread")
+    ("domain-move-limit", boost::program_options::value<size_t>()->default_value(2),
+     "The number of cells a particle may move in a window before the "
+     "window is cut short. Larger values allow longer windows but "
+     "increase the halo of ghost particles.")
+    ("domain-window", boost::program_options::value<double>(),
+     "The initial length of the synchronisation window. Defaults to the "
+     "system MFT or 1 if no MFT is available")
+    ("domain-transport", boost::program_options::value<std::string>(),
+     "Run each domain in a separate process, connected through this "
+     "transport. Every process must be started with the same options "
+     "and --domains set to the number of processes. Only \"unix:<path>\" "
+     "(Unix domain sockets named <path>.<rank>) is available.")
+    ("domain-rank", boost::program_options::value<size_t>()->default_value(0),
+     "The domain run by this process when using --domain-transport. "
+     "Only rank 0 writes the output.")
+    ;
+
+  opts.add(dopts);
+}
+
+EDomainDecomposition::EDomainDecomposition(const boost::program_options::variables_map& nVM,
+					   magnet::thread::WorkStealingPool& tp):
+  Engine(nVM, "config.out.xml.bz2", "output.xml.bz2", tp),
+  masterCells(NULL),
+  firstDomain(0),
+  localDomains(0),
+  nDomains(0),
+  moveLimit(0),
+  ghostCells(0),
+  innerCells(0),
+  xCells(0),
+  serialWindow(false),
+  windowStart(0),
+  windowLength(0),
+  _runUntil(0),
+  timeTolerance(0),
+  haltTime(HUGE_VAL),
+  printInterval(0),
+  windowCount(0),
+  rollbackCount(0),
+  serialCount(0),
+  peekMode(false),
+  stopMode(false)
+{}
+
+void
+EDomainDecomposition::initialisation()
+{
+  preSimInit();
+
+  if (!(vm.count("config-file")) ||
+      (vm["config-file"].as<std::vector<std::string> >().size() != 1))
+    M_throw() << "You must only provide one input file in domain decomposition mode";
+
+  if (vm.count("load-plugin") || vm.count("snapshot")
+      || vm.count("scheduler-maintainance") || vm.count("ticker-period")
+      || vm.count("reorder"))
+    M_throw() << "The domain decomposition engine does not support"
+      " additional plugins, tickers, snapshots, scheduler maintainance"
+      " or particle reordering";
+
+  const std::string filename = vm["config-file"].as<std::vector<std::string> >()[0];
+
+  ////////////////////The master simulation
+  //This only holds the committed state, so it needs no scheduler
+  if (vm.count("random-seed"))
+    master.setRandSeed(vm["random-seed"].as<unsigned int>());
+
+  master.loadXMLfile(filename.c_str());
+  master.setTrajectoryLength(0);
+
+  if (!vm.count("equilibrate")
+      && !(vm.count("domain-transport") && vm["domain-rank"].as<size_t>()))
+    master.addOutputPlugin("Misc");
+
+  if (!master.dynamics.getSystemEvents().empty())
+    M_throw() << "The domain decomposition engine does not support System events";
+
+  if (dynamic_cast<const BCLeesEdwards*>(&master.dynamics.BCs()) != NULL)
+    M_throw() << "The domain decomposition engine does not support Lees-Edwards boundary conditions";
+
+  BOOST_FOREACH(const magnet::ClonePtr<Interaction>& ptr, master.dynamics.getInteractions())
+    if (dynamic_cast<const ICapture*>(ptr.get_ptr()) != NULL)
+      M_throw() << "The domain decomposition engine does not support interactions with capture maps";
+
+  BOOST_FOREACH(const magnet::ClonePtr<Local>& ptr, master.dynamics.getLocals())
+    if (dynamic_cast<const CLAndersenWall*>(ptr.get_ptr()) != NULL)
+      M_throw() << "The domain decomposition engine requires deterministic dynamics,"
+	" Andersen walls are not supported";
+
+  if (dynamic_cast<const CSNeighbourList*>(master.ptrScheduler) == NULL)
+    M_throw() << "The domain decomposition engine requires a neighbour list scheduler";
+
+  {
+    const std::type_info& nblist = typeid(*master.dynamics.getGlobal("SchedulerNBList").get_ptr());
+    if ((nblist != typeid(CGCells)) && (nblist != typeid(CGCellsMorton)))
+      M_throw() << "The domain decomposition engine requires the SchedulerNBList to be a plain cell list";
+  }
+
+  master.initialise();
+
+  if (master.dynamics.getLiouvillean().hasOrientationData())
+    M_throw() << "The domain decomposition engine does not support orientation data";
+
+  masterCells = static_cast<const CGNeighbourList*>
+    (master.dynamics.getGlobal("SchedulerNBList").get_ptr());
+
+  ////////////////////The domain layout
+  nDomains = vm["domains"].as<size_t>();
+  if (!nDomains)
+    nDomains = std::max(threads.getThreadCount(), size_t(1));
+
+  firstDomain = 0;
+  localDomains = nDomains;
+
+  xCells = masterCells->getCellCount()[0];
+  if (size_t(xCells) < nDomains)
+    M_throw() << "Cannot split " << xCells << " cells into " << nDomains << " domains";
+
+  slabStart.resize(nDomains + 1);
+  for (size_t d(0); d <= nDomains; ++d)
+    slabStart[d] = (d * xCells) / nDomains;
+
+  moveLimit = vm["domain-move-limit"].as<size_t>();
+  innerCells = moveLimit + masterCells->getOverlink();
+  ghostCells = 2 * moveLimit + masterCells->getOverlink();
+
+  if (vm.count("halt-time"))
+    haltTime = vm["halt-time"].as<double>() * master.dynamics.units().unitTime();
+
+  if (vm.count("domain-window"))
+    windowLength = vm["domain-window"].as<double>() * master.dynamics.units().unitTime();
+  else if (master.lastRunMFT != 0.0)
+    windowLength = master.lastRunMFT;
+  else
+    windowLength = master.dynamics.units().unitTime();
+
+  //Event times in different domains differ by round off as the
+  //particles are streamed in a different order.
+  timeTolerance = 1e-8 * windowLength;
+
+  printInterval = vm["print-coll"].as<unsigned long long>();
+  windowStart = master.dSysTime;
+
+  std::cout << "\nDomain decomposition using " << nDomains << " domains of "
+	    << xCells / double(nDomains) << " cells, halo of " << ghostCells
+	    << " cells";
+
+  if (vm.count("domain-transport"))
+    {
+      if (nDomains < 2)
+	M_throw() << "--domains must be set to the number of processes when using --domain-transport";
+
+      std::cout << "\nConnecting to the other processes as rank "
+		<< vm["domain-rank"].as<size_t>() << std::flush;
+
+      transport.reset(Transport::getClass(vm["domain-transport"].as<std::string>(),
+					  vm["domain-rank"].as<size_t>(), nDomains));
+      firstDomain = transport->getRank();
+      localDomains = 1;
+    }
+
+  ////////////////////The domain replicas
+  domains.reset(new Simulation[localDomains]);
+  logs.resize(localDomains);
+  domainTrigger.resize(localDomains);
+  domainErrors.resize(localDomains);
+  owner.resize(master.N, 0);
+  startCell.resize(master.N);
+  //Every process starts from the same configuration
+  current.assign(master.N, true);
+
+  for (size_t i(0); i < localDomains; ++i)
+    {
+      Simulation& sim = domains[i];
+      sim.simID = firstDomain + i;
+
+      if (vm.count("random-seed"))
+	sim.setRandSeed(vm["random-seed"].as<unsigned int>());
+
+      sim.loadXMLfile(filename.c_str());
+      sim.setTrajectoryLength(std::numeric_limits<unsigned long long>::max());
+      sim.initialise();
+
+      logs[i].sim = &sim;
+      logs[i].cells = static_cast<CGNeighbourList*>
+	(sim.dynamics.getGlobal("SchedulerNBList").get_ptr());
+
+      sim.registerParticleUpdateFunc
+	(magnet::function::MakeDelegate(&logs[i], &DomainLog::particleUpdate));
+
+      logs[i].cells->ConnectSigCellChangeNotify(&DomainLog::cellChange, &logs[i]);
+    }
+}
+
+void
+EDomainDecomposition::DomainLog::particleUpdate(const NEventData& PDat)
+{
+  const double t = sim->dSysTime;
+
+  BOOST_FOREACH(const ParticleEventData& pdat, PDat.L1partChanges)
+    {
+      EventRecord rec = {t, t, pdat.getParticle().getID(), NOPARTNER, pdat.getType(), -1};
+      records.push_back(rec);
+    }
+
+  BOOST_FOREACH(const PairEventData& pdat, PDat.L2partChanges)
+    {
+      const size_t ID1 = pdat.particle1_.getParticle().getID(),
+	ID2 = pdat.particle2_.getParticle().getID();
+
+      EventRecord rec1 = {t, t, ID1, ID2, pdat.getType(), -1};
+      records.push_back(rec1);
+      EventRecord rec2 = {t, t, ID2, ID1, pdat.getType(), -1};
+      records.push_back(rec2);
+    }
+}
+
+void
+EDomainDecomposition::DomainLog::cellChange(const Particle& part, const size_t&) const
+{
+  //Cell transitions do not stream the system, so the current system
+  //time is only a lower bound on the transition time.
+  EventRecord rec = {double(sim->dSysTime), HUGE_VAL, part.getID(), NOPARTNER,
+		     CELL, cells->getParticleCellCoords(part)[0]};
+  records.push_back(rec);
+}
+
+void
+EDomainDecomposition::DomainLog::sortByID(size_t N, double stopTime)
+{
+  //A cell transition must occur before the system is next streamed,
+  //which is the time of the next velocity record.
+  double nextStream = stopTime;
+  for (size_t i(records.size()); i != 0; --i)
+    if (records[i-1].type == CELL)
+      records[i-1].timeHi = nextStream;
+    else
+      nextStream = records[i-1].time;
+
+  indexByID(N);
+}
+
+void
+EDomainDecomposition::DomainLog::indexByID(size_t N)
+{
+  //A counting sort, which keeps the records of each particle in time
+  //order
+  start.assign(N + 1, 0);
+  BOOST_FOREACH(const EventRecord& rec, records)
+    ++start[rec.ID + 1];
+
+  for (size_t i(0); i < N; ++i)
+    start[i + 1] += start[i];
+
+  std::vector<size_t> pos(start.begin(), start.end() - 1);
+  sorted.resize(records.size());
+  BOOST_FOREACH(const EventRecord& rec, records)
+    sorted[pos[rec.ID]++] = rec;
+}
+
+size_t
+EDomainDecomposition::slabDistance(int xcell, size_t d) const
+{
+  if ((xcell >= slabStart[d]) && (xcell < slabStart[d + 1]))
+    return 0;
+
+  int d1 = std::abs(xcell - slabStart[d]) % xCells,
+    d2 = std::abs(xcell - (slabStart[d + 1] - 1)) % xCells;
+
+  return std::min(std::min(d1, xCells - d1), std::min(d2, xCells - d2));
+}
+
+void
+EDomainDecomposition::assignOwners()
+{
+  for (size_t i(0); i < master.N; ++i)
+    {
+      if (!current[i])
+	{
+	  owner[i] = nDomains;
+	  continue;
+	}
+
+      startCell[i] = masterCells->getCellCoords(master.particleList[i].getPosition())[0];
+
+      owner[i] = 0;
+      if (!serialWindow)
+	while (startCell[i] >= slabStart[owner[i] + 1])
+	  ++owner[i];
+    }
+}
+
+void
+EDomainDecomposition::resyncDomain(size_t d)
+{
+  Simulation& sim = domains[d - firstDomain];
+
+  //Bring every particle up to date and reset the delayed states
+  sim.dynamics.getLiouvillean().updateAllParticles();
+
+  for (size_t i(0); i < sim.N; ++i)
+    {
+      Particle& part = sim.particleList[i];
+      const Particle& mpart = master.particleList[i];
+
+      part.getPosition() = mpart.getPosition();
+      part.getVelocity() = mpart.getVelocity();
+      part.getPecTime() = 0;
+
+      if (current[i] && (serialWindow ? (d == 0)
+			 : (slabDistance(startCell[i], d) <= ghostCells)))
+	part.setState(Particle::ALIVE);
+      else
+	part.clearState(Particle::ALIVE);
+    }
+
+  sim.dSysTime = windowStart;
+  sim.freestreamAcc = 0;
+
+  logs[d - firstDomain].cells->rebuildCellLists();
+  sim.ptrScheduler->rebuildList();
+  logs[d - firstDomain].records.clear();
+}
+
+void
+EDomainDecomposition::runDomain(size_t d)
+{
+  //Exceptions cannot cross the thread pool, so they are passed back
+  //to the main thread
+  try {
+    Simulation& sim = domains[d - firstDomain];
+    while (sim.ptrScheduler->getNextEventTime() < _runUntil)
+      sim.ptrScheduler->runNextEvent();
+  }
+  catch (std::exception& cep)
+    {
+      domainErrors[d - firstDomain] = cep.what();
+    }
+}
+
+void
+EDomainDecomposition::sortDomain(size_t d)
+{ logs[d - firstDomain].sortByID(master.N, _runUntil); }
+
+double
+EDomainDecomposition::zoneEntryTime(const DomainLog& log, size_t ID, size_t d,
+				    double tdiv) const
+{
+  //The particle could be in a cell from the lower bound of the
+  //transition into it to the upper bound of the transition out
+  int cell = startCell[ID];
+  double cellEntry = windowStart;
+
+  for (size_t i(log.start[ID]); i < log.start[ID + 1]; ++i)
+    if (log.sorted[i].type == CELL)
+      {
+	if ((slabDistance(cell, d) <= innerCells) && (log.sorted[i].timeHi >= tdiv))
+	  return std::max(cellEntry, tdiv);
+
+	cell = log.sorted[i].xcell;
+	cellEntry = log.sorted[i].time;
+      }
+
+  if (slabDistance(cell, d) <= innerCells)
+    return std::max(cellEntry, tdiv);
+
+  return HUGE_VAL;
+}
+
+const EDomainDecomposition::DomainLog&
+EDomainDecomposition::ownerLog(size_t ID) const
+{ return transport ? remoteLog : logs[owner[ID] - firstDomain]; }
+
+void
+EDomainDecomposition::analyseDomain(size_t d)
+{
+  double& trigger = domainTrigger[d - firstDomain];
+  trigger = HUGE_VAL;
+
+  if (serialWindow) return;
+
+  const DomainLog& log = logs[d - firstDomain];
+
+  for (size_t ID(0); ID < master.N; ++ID)
+    {
+      if (!domains[d - firstDomain].particleList[ID].testState(Particle::ALIVE)) continue;
+
+      if (owner[ID] == d)
+	{
+	  //Owned particles must stay well inside the halo
+	  for (size_t i(log.start[ID]); i < log.start[ID + 1]; ++i)
+	    if (log.sorted[i].type == CELL)
+	      {
+		int dist = std::abs(log.sorted[i].xcell - startCell[ID]) % xCells;
+		if (size_t(std::min(dist, xCells - dist)) > moveLimit)
+		  {
+		    trigger = std::min(trigger, log.sorted[i].time);
+		    break;
+		  }
+	      }
+	  continue;
+	}
+
+      //Compare the events of the ghost with those of its owner
+      const DomainLog& olog = ownerLog(ID);
+      double tdiv = HUGE_VAL;
+      size_t i(log.start[ID]), j(olog.start[ID]);
+
+      for (;;)
+	{
+	  while ((i < log.start[ID + 1]) && (log.sorted[i].type == CELL)) ++i;
+	  while ((j < olog.start[ID + 1]) && (olog.sorted[j].type == CELL)) ++j;
+
+	  const bool iEnd = (i == log.start[ID + 1]), jEnd = (j == olog.start[ID + 1]);
+	  if (iEnd && jEnd) break;
+
+	  if (iEnd) { tdiv = olog.sorted[j].time; break; }
+	  if (jEnd) { tdiv = log.sorted[i].time; break; }
+
+	  const EventRecord& a = log.sorted[i];
+	  const EventRecord& b = olog.sorted[j];
+	  if ((std::fabs(a.time - b.time) > timeTolerance)
+	      || (a.partner != b.partner) || (a.type != b.type))
+	    {
+	      tdiv = std::min(a.time, b.time);
+	      break;
+	    }
+
+	  ++i; ++j;
+	}
+
+      if (tdiv == HUGE_VAL) continue;
+
+      //The divergence only matters once the ghost could interact
+      //with a particle owned by this domain
+      trigger = std::min(trigger, std::min(zoneEntryTime(log, ID, d, tdiv),
+					   zoneEntryTime(olog, ID, d, tdiv)));
+    }
+}
+
+void
+EDomainDecomposition::forEachDomain(void (EDomainDecomposition::*func)(size_t))
+{
+  std::vector<magnet::function::Task1<void, size_t> > tasks;
+  tasks.reserve(localDomains);
+
+  for (size_t i(0); i < localDomains; ++i)
+    tasks.push_back(magnet::function::Task1<void, size_t>
+		    (magnet::function::MakeDelegate(this, func), firstDomain + i));
+
+  magnet::thread::TaskGroup group(threads);
+  for (size_t i(0); i < localDomains; ++i)
+    group.spawn(tasks[i]);
+
+  group.wait();
+
+  for (size_t i(0); i < localDomains; ++i)
+    if (!domainErrors[i].empty())
+      M_throw() << "\nWhile running domain " << firstDomain + i << domainErrors[i];
+}
+
+void
+EDomainDecomposition::exchangeLogs()
+{
+  const size_t rank = transport->getRank();
+  const DomainLog& log = logs[0];
+  std::vector<Transport::Buffer> send(nDomains), recv;
+
+  for (size_t ID(0); ID < master.N; ++ID)
+    if ((owner[ID] == rank) && (log.start[ID + 1] > log.start[ID]))
+      for (size_t e(0); e < nDomains; ++e)
+	if ((e != rank) && (slabDistance(startCell[ID], e) <= ghostCells))
+	  Transport::pack(send[e], &log.sorted[log.start[ID]],
+			  log.start[ID + 1] - log.start[ID]);
+
+  transport->exchange(send, recv);
+
+  //The records of each particle come from a single rank and are
+  //already in time order
+  remoteLog.records.clear();
+  for (size_t e(0); e < nDomains; ++e)
+    if (e != rank)
+      for (size_t i(0); i < Transport::count<EventRecord>(recv[e]); ++i)
+	remoteLog.records.push_back(Transport::unpack<EventRecord>(recv[e], i));
+
+  remoteLog.indexByID(master.N);
+}
+
+void
+EDomainDecomposition::exchangeHalo()
+{
+  const size_t rank = transport->getRank();
+  std::vector<Transport::Buffer> send(nDomains), recv;
+
+  for (size_t i(0); i < master.N; ++i)
+    if (owner[i] == rank)
+      {
+	const Particle& part = master.particleList[i];
+	const int cell = masterCells->getCellCoords(part.getPosition())[0];
+
+	for (size_t e(0); e < nDomains; ++e)
+	  if ((e != rank) && (slabDistance(cell, e) <= ghostCells))
+	    packParticle(send[e], part);
+      }
+
+  transport->exchange(send, recv);
+
+  //Only the particles this rank committed or received are up to date
+  for (size_t i(0); i < master.N; ++i)
+    current[i] = (owner[i] == rank);
+
+  for (size_t e(0); e < nDomains; ++e)
+    if (e != rank)
+      unpackParticles(recv[e], master, current);
+}
+
+void
+EDomainDecomposition::gatherToRoot()
+{
+  const size_t rank = transport->getRank();
+  std::vector<Transport::Buffer> send(nDomains), recv;
+
+  //Each particle is current on the rank which owned it last
+  if (rank)
+    for (size_t i(0); i < master.N; ++i)
+      if (owner[i] == rank)
+	packParticle(send[0], master.particleList[i]);
+
+  transport->exchange(send, recv);
+
+  if (!rank)
+    {
+      for (size_t e(1); e < nDomains; ++e)
+	unpackParticles(recv[e], master, current);
+
+      current.assign(master.N, true);
+    }
+}
+
+void
+EDomainDecomposition::runWindow()
+{
+  assignOwners();
+
+  const double windowEnd = std::min(windowStart + windowLength, haltTime);
+
+  _runUntil = windowEnd;
+  forEachDomain(&EDomainDecomposition::resyncDomain);
+  forEachDomain(&EDomainDecomposition::runDomain);
+  forEachDomain(&EDomainDecomposition::sortDomain);
+
+  if (transport && !serialWindow)
+    exchangeLogs();
+
+  forEachDomain(&EDomainDecomposition::analyseDomain);
+
+  double commitTime = windowEnd;
+  BOOST_FOREACH(const double& trigger, domainTrigger)
+    commitTime = std::min(commitTime, trigger);
+
+  if (transport)
+    commitTime = transport->allReduceMin(commitTime);
+
+  ++windowCount;
+
+  if (commitTime <= windowStart)
+    {
+      //No progress can be made, run the next window on a single
+      //domain
+      ++rollbackCount;
+      serialWindow = true;
+      if (transport) gatherToRoot();
+      return;
+    }
+
+  if (commitTime < windowEnd)
+    {
+      //Roll back and replay to the commit time
+      ++rollbackCount;
+      _runUntil = commitTime;
+      forEachDomain(&EDomainDecomposition::resyncDomain);
+      forEachDomain(&EDomainDecomposition::runDomain);
+      windowLength = 0.8 * (commitTime - windowStart);
+    }
+  else if (!serialWindow && (windowEnd < haltTime))
+    windowLength *= 1.5;
+
+  //Harvest the owned particles and the event counts
+  unsigned long dualEvents(0), singleEvents(0);
+  for (size_t d(firstDomain); d < firstDomain + localDomains; ++d)
+    {
+      Simulation& sim = domains[d - firstDomain];
+
+      const double dt = commitTime - sim.dSysTime;
+      sim.dSysTime += dt;
+      sim.dynamics.stream(dt);
+      sim.dynamics.getLiouvillean().updateAllParticles();
+
+      for (size_t i(0); i < sim.N; ++i)
+	if (owner[i] == d)
+	  {
+	    Particle& mpart = master.particleList[i];
+	    mpart.getPosition() = sim.particleList[i].getPosition();
+	    mpart.getVelocity() = sim.particleList[i].getVelocity();
+	    mpart.getPecTime() = 0;
+	  }
+
+      //Pair events are counted by the owner of the lowest ID
+      BOOST_FOREACH(const EventRecord& rec, logs[d - firstDomain].records)
+	if ((rec.type != CELL) && (owner[rec.ID] == d))
+	  {
+	    if (rec.partner == NOPARTNER)
+	      ++singleEvents;
+	    else if (rec.ID < rec.partner)
+	      ++dualEvents;
+	  }
+    }
+
+  if (transport)
+    {
+      dualEvents = transport->allReduceSum(dualEvents);
+      singleEvents = transport->allReduceSum(singleEvents);
+      exchangeHalo();
+    }
+
+  master.dSysTime = commitTime;
+  master.eventCount += dualEvents + singleEvents;
+
+  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, master.outputPlugins)
+    if (dynamic_cast<OPMisc*>(Ptr.get_ptr()) != NULL)
+      static_cast<OPMisc&>(*Ptr).addEventCounts(dualEvents, singleEvents);
+
+  if (serialWindow) ++serialCount;
+  serialWindow = false;
+  windowStart = commitTime;
+}
+
+void
+EDomainDecomposition::runSimulation()
+{
+  try {
+    unsigned long long nextPrint = master.eventCount + printInterval;
+    const unsigned long long endEventCount = vm["ncoll"].as<unsigned long long>();
+
+    for (;;)
+      {
+	bool stop = stopMode, peek = peekMode;
+	if (transport)
+	  {
+	    //All ranks must run the same windows
+	    stop = transport->allReduceOr(stop);
+	    peek = transport->allReduceOr(peek);
+	  }
+
+	if (stop || (master.eventCount >= endEventCount) || (windowStart >= haltTime))
+	  break;
+
+	if (peek)
+	  {
+	    if (transport) gatherToRoot();
+	    if (isRoot()) master.outputData("peek.data.xml.bz2");
+	    peekMode = false;
+	  }
+
+	runWindow();
+
+	if ((master.eventCount > nextPrint) && master.outputPlugins.size())
+	  {
+	    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, master.outputPlugins)
+	      Ptr->periodicOutput();
+
+	    nextPrint = master.eventCount + printInterval;
+	    std::cout << std::endl;
+	  }
+      }
+  }
+  catch (std::exception& cep)
+    {
+      //The other ranks hold part of the state and may have failed
+      if (transport) throw;
+
+      try {
+	std::cerr << "\nEngine: Trying to output config to config.error.xml.bz2";
+	master.writeXMLfile("config.error.xml.bz2", !vm.count("unwrapped"));
+      } catch (...)
+	{
+	  std::cerr << "\nEngine: Could not output error config";
+	}
+      throw;
+    }
+}
+
+void
+EDomainDecomposition::printStatus()
+{
+  std::cout << "Domain decomposition, " << nDomains << " domains, "
+	    << windowCount << " windows, " << rollbackCount << " rollbacks, "
+	    << serialCount << " serial windows, window length "
+	    << windowLength / master.dynamics.units().unitTime()
+	    << std::endl;
+}
+
+void
+EDomainDecomposition::forceShutdown()
+{ stopMode = true; }
+
+void
+EDomainDecomposition::peekData()
+{ peekMode = true; }
+
+void
+EDomainDecomposition::outputData()
+{
+  if (transport) gatherToRoot();
+  if (!isRoot()) return;
+
+  printStatus();
+  master.outputData(outputFormat.c_str());
+}
+
+void
+EDomainDecomposition::outputConfigs()
+{
+  if (transport) gatherToRoot();
+  if (!isRoot()) return;
+
+  master.writeXMLfile(configFormat.c_str(), !vm.count("unwrapped"));
+}
@@ -0,0 +1,282 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file domains.hpp
+ * Contains the definition of EDomainDecomposition.
+ */
+#pragma once
+
+#include "engine.hpp"
+#include "../../simulation/simulation.hpp"
+#include "../../dynamics/eventtypes.hpp"
+#include "../transport.hpp"
+#include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <vector>
+#include <string>
+
+class CGNeighbourList;
+class NEventData;
+
+/*! \brief An Engine which runs a single system split into spatial
+ * domains, one per thread, using optimistic synchronisation.
+ *
+ * The primary image is cut into slabs of cells along the x axis and
+ * each slab is owned by a domain. Every domain is a full Simulation
+ * replica, but only the particles in its slab plus a halo of ghost
+ * cells are marked Particle::ALIVE and take part in its event loop.
+ *
+ * The domains are advanced together in time windows. At the end of a
+ * window the event logs of the domains are compared. A window is
+ * committed up to the earliest time at which a domain could have
+ * gone wrong, which is either
+ *
+ * - an owned particle moving more than domain-move-limit cells from
+ *   where it started the window (it could then meet particles outside
+ *   the halo), or
+ *
+ * - a ghost particle whose events differ from those recorded by its
+ *   owner while it is (or could be) close enough to the slab to
+ *   interact with an owned particle.
+ *
+ * If the window is not committed in full, all domains are rolled back
+ * to the start of the window and replayed to the commit time. The
+ * window length adapts to the rollback rate. The committed state is
+ * kept in a master Simulation which is used for the output.
+ *
+ * With --domain-transport each domain is run in its own process
+ * (rank), and the logs of the owned particles near a domain and the
+ * particles which end a window in its halo are sent to it through the
+ * Transport. Every rank still holds a replica of the whole system, as
+ * the particles are indexed by ID throughout the Simulation, but only
+ * the particles in its halo are kept up to date.
+ *
+ * The dynamics must be deterministic, thus only systems without
+ * System events, capture maps, Andersen walls, orientation data or
+ * Lees-Edwards boundary conditions are supported. The neighbour list
+ * must be a plain CGCells or CGCellsMorton and only the Misc plugin
+ * is collected.
+ */
+class EDomainDecomposition: public Engine
+{
+public:
+  /*! \brief The only constructor.
+   *
+   * \param vm The parsed command line options held by the Coordinator.
+   * \param tp The WorkStealingPool the domains are run on.
+   */
+  EDomainDecomposition(const boost::program_options::variables_map& vm,
+		       magnet::thread::WorkStealingPool& tp);
+
+  /*! \brief A trivial virtual destructor.
+   */
+  virtual ~EDomainDecomposition() {}
+
+  /*! \brief Print the number of windows and rollbacks performed.
+   */
+  virtual void printStatus();
+
+  /*! \brief Advance the domains window by window until the event
+   * count or halt time is reached.
+   */
+  virtual void runSimulation();
+
+  /*! \brief Load the master and domain Simulation's.
+   */
+  virtual void initialisation();
+
+  /*! \brief Stop at the end of the current window.
+   */
+  virtual void forceShutdown();
+
+  /*! \brief Output the data of the master Simulation at the end of
+   * the current window.
+   */
+  virtual void peekData();
+
+  /*! \brief No finalisation is required in this engine.
+   */
+  virtual void finaliseRun() {}
+
+  /*! \brief Return the options for the EDomainDecomposition Engine.
+   */
+  static void getOptions(boost::program_options::options_description&);
+
+  /*! \brief Output the data collected by the master Simulation.
+   */
+  virtual void outputData();
+
+  /*! \brief Output the configuration of the master Simulation.
+   */
+  virtual void outputConfigs();
+
+protected:
+  /*! \brief An entry in the event log of a domain.
+   *
+   * Velocity records are taken from the particle update signal and
+   * have an exact time. Cell records are taken from the neighbour
+   * list and are only known to occur in [time, timeHi].
+   */
+  struct EventRecord
+  {
+    double time;
+    double timeHi;
+    size_t ID;
+    size_t partner;
+    EEventType type;
+    int xcell;
+  };
+
+  /*! \brief The event log and callbacks of a single domain.
+   */
+  struct DomainLog
+  {
+    DomainLog(): sim(NULL), cells(NULL) {}
+
+    void particleUpdate(const NEventData&);
+
+    void cellChange(const Particle&, const size_t&) const;
+
+    //! Bounds the cell transitions and sorts the records by particle ID.
+    void sortByID(size_t N, double stopTime);
+
+    //! Sorts the records by particle ID, keeping the time order.
+    void indexByID(size_t N);
+
+    Simulation* sim;
+    CGNeighbourList* cells;
+
+    mutable std::vector<EventRecord> records;
+    std::vector<EventRecord> sorted;
+    //! The records of particle i are sorted[start[i]..start[i+1]).
+    std::vector<size_t> start;
+  };
+
+  static const size_t NOPARTNER;
+
+  /*! \brief Copy the master state into the domain and rebuild its
+   * neighbour list and scheduler.
+   */
+  void resyncDomain(size_t d);
+
+  /*! \brief Run the events of a domain up to _runUntil.
+   */
+  void runDomain(size_t d);
+
+  /*! \brief Sort the event log of a domain by particle ID.
+   */
+  void sortDomain(size_t d);
+
+  /*! \brief Find the earliest time at which a domain could have
+   * diverged from the true trajectory.
+   */
+  void analyseDomain(size_t d);
+
+  //! \brief The log holding the records of the owner of a ghost particle.
+  const DomainLog& ownerLog(size_t ID) const;
+
+  /*! \brief Send the logs of the owned particles to the ranks which
+   * hold them as ghosts.
+   */
+  void exchangeLogs();
+
+  /*! \brief Send the committed state of the owned particles to the
+   * ranks which have them in their halo for the next window.
+   */
+  void exchangeHalo();
+
+  /*! \brief Bring the master Simulation of rank 0 fully up to date.
+   */
+  void gatherToRoot();
+
+  //! \brief If this process writes the output.
+  bool isRoot() const { return !transport || !transport->getRank(); }
+
+  /*! \brief Apply a member function to every domain in parallel. */
+  void forEachDomain(void (EDomainDecomposition::*)(size_t));
+
+  /*! \brief Run a single window and commit as much of it as is
+   * safe.
+   */
+  void runWindow();
+
+  /*! \brief Assign the particles to domains using their position
+   * at the start of the window.
+   */
+  void assignOwners();
+
+  //! \brief The periodic distance in cells between an x cell and the slab of domain d.
+  size_t slabDistance(int xcell, size_t d) const;
+
+  //! \brief The earliest time >= tdiv that a particle could be within range of the slab.
+  double zoneEntryTime(const DomainLog&, size_t ID, size_t d, double tdiv) const;
+
+  //! \brief The holder of the committed state.
+  Simulation master;
+
+  //! \brief The neighbour list of the master, used to locate particles.
+  const CGNeighbourList* masterCells;
+
+  //! \brief The domain replicas run by this process.
+  boost::scoped_array<Simulation> domains;
+
+  //! \brief The logs of the local domains, indexed from firstDomain.
+  std::vector<DomainLog> logs;
+
+  //! \brief The connection to the other ranks, if domains are run in separate processes.
+  boost::scoped_ptr<Transport> transport;
+  size_t firstDomain;
+  size_t localDomains;
+
+  //! \brief The logs of the ghost particles received from other ranks.
+  DomainLog remoteLog;
+
+  //! \brief If the master holds the committed state of each particle.
+  std::vector<char> current;
+
+  size_t nDomains;
+  size_t moveLimit;
+  size_t ghostCells;
+  size_t innerCells;
+  int xCells;
+
+  //! \brief The first x cell of each domain's slab, plus the end of the last slab.
+  std::vector<int> slabStart;
+  //! \brief The domain which owns each particle this window (nDomains if unknown).
+  std::vector<size_t> owner;
+  //! \brief The x cell of each particle at the start of this window.
+  std::vector<int> startCell;
+
+  //! \brief In a serial window domain 0 owns and sees every particle.
+  bool serialWindow;
+
+  double windowStart;
+  double windowLength;
+  double _runUntil;
+  double timeTolerance;
+  double haltTime;
+  unsigned long long printInterval;
+
+  std::vector<double> domainTrigger;
+  std::vector<std::string> domainErrors;
+
+  size_t windowCount;
+  size_t rollbackCount;
+  size_t serialCount;
+
+  bool peekMode;
+  volatile bool stopMode;
+};
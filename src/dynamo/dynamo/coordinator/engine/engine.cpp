@@ -23,6 +23,7 @@
 #include "../../outputplugins/0partproperty/misc.hpp"
 #include "../../outputplugins/general/reverseEvents.hpp"
 #include "../../dynamics/systems/snapshot.hpp"
+#include "../../dynamics/systems/reorder.hpp"
 
 #ifdef DYNAMO_visualizer
 #include "../../dynamics/systems/visualizer.hpp"
@@ -54,9 +55,21 @@ Engine::getCommonOptions(boost::program_options::options_description& opts)
     ("scheduler-maintainance,m", boost::program_options::value<double>(),
      "Rebuild the scheduler periodically, for systems where we've not built "
      "the scheduler correctly")
+    ("reorder", boost::program_options::value<double>(),
+     "Renumber the particles periodically along the Morton curve of the "
+     "neighbour list cells, so particles close in space are close in memory. "
+     "Sets the system time inbetween reorderings, the output files keep the "
+     "original numbering.")
     ("unwrapped", "Don't apply the boundary conditions of the system when writing out the particle positions.")
     ("snapshot", boost::program_options::value<double>(),
      "Sets the system time inbetween saving snapshots of the system.")
+    ("snapshot-file", boost::program_options::value<std::string>()
+     ->default_value("Snapshot.%i.xml.bz2"),
+     "The file name of the snapshots, %i is replaced by the snapshot number. "
+     "Snapshots are written in the background, binary (.dyn) snapshots "
+     "pause the simulation for the shortest time.")
+    ("snapshot-sync", "Write the snapshots on the simulation thread, "
+     "pausing the simulation until each snapshot is written.")
     ;
   
   opts.add(simopts);
@@ -65,7 +78,7 @@ Engine::getCommonOptions(boost::program_options::options_description& opts)
 
 Engine::Engine(const boost::program_options::variables_map& nvm, 
 	       std::string configFile, std::string outputFile,
-	       magnet::thread::ThreadPool& tp):
+	       magnet::thread::WorkStealingPool& tp):
   vm(nvm),
   configFormat(configFile),
   outputFormat(outputFile),
@@ -88,6 +101,8 @@ Engine::setupSim(Simulation& Sim, const std::string filename)
 {
   if (vm.count("random-seed"))
     Sim.setRandSeed(vm["random-seed"].as<unsigned int>());
+
+  Sim.threads = &threads;
   
   ////////////////////////Simulation Initialisation!!!!!!!!!!!!!
   //Now load the config
@@ -106,13 +121,18 @@ Engine::setupSim(Simulation& Sim, const std::string filename)
   if (vm.count("scheduler-maintainance"))
     Sim.addSystem(new CSSchedMaintainer(&Sim, vm["scheduler-maintainance"].as<double>(), "SchedulerRebuilder"));
 
+  if (vm.count("reorder"))
+    Sim.addSystem(new SReorder(&Sim, vm["reorder"].as<double>(), "ParticleReorder"));
+
 #ifdef DYNAMO_visualizer
   if (vm.count("visualizer"))
     Sim.addSystem(new SVisualizer(&Sim, filename, vm["visualizer"].as<double>()));
 #endif  
 
   if (vm.count("snapshot"))
-    Sim.addSystem(new SSnapshot(&Sim, vm["snapshot"].as<double>(), "SnapshotEvent"));
+    Sim.addSystem(new SSnapshot(&Sim, vm["snapshot"].as<double>(), "SnapshotEvent",
+				vm["snapshot-file"].as<std::string>(),
+				!vm.count("snapshot-sync")));
 
   if (vm.count("load-plugin"))
     {
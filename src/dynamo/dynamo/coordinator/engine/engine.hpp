@@ -24,7 +24,7 @@
 #include <boost/scoped_array.hpp>
 #include "../../simulation/simulation.hpp"
 
-namespace magnet { namespace thread { class ThreadPool; } }
+namespace magnet { namespace thread { class WorkStealingPool; } }
 
 /*! \brief An engine to control/manipulate one or more Simulation's.
  *
@@ -51,11 +51,11 @@ public:
    * \param vm Reference to the parsed command line variables.
    * \param configFile A format string on how config files should be written out.
    * \param outputFile A format string on how output files should be written out.
-   * \param tp The processes ThreadPool for parallel processing.
+   * \param tp The processes WorkStealingPool for parallel processing.
    */
   Engine(const boost::program_options::variables_map& vm,
 	 std::string configFile, std::string outputFile,
-	 magnet::thread::ThreadPool& tp);
+	 magnet::thread::WorkStealingPool& tp);
   
   /*! \brief The trivial virtual destructor. */
   virtual ~Engine() {}
@@ -152,5 +152,5 @@ protected:
   std::string configFormat;
   std::string outputFormat;
 
-  magnet::thread::ThreadPool& threads;
+  magnet::thread::WorkStealingPool& threads;
 };
@@ -18,3 +18,4 @@
 #include "replexer.hpp"
 #include "single.hpp"
 #include "compressor.hpp"
+#include "domains.hpp"
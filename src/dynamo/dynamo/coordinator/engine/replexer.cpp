@@ -21,7 +21,7 @@
 #include "../../dynamics/liouvillean/liouvillean.hpp"
 #include "../../schedulers/scheduler.hpp"
 #include "../../outputplugins/1partproperty/uenergy.hpp"
-#include <magnet/thread/threadpool.hpp>
+#include <magnet/thread/workstealing.hpp>
 #include <magnet/string/searchreplace.hpp>
 #include <boost/random/uniform_int.hpp>
 #include <fstream>
@@ -57,7 +57,7 @@ EReplicaExchangeSimulation::getOptions(boost::program_options::options_descripti
 }
 
 EReplicaExchangeSimulation::EReplicaExchangeSimulation(const boost::program_options::variables_map& nVm,
-						       magnet::thread::ThreadPool& tp):
+						       magnet::thread::WorkStealingPool& tp):
   Engine(nVm, "config.%ID.end.xml.bz2", "output.%ID.xml.bz2", tp),
   replicaEndTime(0),
   ReplexMode(RandomSelection),
@@ -204,6 +204,11 @@ EReplicaExchangeSimulation::preSimInit()
   nSims = vm["config-file"].as<std::vector<std::string> >().size();
   
   replicaEndTime = vm["sim-end-time"].as<double>();
+
+  //The System events are exchanged with the temperatures, but the
+  //particle order belongs to the configuration
+  if (vm.count("reorder"))
+    M_throw() << "Particle reordering is not supported in replica exchange";
   
   if (nSims < 2 && vm.count("replex"))
     {
@@ -482,16 +487,21 @@ void EReplicaExchangeSimulation::runSimulation()
 	}
       else 
 	{
-	  //Run the simulations. We also generate all tasks at once
-	  //and submit them all at once to minimise lock contention.
-	  std::vector<magnet::function::Task*> tasks(nSims, NULL);
+	  //Run the simulations. The tasks are spawned into a fork-join
+	  //group so no task is heap allocated.
+	  std::vector<magnet::function::Task1<void, bool> > tasks;
+	  tasks.reserve(nSims);
 	  
 	  for (size_t i(0); i < nSims; ++i)
-	    tasks[i] = magnet::function::Task::makeTask(&Simulation::runSimulation, 
-							&(Simulations[i]), true);
+	    tasks.push_back(magnet::function::Task1<void, bool>
+			    (magnet::function::MakeDelegate(&(Simulations[i]), &Simulation::runSimulation), 
+			     true));
+
+	  magnet::thread::TaskGroup group(threads);
+	  for (size_t i(0); i < nSims; ++i)
+	    group.spawn(tasks[i]);
 
-	  threads.queueTasks(tasks);
-	  threads.wait();//This syncs the systems for the replica exchange
+	  group.wait();//This syncs the systems for the replica exchange
 		  
 	  //Swap calculation
 	  ReplexSwap(ReplexMode);
@@ -18,7 +18,7 @@
 #include "single.hpp"
 
 ESingleSimulation::ESingleSimulation(const boost::program_options::variables_map& nVM, 
-				     magnet::thread::ThreadPool& tp):
+				     magnet::thread::WorkStealingPool& tp):
   Engine(nVM, "config.out.xml.bz2", "output.xml.bz2", tp),
   peekMode(false)
 {}
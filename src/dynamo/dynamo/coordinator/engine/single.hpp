@@ -34,7 +34,7 @@ public:
    * \param tp A reference to the thread pool of the dynarun instance.
    */ 
   ESingleSimulation(const boost::program_options::variables_map& vm, 
-		    magnet::thread::ThreadPool& tp);
+		    magnet::thread::WorkStealingPool& tp);
 
   /*! \brief Trivial virtual destructor */
   virtual ~ESingleSimulation() {}
@@ -0,0 +1,336 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "transport.hpp"
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+
+double
+Transport::allReduceMin(double val)
+{
+  std::vector<double> vals = allGather(val);
+  return *std::min_element(vals.begin(), vals.end());
+}
+
+unsigned long long
+Transport::allReduceSum(unsigned long long val)
+{
+  std::vector<unsigned long long> vals = allGather(val);
+  unsigned long long sum(0);
+  for (size_t r(0); r < vals.size(); ++r)
+    sum += vals[r];
+  return sum;
+}
+
+bool
+Transport::allReduceOr(bool val)
+{
+  std::vector<char> vals = allGather(char(val));
+  return std::find(vals.begin(), vals.end(), char(true)) != vals.end();
+}
+
+Transport*
+Transport::getClass(const std::string& spec, size_t rank, size_t ranks)
+{
+  if (rank >= ranks)
+    M_throw() << "Rank " << rank << " is out of range for " << ranks << " ranks";
+
+  const size_t colon = spec.find(':');
+  const std::string type = spec.substr(0, colon);
+
+  if ((type == "unix") && (colon != std::string::npos))
+    return new UnixSocketTransport(spec.substr(colon + 1), rank, ranks);
+
+  M_throw() << "Unknown transport \"" << spec << "\", the available transports are:"
+	    << "\n unix:<path>";
+}
+
+namespace {
+  void writeAll(int fd, const char* data, size_t len)
+  {
+    while (len)
+      {
+	ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+	if (n < 0)
+	  {
+	    if (errno == EINTR) continue;
+	    M_throw() << "Failed to write to a socket, " << std::strerror(errno);
+	  }
+	data += n;
+	len -= n;
+      }
+  }
+
+  void readAll(int fd, char* data, size_t len)
+  {
+    while (len)
+      {
+	ssize_t n = ::read(fd, data, len);
+	if (n < 0)
+	  {
+	    if (errno == EINTR) continue;
+	    M_throw() << "Failed to read from a socket, " << std::strerror(errno);
+	  }
+
+	if (n == 0)
+	  M_throw() << "A socket was closed during the handshake";
+
+	data += n;
+	len -= n;
+      }
+  }
+
+  sockaddr_un socketAddress(const std::string& name)
+  {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    if (name.size() >= sizeof(addr.sun_path))
+      M_throw() << "The socket path " << name << " is too long";
+
+    std::strcpy(addr.sun_path, name.c_str());
+    return addr;
+  }
+}
+
+UnixSocketTransport::UnixSocketTransport(const std::string& path, size_t rank,
+					 size_t ranks, double timeout):
+  Transport(rank, ranks),
+  _path(path),
+  _listener(-1),
+  _sockets(ranks, -1)
+{
+  //Listen first, so the higher ranks can queue their connections
+  //while we connect to the lower ranks
+  {
+    const std::string name = socketName(_rank);
+    sockaddr_un addr = socketAddress(name);
+
+    _listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_listener < 0)
+      M_throw() << "Failed to create a socket, " << std::strerror(errno);
+
+    ::unlink(name.c_str());
+    if (::bind(_listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr))
+	|| ::listen(_listener, _ranks))
+      M_throw() << "Failed to listen on " << name << ", " << std::strerror(errno);
+  }
+
+  for (size_t r(0); r < _rank; ++r)
+    {
+      sockaddr_un addr = socketAddress(socketName(r));
+
+      //The other rank may not have started yet
+      for (double waited(0);; waited += 0.01)
+	{
+	  _sockets[r] = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	  if (_sockets[r] < 0)
+	    M_throw() << "Failed to create a socket, " << std::strerror(errno);
+
+	  if (!::connect(_sockets[r], reinterpret_cast<sockaddr*>(&addr), sizeof(addr)))
+	    break;
+
+	  ::close(_sockets[r]);
+	  _sockets[r] = -1;
+
+	  if (waited > timeout)
+	    M_throw() << "Timed out connecting to rank " << r << " on " << socketName(r);
+
+	  timespec delay = {0, 10000000};
+	  ::nanosleep(&delay, NULL);
+	}
+
+      const uint64_t myRank = _rank;
+      writeAll(_sockets[r], reinterpret_cast<const char*>(&myRank), sizeof(myRank));
+    }
+
+  for (size_t i(_rank + 1); i < _ranks; ++i)
+    {
+      int fd;
+      do fd = ::accept(_listener, NULL, NULL);
+      while ((fd < 0) && (errno == EINTR));
+
+      if (fd < 0)
+	M_throw() << "Failed to accept a connection, " << std::strerror(errno);
+
+      uint64_t peer;
+      readAll(fd, reinterpret_cast<char*>(&peer), sizeof(peer));
+
+      if ((peer <= _rank) || (peer >= _ranks) || (_sockets[peer] != -1))
+	M_throw() << "Received a connection from an unexpected rank " << peer;
+
+      _sockets[peer] = fd;
+    }
+
+  //Everyone is connected, the socket file is no longer needed
+  ::close(_listener);
+  _listener = -1;
+  ::unlink(socketName(_rank).c_str());
+
+  for (size_t r(0); r < _ranks; ++r)
+    if (r != _rank)
+      ::fcntl(_sockets[r], F_SETFL, ::fcntl(_sockets[r], F_GETFL) | O_NONBLOCK);
+}
+
+UnixSocketTransport::~UnixSocketTransport()
+{
+  if (_listener >= 0)
+    {
+      ::close(_listener);
+      ::unlink(socketName(_rank).c_str());
+    }
+
+  for (size_t r(0); r < _ranks; ++r)
+    if (_sockets[r] >= 0)
+      ::close(_sockets[r]);
+}
+
+std::string
+UnixSocketTransport::socketName(size_t rank) const
+{ return _path + "." + boost::lexical_cast<std::string>(rank); }
+
+void
+UnixSocketTransport::exchange(const std::vector<Buffer>& send,
+			      std::vector<Buffer>& recv)
+{
+  if (send.size() != _ranks)
+    M_throw() << "Need one message per rank";
+
+  recv.clear();
+  recv.resize(_ranks);
+  recv[_rank] = send[_rank];
+
+  //Each message is preceded by its length. The progress counters
+  //include the length header.
+  const size_t header = sizeof(uint64_t);
+  std::vector<uint64_t> sendLength(_ranks), recvLength(_ranks, 0);
+  std::vector<size_t> sent(_ranks, 0), received(_ranks, 0);
+
+  for (size_t r(0); r < _ranks; ++r)
+    sendLength[r] = send[r].size();
+
+  std::vector<pollfd> fds;
+  std::vector<size_t> fdRank;
+
+  for (;;)
+    {
+      fds.clear();
+      fdRank.clear();
+
+      for (size_t r(0); r < _ranks; ++r)
+	{
+	  if (r == _rank) continue;
+
+	  pollfd pfd = {_sockets[r], 0, 0};
+
+	  if (sent[r] < header + sendLength[r])
+	    pfd.events |= POLLOUT;
+
+	  //Until the header arrives recvLength is zero
+	  if (received[r] < header + recvLength[r])
+	    pfd.events |= POLLIN;
+
+	  if (pfd.events)
+	    {
+	      fds.push_back(pfd);
+	      fdRank.push_back(r);
+	    }
+	}
+
+      if (fds.empty()) break;
+
+      if (::poll(&fds[0], fds.size(), -1) < 0)
+	{
+	  if (errno == EINTR) continue;
+	  M_throw() << "Failed to poll the sockets, " << std::strerror(errno);
+	}
+
+      for (size_t i(0); i < fds.size(); ++i)
+	{
+	  const size_t r = fdRank[i];
+
+	  if (fds[i].revents & POLLOUT)
+	    {
+	      const char* data;
+	      size_t len;
+	      if (sent[r] < header)
+		{
+		  data = reinterpret_cast<const char*>(&sendLength[r]) + sent[r];
+		  len = header - sent[r];
+		}
+	      else
+		{
+		  data = &send[r][sent[r] - header];
+		  len = header + sendLength[r] - sent[r];
+		}
+
+	      ssize_t n = ::send(_sockets[r], data, len, MSG_NOSIGNAL);
+	      if (n < 0)
+		{
+		  if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+		    M_throw() << "Failed to send to rank " << r << ", " << std::strerror(errno);
+		}
+	      else
+		sent[r] += n;
+	    }
+
+	  if ((received[r] < header + recvLength[r])
+	      && (fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+	    {
+	      char* data;
+	      size_t len;
+	      if (received[r] < header)
+		{
+		  data = reinterpret_cast<char*>(&recvLength[r]) + received[r];
+		  len = header - received[r];
+		}
+	      else
+		{
+		  data = &recv[r][received[r] - header];
+		  len = header + recvLength[r] - received[r];
+		}
+
+	      ssize_t n = ::read(_sockets[r], data, len);
+	      if (n < 0)
+		{
+		  if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+		    M_throw() << "Failed to receive from rank " << r << ", " << std::strerror(errno);
+		}
+	      else if (n == 0)
+		M_throw() << "Rank " << r << " closed its connection";
+	      else
+		{
+		  received[r] += n;
+		  if (received[r] == header)
+		    recv[r].resize(recvLength[r]);
+		}
+	    }
+	  else if (fds[i].revents & (POLLHUP | POLLERR | POLLNVAL))
+	    M_throw() << "Lost the connection to rank " << r;
+	}
+    }
+}
@@ -0,0 +1,160 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file transport.hpp
+ * Contains the definition of the Transport classes, used to pass
+ * messages between cooperating dynarun processes.
+ */
+#pragma once
+
+#include <magnet/exception.hpp>
+#include <vector>
+#include <string>
+#include <cstring>
+
+/*! \brief A message passing layer between a fixed set of processes.
+ *
+ * Each process has a rank in [0, getRankCount()). All communication
+ * is collective: every rank must make the same sequence of calls.
+ *
+ * New transports (e.g., MPI) only need to implement exchange(), the
+ * reductions are built on top of it. They are created from a
+ * "<type>:<address>" string in Transport::getClass.
+ */
+class Transport
+{
+public:
+  typedef std::vector<char> Buffer;
+
+  Transport(size_t rank, size_t ranks):
+    _rank(rank), _ranks(ranks)
+  {}
+
+  virtual ~Transport() {}
+
+  size_t getRank() const { return _rank; }
+
+  size_t getRankCount() const { return _ranks; }
+
+  /*! \brief An all-to-all exchange of messages.
+   *
+   * \param send send[r] is the message for rank r, the message to
+   * this rank is copied straight to recv.
+   * \param recv On return recv[r] holds the message from rank r.
+   */
+  virtual void exchange(const std::vector<Buffer>& send,
+			std::vector<Buffer>& recv) = 0;
+
+  double allReduceMin(double val);
+
+  unsigned long long allReduceSum(unsigned long long val);
+
+  bool allReduceOr(bool val);
+
+  //! \brief Append the raw bytes of an array of POD values to a Buffer.
+  template<class T>
+  static void pack(Buffer& buf, const T* data, size_t count)
+  {
+    const size_t offset = buf.size();
+    buf.resize(offset + count * sizeof(T));
+    if (count)
+      std::memcpy(&buf[offset], data, count * sizeof(T));
+  }
+
+  //! \brief The number of POD values of type T stored in a Buffer.
+  template<class T>
+  static size_t count(const Buffer& buf)
+  {
+    if (buf.size() % sizeof(T))
+      M_throw() << "Received a message of the wrong size";
+    return buf.size() / sizeof(T);
+  }
+
+  //! \brief Copy the i'th POD value out of a Buffer.
+  template<class T>
+  static T unpack(const Buffer& buf, size_t i)
+  {
+    T val;
+    std::memcpy(&val, &buf[i * sizeof(T)], sizeof(T));
+    return val;
+  }
+
+  /*! \brief Create a Transport from its description.
+   *
+   * The only transport currently available is "unix:<path>", which
+   * connects the ranks through Unix domain sockets named
+   * <path>.<rank>, so all ranks must be on the same host.
+   */
+  static Transport* getClass(const std::string& spec, size_t rank, size_t ranks);
+
+protected:
+  //! \brief Gather one POD value from every rank.
+  template<class T>
+  std::vector<T> allGather(const T& val)
+  {
+    std::vector<Buffer> send(_ranks), recv;
+    for (size_t r(0); r < _ranks; ++r)
+      pack(send[r], &val, 1);
+
+    exchange(send, recv);
+
+    std::vector<T> retval;
+    for (size_t r(0); r < _ranks; ++r)
+      {
+	if (count<T>(recv[r]) != 1)
+	  M_throw() << "Received a malformed reduction message from rank " << r;
+	retval.push_back(unpack<T>(recv[r], 0));
+      }
+
+    return retval;
+  }
+
+  size_t _rank;
+  size_t _ranks;
+};
+
+/*! \brief A Transport using Unix domain stream sockets.
+ *
+ * Every rank listens on <path>.<rank> and the ranks are fully
+ * connected, lower ranks accepting the connections of higher
+ * ones. Messages are length prefixed and exchange() multiplexes all
+ * sends and receives through poll(), so large messages cannot
+ * deadlock.
+ */
+class UnixSocketTransport: public Transport
+{
+public:
+  /*! \brief Connect to all the other ranks.
+   *
+   * \param timeout How long to wait (in seconds) for the other ranks
+   * to start.
+   */
+  UnixSocketTransport(const std::string& path, size_t rank, size_t ranks,
+		      double timeout = 60);
+
+  virtual ~UnixSocketTransport();
+
+  virtual void exchange(const std::vector<Buffer>& send,
+			std::vector<Buffer>& recv);
+
+private:
+  std::string socketName(size_t rank) const;
+
+  std::string _path;
+  int _listener;
+  //! \brief The socket connected to each rank, -1 for this rank.
+  std::vector<int> _sockets;
+};
@@ -17,6 +17,7 @@
 
 #include "dynamics.hpp"
 #include "include.hpp"
+#include "interactions/captures.hpp"
 #include "../datatypes/vector.hpp"
 #include "../datatypes/vector.xml.hpp"
 #include "../base/is_simdata.hpp"
@@ -29,16 +30,20 @@
 #include <magnet/xmlwriter.hpp>
 #include <boost/foreach.hpp>
 #include <cmath>
+#include <limits>
+#include <map>
 
 Dynamics::Dynamics(dynamo::SimData* tmp): 
   SimBase(tmp, "Dynamics"),
   p_BC(NULL), 
-  p_liouvillean(NULL)
+  p_liouvillean(NULL),
+  _classCount(0)
 {}
 
 Dynamics::Dynamics(const magnet::xml::Node& XML, dynamo::SimData* tmp): 
   SimBase(tmp, "Dynamics"),
-  p_BC(NULL)
+  p_BC(NULL),
+  _classCount(0)
 { operator<<(XML); }
 
 Dynamics::~Dynamics() {}
@@ -310,6 +315,9 @@ Dynamics::initialise()
 
   p_liouvillean->initialise();
 
+  //The interactions may look up each other while initialising
+  buildInteractionTable();
+
   size_t ID=0;
 
   BOOST_FOREACH(magnet::ClonePtr<Interaction>& ptr, interactions)
@@ -327,26 +335,116 @@ Dynamics::initialise()
   BOOST_FOREACH(magnet::ClonePtr<Global>& ptr, globals)
     ptr->initialise(ID++);
 
+  //The capture maps are built using the neighbour lists, so this is
+  //done once the globals are initialised
+  BOOST_FOREACH(magnet::ClonePtr<Interaction>& ptr, interactions)
+    {
+      ICapture* capture = dynamic_cast<ICapture*>(ptr.get_ptr());
+      if (capture != NULL) capture->initCaptureMap(Sim);
+    }
+
   ID=0;
 
   BOOST_FOREACH(magnet::ClonePtr<System>& ptr, systems)
     ptr->initialise(ID++);
 }
 
-const magnet::ClonePtr<Interaction>&
-Dynamics::getInteraction(const Particle& p1, const Particle& p2) const 
+void
+Dynamics::buildInteractionTable()
 {
-  BOOST_FOREACH(const magnet::ClonePtr<Interaction>& ptr, interactions)
-    if (ptr->isInteraction(p1,p2))
-      return ptr;
-  
-  M_throw() << "Could not find the interaction requested";
+  _particleClass.clear();
+  _interactionTable.clear();
+  _pairInteractions.clear();
+  _classCount = 0;
+
+  std::vector<const CRange*> ranges;
+  std::vector<bool> tabulated;
+  for (size_t ID(0); ID < interactions.size(); ++ID)
+    {
+      tabulated.push_back(interactions[ID]->getRange()->getSingleRanges(ranges));
+      if (!tabulated.back())
+	_pairInteractions.push_back(ID);
+    }
+
+  //Each particle's class is the set of ranges it is in
+  if (ranges.size() > std::numeric_limits<unsigned long>::digits)
+    return;
+
+  std::map<unsigned long, uint8_t> classIDs;
+  std::vector<size_t> representatives;
+  std::vector<uint8_t> particleClass;
+  particleClass.reserve(Sim->particleList.size());
+
+  BOOST_FOREACH(const Particle& part, Sim->particleList)
+    {
+      unsigned long key(0);
+      for (size_t i(0); i < ranges.size(); ++i)
+	if (ranges[i]->isInRange(part))
+	  key |= 1ul << i;
+
+      std::map<unsigned long, uint8_t>::const_iterator it = classIDs.find(key);
+      if (it == classIDs.end())
+	{
+	  if (classIDs.size() > std::numeric_limits<uint8_t>::max())
+	    {
+	      dout << "Too many particle classes to tabulate the interactions" << std::endl;
+	      return;
+	    }
+
+	  it = classIDs.insert(std::make_pair(key, uint8_t(classIDs.size()))).first;
+	  representatives.push_back(part.getID());
+	}
+
+      particleClass.push_back(it->second);
+    }
+
+  _classCount = representatives.size();
+  _interactionTable.resize(_classCount * _classCount, interactions.size());
+
+  for (size_t c1(0); c1 < _classCount; ++c1)
+    for (size_t c2(0); c2 < _classCount; ++c2)
+      for (size_t ID(0); ID < interactions.size(); ++ID)
+	if (tabulated[ID] 
+	    && interactions[ID]->isInteraction(Sim->particleList[representatives[c1]],
+					       Sim->particleList[representatives[c2]]))
+	  {
+	    _interactionTable[c1 * _classCount + c2] = ID;
+	    break;
+	  }
+
+  _particleClass.swap(particleClass);
+}
+
+void
+Dynamics::getEvents(const Particle& p1, const size_t* ids, size_t N,
+		    std::vector<IntEvent>& events) const
+{
+  const Interaction* current(NULL);
+  size_t start(0);
+
+  for (size_t i(0); i < N; ++i)
+    {
+      const Interaction* ptr 
+	= getInteraction(p1, Sim->particleList[ids[i]]).get_ptr();
+
+      if (ptr != current)
+	{
+	  if (current != NULL)
+	    current->getEvents(p1, ids + start, i - start, events);
+	  current = ptr;
+	  start = i;
+	}
+    }
+
+  if (current != NULL)
+    current->getEvents(p1, ids + start, N - start, events);
 }
 
 Dynamics::Dynamics(const Dynamics &dyn):
   SimBase(dyn),
   p_BC(dyn.p_BC), 
-  _units(dyn._units)
+  _units(dyn._units),
+  _classCount(0)
 {}
 
 void 
@@ -19,10 +19,12 @@
 
 #include <dynamo/dynamics/interactions/interaction.hpp>
 #include <dynamo/dynamics/interactions/intEvent.hpp>
+#include <dynamo/simulation/particle.hpp>
 #include <dynamo/dynamics/units/units.hpp>
 #include <magnet/cloneptr.hpp>
 #include <boost/foreach.hpp>
 #include <vector>
+#include <stdint.h>
 
 class BoundaryCondition;
 class Species;
@@ -73,26 +75,61 @@ public:
 
   const Species& getSpecies(const Particle&) const;
   
-  const magnet::ClonePtr<Interaction>& 
-    getInteraction(const Particle&, const Particle&) const; 
+  /*! \brief Returns the Interaction between two particles.
+   *
+   * This is an index into the table built by
+   * buildInteractionTable(), only the pair specific Interactions
+   * which take precedence over the tabulated one are tested.
+   */
+  inline const magnet::ClonePtr<Interaction>& 
+  getInteraction(const Particle& p1, const Particle& p2) const
+  {
+    if (_interactionTable.empty())
+      {
+	BOOST_FOREACH(const magnet::ClonePtr<Interaction>& ptr, interactions)
+	  if (ptr->isInteraction(p1,p2))
+	    return ptr;
+
+	M_throw() << "Could not find the interaction requested";
+      }
+
+    const size_t entry = _interactionTable[_particleClass[p1.getID()] * _classCount 
+					   + _particleClass[p2.getID()]];
+
+    BOOST_FOREACH(const size_t& ID, _pairInteractions)
+      {
+	if (ID > entry) break;
+	if (interactions[ID]->isInteraction(p1, p2))
+	  return interactions[ID];
+      }
+
+    if (entry == interactions.size())
+      M_throw() << "Could not find the interaction requested";
+
+    return interactions[entry];
+  }
   
   void stream(const double&);
   
   inline IntEvent getEvent(const Particle& p1, const Particle& p2) const
   {
-    BOOST_FOREACH(const magnet::ClonePtr<Interaction>& ptr, interactions)
-      if (ptr->isInteraction(p1,p2))
-	{
+    const magnet::ClonePtr<Interaction>& ptr(getInteraction(p1, p2));
 #ifdef dynamo_UpdateCollDebug
-	  std::cerr << "\nGOT INTERACTION P1 = " << p1.getID() << " P2 = " 
-		    << p2.getID() << " NAME = " << typeid(*ptr.get_ptr()).name();
+    std::cerr << "\nGOT INTERACTION P1 = " << p1.getID() << " P2 = " 
+	      << p2.getID() << " NAME = " << typeid(*ptr.get_ptr()).name();
 #endif
-	  return ptr->getEvent(p1,p2);
-	}
-    
-    M_throw() << "Could not find the right interaction to test for";
+    return ptr->getEvent(p1,p2);
   }
 
+  /*! \brief Calculate the events of p1 with each of a batch of
+   * particles, appending those which occur to events.
+   *
+   * Runs of consecutive IDs using the same Interaction are passed to
+   * Interaction::getEvents together.
+   */
+  void getEvents(const Particle& p1, const size_t* ids, size_t N,
+		 std::vector<IntEvent>& events) const;
+
   void operator<<(const magnet::xml::Node&);
 
   void initialise();
@@ -212,4 +249,23 @@ public:
   magnet::ClonePtr<BoundaryCondition> p_BC;
   magnet::ClonePtr<Liouvillean> p_liouvillean;
   Units _units;
+
+  /*! \brief Tabulates the Interaction of each pair of particles.
+   *
+   * Interactions whose ranges only depend on the single particle
+   * ranges each particle is in (e.g., 2All, 2Single and Pair) can be
+   * tabulated. Each particle is given a class ID from the set of
+   * these ranges it belongs to, and the first tabulated Interaction
+   * of each pair of classes is stored. Interactions with pair
+   * specific ranges (e.g., chains) are tested in getInteraction()
+   * if they precede the tabulated one. If there are too many
+   * classes the table is left empty, and getInteraction() tests
+   * every Interaction in turn.
+   */
+  void buildInteractionTable();
+
+  std::vector<uint8_t> _particleClass;
+  size_t _classCount;
+  std::vector<size_t> _interactionTable;
+  std::vector<size_t> _pairInteractions;
 };
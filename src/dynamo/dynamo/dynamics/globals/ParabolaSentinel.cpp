@@ -89,8 +89,12 @@ CGParabolaSentinel::runEvent(const Particle& part, const double) const
 
   Sim->signalParticleUpdate(EDat);
 
-  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-    Ptr->eventUpdate(iEvent, EDat);
+  {
+    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					dynamo::EventProfile::OUTPUT);
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+      Ptr->eventUpdate(iEvent, EDat);
+  }
 #else
   Sim->freestreamAcc += iEvent.getdt();
 #endif
@@ -27,6 +27,7 @@
 #include "../liouvillean/NewtonianGravityL.hpp"
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include "../../base/binaryconfig.hpp"
 #include <boost/static_assert.hpp>
 #include <cstdio>
 
@@ -304,6 +305,34 @@ CGCells::initialise(size_t nID)
   reinitialise(getMaxInteractionLength());
 }
 
+void
+CGCells::outputExactState(dynamo::BinaryConfigWriter& file) const
+{
+  std::vector<int> lists(cells.size());
+  for (size_t id(0); id < cells.size(); ++id)
+    lists[id] = cells[id].list;
+
+  file.writeBlock(exactBlockName("Lists"), lists);
+  file.writeBlock(exactBlockName("Particles"), partCellData);
+}
+
+void
+CGCells::loadExactState(const dynamo::BinaryConfigReader& file)
+{
+  std::vector<int> lists;
+  std::vector<partCEntry> particles;
+  file.readBlock(exactBlockName("Lists"), lists);
+  file.readBlock(exactBlockName("Particles"), particles);
+
+  if ((lists.size() != cells.size()) || (particles.size() != partCellData.size()))
+    M_throw() << "The cell lists of the checkpoint do not match those of " << getName();
+
+  for (size_t id(0); id < cells.size(); ++id)
+    cells[id].list = lists[id];
+
+  partCellData.swap(particles);
+}
+
 void
 CGCells::reinitialise(const double& maxdiam)
 {
@@ -450,7 +479,38 @@ CGCells::addCells(double maxdiam)
 
   ////initialise the data structures
   BOOST_FOREACH(const Particle& part, Sim->particleList)    
-    addToCell(part.getID(), getCellID(part.getPosition()));
+    if (part.testState(Particle::ALIVE))
+      addToCell(part.getID(), getCellID(part.getPosition()));
+}
+
+void
+CGCells::rebuildCellLists()
+{
+  BOOST_FOREACH(cellStruct& cell, cells)
+    cell.list = -1;
+
+  Sim->dynamics.getLiouvillean().updateAllParticles(); 
+
+  BOOST_FOREACH(const Particle& part, Sim->particleList)
+    if (part.testState(Particle::ALIVE))
+      addToCell(part.getID(), getCellID(part.getPosition()));
+}
+
+void
+CGCells::renumberParticles(const std::vector<size_t>& newID)
+{
+  std::vector<int> cellIDs(newID.size(), -1);
+  for (size_t ID(0); ID < newID.size(); ++ID)
+    cellIDs[newID[ID]] = partCellData[ID].cell;
+
+  BOOST_FOREACH(cellStruct& cell, cells)
+    cell.list = -1;
+
+  //Added in reverse so the cell lists are walked in the order of
+  //the IDs
+  for (size_t ID(Sim->N); ID != 0;)
+    if (Sim->particleList[--ID].testState(Particle::ALIVE))
+      addToCell(ID, cellIDs[ID]);
 }
 
 void 
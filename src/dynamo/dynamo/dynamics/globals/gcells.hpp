@@ -41,6 +41,10 @@ public:
 
   virtual void reinitialise(const double&);
 
+  virtual void outputExactState(dynamo::BinaryConfigWriter&) const;
+
+  virtual void loadExactState(const dynamo::BinaryConfigReader&);
+
   virtual void getParticleNeighbourhood(const Particle&, 
 					const nbHoodFunc&) const;
 
@@ -58,6 +62,20 @@ public:
 
   virtual void outputXML(magnet::xml::XmlStream& XML) const;
 
+  virtual void rebuildCellLists();
+
+  virtual void renumberParticles(const std::vector<size_t>&);
+
+  virtual CVector<int> getCellCount() const { return cellCount; }
+
+  virtual size_t getOverlink() const { return overlink; }
+
+  virtual CVector<int> getCellCoords(const Vector& pos) const
+  { return getCoordsFromID(getCellID(pos)); }
+
+  virtual CVector<int> getParticleCellCoords(const Particle& part) const
+  { return cells[partCellData[part.getID()].cell].coords; }
+
 protected:
   void outputXML(magnet::xml::XmlStream&, const std::string&) const;
 
@@ -28,6 +28,7 @@
 #include <magnet/math/ctime_pow.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include "../../base/binaryconfig.hpp"
 #include <boost/static_assert.hpp>
 #include <cstdio>
 
@@ -227,8 +228,10 @@ CGCellsMorton::runEvent(const Particle& part, const double) const
     }
 
   //Tell about the new locals
-  BOOST_FOREACH(const size_t& lID, cells[endCell])
+  for (size_t i(cellLocalStart[endCell]); i < cellLocalStart[endCell + 1]; ++i)
     {
+      const size_t lID = cellLocals[i];
+
       if (isUsedInScheduler)
 	Sim->ptrScheduler->addLocalEvent(part, lID);
 
@@ -273,6 +276,28 @@ CGCellsMorton::initialise(size_t nID)
   reinitialise(getMaxInteractionLength());
 }
 
+void
+CGCellsMorton::outputExactState(dynamo::BinaryConfigWriter& file) const
+{
+  file.writeBlock(exactBlockName("Lists"), list);
+  file.writeBlock(exactBlockName("Particles"), partCellData);
+}
+
+void
+CGCellsMorton::loadExactState(const dynamo::BinaryConfigReader& file)
+{
+  std::vector<int> lists;
+  std::vector<partCEntry> particles;
+  file.readBlock(exactBlockName("Lists"), lists);
+  file.readBlock(exactBlockName("Particles"), particles);
+
+  if ((lists.size() != list.size()) || (particles.size() != partCellData.size()))
+    M_throw() << "The cell lists of the checkpoint do not match those of " << getName();
+
+  list.swap(lists);
+  partCellData.swap(particles);
+}
+
 void
 CGCellsMorton::reinitialise(const double& maxdiam)
 {
@@ -307,7 +332,6 @@ CGCellsMorton::outputXML(magnet::xml::XmlStream& XML) const
 void
 CGCellsMorton::addCells(double maxdiam)
 {
-  cells.clear();
   partCellData.resize(Sim->N); //Location data for particles
 
   NCells = 1;
@@ -322,20 +346,22 @@ CGCellsMorton::addCells(double maxdiam)
   if (cellCount < 3)
     M_throw() << "Not enough cells, sim too small, need 3+";
 
-  if (cellCount > std::numeric_limits<unsigned char>::max())
+  //The cell coordinates must fit in the dilated integers, this also
+  //leaves room for the wrap around tests
+  if (cellCount > magnet::math::DilatedInteger::undilatedMask)
     {
       dout << "Cell count was " << cellCount
-	       << "\n Restricting to " << std::numeric_limits<unsigned char>::max() 
-	       << " to stop huge amounts of memory being allocated" << std::endl;
+	       << "\n Restricting to " << magnet::math::DilatedInteger::undilatedMask
+	       << " as the morton numbers are limited to 64 bits" << std::endl;
 
-      cellCount = std::numeric_limits<unsigned char>::max();
+      cellCount = magnet::math::DilatedInteger::undilatedMask;
     }
 
   dilatedCellMax = cellCount - 1;
 
   dilatedOverlink = overlink;
 
-  NCells = cellCount * cellCount * cellCount;
+  NCells = size_t(cellCount) * cellCount * cellCount;
 
   cellLatticeWidth = Sim->primaryCellSize[0] / cellCount;
   
@@ -364,19 +390,9 @@ CGCellsMorton::addCells(double maxdiam)
       if (sizeReq >= NCells) break;
     }
 
-  cells.resize(sizeReq); //Empty Cells created!
-  list.resize(sizeReq); //Empty Cells created!
+  list.assign(sizeReq, -1); //Empty Cells created!
 
   dout << "Vector Size <N>  " << sizeReq << std::endl;
-  
-  for (size_t iDim = 0; iDim < cellCount; ++iDim)
-    for (size_t jDim = 0; jDim < cellCount; ++jDim)
-      for (size_t kDim = 0; kDim < cellCount; ++kDim)
-	{
-	  magnet::math::DilatedVector coords(iDim, jDim, kDim);
-	  size_t id = coords.getMortonNum();
-	  list[id] = -1;
-	}
 
   //Add the particles section
   //Required so particles find the right owning cell
@@ -384,28 +400,69 @@ CGCellsMorton::addCells(double maxdiam)
 
   ////initialise the data structures
   BOOST_FOREACH(const Particle& part, Sim->particleList)
-    addToCell(part.getID(), getCellID(part.getPosition()).getMortonNum());
+    if (part.testState(Particle::ALIVE))
+      addToCell(part.getID(), getCellID(part.getPosition()).getMortonNum());
+}
+
+void
+CGCellsMorton::rebuildCellLists()
+{
+  std::fill(list.begin(), list.end(), -1);
+
+  Sim->dynamics.getLiouvillean().updateAllParticles(); 
+
+  BOOST_FOREACH(const Particle& part, Sim->particleList)
+    if (part.testState(Particle::ALIVE))
+      addToCell(part.getID(), getCellID(part.getPosition()).getMortonNum());
+}
+
+void
+CGCellsMorton::renumberParticles(const std::vector<size_t>& newID)
+{
+  std::vector<size_t> cellIDs(newID.size(), 0);
+  for (size_t ID(0); ID < newID.size(); ++ID)
+    cellIDs[newID[ID]] = partCellData[ID].cell;
+
+  std::fill(list.begin(), list.end(), -1);
+
+  //Added in reverse so the cell lists are walked in the order of
+  //the IDs
+  for (size_t ID(Sim->N); ID != 0;)
+    if (Sim->particleList[--ID].testState(Particle::ALIVE))
+      addToCell(ID, cellIDs[ID]);
 }
 
 void 
 CGCellsMorton::addLocalEvents()
 {
   Vector cellDimensionsVector(cellDimension,cellDimension,cellDimension);
-  for (size_t iDim = 0; iDim < cellCount; ++iDim)
-    for (size_t jDim = 0; jDim < cellCount; ++jDim)
-      for (size_t kDim = 0; kDim < cellCount; ++kDim)
-	{
-	  magnet::math::DilatedVector coords(iDim, jDim, kDim);
-	  size_t id = coords.getMortonNum();
-	  cells[id].clear();
-	  Vector pos = calcPosition(coords);
+
+  cellLocalStart.resize(list.size() + 1);
+  cellLocals.clear();
+
+  //Walk the cells in morton order to build the local lists, the
+  //morton numbers outside of the cells have no locals
+  for (size_t id(0); id < list.size(); ++id)
+    {
+      cellLocalStart[id] = cellLocals.size();
+
+      const magnet::math::DilatedVector coords(id);
+      if ((coords.data[0] > dilatedCellMax) || (coords.data[1] > dilatedCellMax)
+	  || (coords.data[2] > dilatedCellMax))
+	continue;
+
+      Vector pos = calcPosition(coords);
 	  
-	  //We make the box slightly larger to ensure objects on the boundary are included
-	  BOOST_FOREACH(const magnet::ClonePtr<Local>& local, Sim->dynamics.getLocals())
-	    if (local->isInCell(pos - 0.0001 * cellDimensionsVector, 1.0002 * cellDimensionsVector))
-	      cells[id].push_back(local->getID());
+      //We make the box slightly larger to ensure objects on the boundary are included
+      BOOST_FOREACH(const magnet::ClonePtr<Local>& local, Sim->dynamics.getLocals())
+	if (local->isInCell(pos - 0.0001 * cellDimensionsVector, 1.0002 * cellDimensionsVector))
+	  cellLocals.push_back(local->getID());
 
-	}
+      if (cellLocals.size() > std::numeric_limits<uint32_t>::max())
+	M_throw() << "Too many locals in the cells of " << getName();
+    }
+
+  cellLocalStart.back() = cellLocals.size();
 }
 
 magnet::math::DilatedVector
@@ -493,9 +550,9 @@ void
 CGCellsMorton::getParticleLocalNeighbourhood(const Particle& part, 
 				       const nbHoodFunc& func) const
 {
-  BOOST_FOREACH(const size_t& id, 
-		cells[partCellData[part.getID()].cell])
-    func(part, id);
+  const size_t cellID = partCellData[part.getID()].cell;
+  for (size_t i(cellLocalStart[cellID]); i < cellLocalStart[cellID + 1]; ++i)
+    func(part, cellLocals[i]);
 }
 
 double 
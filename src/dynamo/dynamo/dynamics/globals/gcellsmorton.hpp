@@ -44,6 +44,10 @@ public:
 
   virtual void reinitialise(const double&);
 
+  virtual void outputExactState(dynamo::BinaryConfigWriter&) const;
+
+  virtual void loadExactState(const dynamo::BinaryConfigReader&);
+
   virtual void getParticleNeighbourhood(const Particle&, 
 					const nbHoodFunc&) const;
 
@@ -59,14 +63,37 @@ public:
 
   virtual double getMaxInteractionLength() const;
 
+  virtual void rebuildCellLists();
+
+  virtual void renumberParticles(const std::vector<size_t>&);
+
+  virtual CVector<int> getCellCount() const { return CVector<int>(cellCount); }
+
+  virtual size_t getOverlink() const { return overlink; }
+
+  virtual CVector<int> getCellCoords(const Vector& pos) const
+  { return getCoords(getCellID(pos)); }
+
+  virtual CVector<int> getParticleCellCoords(const Particle& part) const
+  { return getCoords(magnet::math::DilatedVector(partCellData[part.getID()].cell)); }
+
 protected:
+  static CVector<int> getCoords(const magnet::math::DilatedVector& dv)
+  {
+    CVector<int> coords;
+    for (size_t iDim(0); iDim < NDIM; ++iDim)
+      coords[iDim] = dv.data[iDim].getRealVal();
+    return coords;
+  }
+
   CGCellsMorton(dynamo::SimData*, const char*, void*);
 
   struct partCEntry
   {
     int prev;
     int next;
-    int cell;
+    //The morton number of the cell
+    size_t cell;
   };
 
   virtual void outputXML(magnet::xml::XmlStream&) const;
@@ -96,11 +123,16 @@ protected:
 
   mutable std::vector<int>list;
 
-  mutable std::vector<std::vector<size_t> > cells;
+  //The IDs of the locals in each cell, the locals of the cell with
+  //morton number id are cellLocals[cellLocalStart[id]] up to
+  //cellLocals[cellLocalStart[id+1]]. Only a few cells hold locals, so
+  //this keeps the memory per cell small for large systems.
+  std::vector<uint32_t> cellLocalStart;
+  std::vector<size_t> cellLocals;
 
   mutable std::vector<partCEntry> partCellData;
 
-  inline void addToCell(const int& ID, const int& cellID) const
+  inline void addToCell(const int& ID, const size_t& cellID) const
   {
 #ifdef DYNAMO_DEBUG
     if (list.at(cellID) != -1)
@@ -133,7 +165,7 @@ protected:
       partCellData[partCellData[ID].next].prev = partCellData[ID].prev;
 
 #ifdef DYNAMO_DEBUG
-    partCellData[ID].cell = -1;
+    partCellData[ID].cell = std::numeric_limits<size_t>::max();
 #endif
   }
 
@@ -22,6 +22,7 @@
 #include "../ranges/1RAll.hpp"
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
+#include <boost/lexical_cast.hpp>
 
 
 Global::Global(dynamo::SimData* tmp, const char *name):
@@ -40,6 +41,10 @@ Global::isInteraction(const Particle &p1) const
   return range->isInRange(p1);
 }
 
+std::string
+Global::exactBlockName(const std::string& name) const
+{ return "Exact/Global" + boost::lexical_cast<std::string>(ID) + "/" + name; }
+
 magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, const Global& g)
 {
   g.outputXML(XML);
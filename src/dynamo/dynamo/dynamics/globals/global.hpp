@@ -23,6 +23,7 @@
 
 namespace magnet { namespace xml { class Node; } }
 namespace xml { class XmlStream; }
+namespace dynamo { class BinaryConfigWriter; class BinaryConfigReader; }
 class IntEvent;
 class NEventData;
 class GlobalEvent;
@@ -46,6 +47,19 @@ public:
 
   virtual void initialise(size_t) = 0;
 
+  /*! \brief Write the state the Global changes as the simulation
+   * runs (e.g., the cell lists) to an exact checkpoint (see
+   * SimData::restartFile).
+   *
+   * The state is restored by loadExactState after the Global is
+   * initialised, so Globals which only hold their configuration
+   * need not implement these.
+   */
+  virtual void outputExactState(dynamo::BinaryConfigWriter&) const {}
+
+  //! \brief Restore the state written by outputExactState.
+  virtual void loadExactState(const dynamo::BinaryConfigReader&) {}
+
   friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream&, const Global&);
 
   static Global* getClass(const magnet::xml::Node&, dynamo::SimData*);
@@ -57,10 +71,16 @@ public:
   const std::string& getName() const { return globName; }
 
   inline const size_t& getID() const { return ID; }
+
+  //! \brief The particles this acts on, this may be empty.
+  inline const magnet::ClonePtr<CRange>& getRange() const { return range; }
   
 protected:
   virtual void outputXML(magnet::xml::XmlStream&) const = 0;
 
+  //! \brief The name of a block of this Global in an exact checkpoint.
+  std::string exactBlockName(const std::string& name) const;
+
   magnet::ClonePtr<CRange> range;  
   std::string globName;
   size_t ID;
@@ -17,6 +17,8 @@
 
 #pragma once
 #include "global.hpp"
+#include "../../datatypes/vector.hpp"
+#include <magnet/exception.hpp>
 #include <boost/function.hpp>
 #include <magnet/function/delegate.hpp>
 #include <vector>
@@ -80,7 +82,7 @@ public:
   {    
     sigCellChangeNotify.push_back
       (nbHoodSlot(++sigCellChangeNotifyCount, 
-		  getNBDelegate(func,tp)));
+		  magnet::function::MakeDelegate(tp, func)));
     
     return sigCellChangeNotifyCount; 
   }
@@ -101,7 +103,7 @@ public:
   {    
     sigNewLocalNotify.push_back
       (nbHoodSlot(++sigNewLocalNotifyCount, 
-		  getNBDelegate(func,tp)));
+		  magnet::function::MakeDelegate(tp, func)));
     
     return sigNewLocalNotifyCount; 
   }
@@ -123,7 +125,7 @@ public:
   {    
     sigNewNeighbourNotify.push_back
       (nbHoodSlot(++sigNewNeighbourNotifyCount, 
-		  getNBDelegate(func, tp)));
+		  magnet::function::MakeDelegate(tp, func)));
     
     return sigNewNeighbourNotifyCount; 
   }
@@ -166,6 +168,44 @@ public:
 
   void markAsUsedInScheduler() { isUsedInScheduler = true; }
 
+  /*! \brief Re-bin the ALIVE particles into the existing cells.
+   *
+   * Unlike reinitialise(), this keeps the cell lattice and does not
+   * notify the scheduler or any listeners. It is used when the
+   * particle positions are replaced wholesale (e.g., by an engine
+   * synchronising replicas) and the scheduler is rebuilt afterwards.
+   */
+  virtual void rebuildCellLists()
+  { M_throw() << "This neighbour list does not support rebuilding the cell lists"; }
+
+  /*! \brief Renumber the particles in the cell lists, see SReorder.
+   *
+   * The particle with the ID \p i takes the ID newID[i] and stays in
+   * the cell it is registered in. The cells are not recomputed from
+   * the positions (see rebuildCellLists()), as a particle on a cell
+   * boundary may round into the neighbouring cell. The particle list
+   * must already be renumbered, and the scheduler is rebuilt
+   * afterwards.
+   */
+  virtual void renumberParticles(const std::vector<size_t>& newID)
+  { M_throw() << "This neighbour list does not support renumbering the particles"; }
+
+  //! \brief The number of cells in each dimension.
+  virtual CVector<int> getCellCount() const
+  { M_throw() << "This neighbour list does not have a cell lattice"; }
+
+  //! \brief The number of neighbouring cells searched in each direction.
+  virtual size_t getOverlink() const
+  { M_throw() << "This neighbour list does not have a cell lattice"; }
+
+  //! \brief The coordinates of the cell containing the position.
+  virtual CVector<int> getCellCoords(const Vector&) const
+  { M_throw() << "This neighbour list does not have a cell lattice"; }
+
+  //! \brief The coordinates of the cell the particle is registered in.
+  virtual CVector<int> getParticleCellCoords(const Particle&) const
+  { M_throw() << "This neighbour list does not have a cell lattice"; }
+
   void setCellOverlap(bool overlap) 
   {
     if (overlap)
@@ -149,8 +149,12 @@ CGSOCells::runEvent(const Particle& part, const double) const
   //Now we're past the event update the scheduler and plugins
   Sim->ptrScheduler->fullUpdate(part);
   
-  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-    Ptr->eventUpdate(iEvent, EDat);
+  {
+    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					dynamo::EventProfile::OUTPUT);
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+      Ptr->eventUpdate(iEvent, EDat);
+  }
 
 }
 
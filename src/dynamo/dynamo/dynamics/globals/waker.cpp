@@ -156,8 +156,12 @@ GWaker::runEvent(const Particle& part, const double dt) const
       
       Sim->signalParticleUpdate(EDat);
       
-      BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	Ptr->eventUpdate(iEvent, EDat);
+      {
+	dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					    dynamo::EventProfile::OUTPUT);
+	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	  Ptr->eventUpdate(iEvent, EDat);
+      }
 //    }
 //  else
 //    Sim->freestreamAcc += iEvent.getdt();
@@ -18,38 +18,233 @@
 #include "captures.hpp"
 #include "../../simulation/particle.hpp"
 #include "../../base/is_simdata.hpp"
+#include "../../base/binaryconfig.hpp"
+#include "../globals/neighbourList.hpp"
+#include <magnet/thread/workstealing.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <boost/foreach.hpp>
 
+namespace {
+  /*! \brief Counts the pairs stored in a CaptureMap node.
+   *
+   * The pairs are written out in the slot order of the capture map,
+   * which is the order of their hashes. Inserting them in that order
+   * into a table which has to grow piles them all into one cluster,
+   * so the capture map must be sized before it is loaded.
+   */
+  size_t countPairs(const magnet::xml::Node& XML)
+  {
+    size_t count(0);
+    for (magnet::xml::Node node = XML.fastGetNode("Pair"); node.valid(); ++node)
+      ++count;
+    return count;
+  }
+
+  //! \brief The element of a capture map block in a binary configuration file.
+  struct BinaryPair
+  {
+    uint32_t ID1;
+    uint32_t ID2;
+  };
+
+  //! \brief The element of a multiple capture map block in a binary configuration file.
+  struct BinaryMultiPair
+  {
+    uint32_t ID1;
+    uint32_t ID2;
+    int32_t val;
+  };
+
+  //! \brief The binary configuration file a CaptureMap block refers to.
+  const dynamo::BinaryConfigReader& getReader(const dynamo::SimData* Sim)
+  {
+    if (Sim->binaryReader == NULL)
+      M_throw() << "A CaptureMap refers to a block of a binary configuration file,"
+		<< " but the configuration was not loaded from one";
+
+    return *Sim->binaryReader;
+  }
+
+  /*! \brief Finds the captured pairs of the particles of a system.
+   *
+   * The particles are split into slices which are searched in
+   * parallel. Each slice collects the captured pairs it finds into
+   * its own buffer, which are then merged into the capture map by
+   * the calling thread.
+   *
+   * Each pair is only tested once, by the slice containing the
+   * particle with the lower ID.
+   *
+   * \tparam T The return type of the captureTest function, the pair
+   * is captured if the result is non-zero.
+   */
+  template<class T>
+  class CaptureSearch
+  {
+  public:
+    typedef magnet::function::Delegate2<const Particle&, const Particle&, T> testFunc;
+    typedef std::vector<std::pair<ICapture::cMapKey, T> > buffer;
+    typedef magnet::function::Task1<void, size_t> SliceTask;
+
+    CaptureSearch(const dynamo::SimData* Sim, const testFunc& test):
+      _sim(Sim), _test(test), _nblist(NULL)
+    {
+      BOOST_FOREACH(const magnet::ClonePtr<Global>& glob, Sim->dynamics.getGlobals())
+	if (glob->getName() == "SchedulerNBList")
+	  _nblist = dynamic_cast<const CGNeighbourList*>(glob.get_ptr());
+
+      //The neighbourhood must contain all interacting particles
+      if ((_nblist != NULL) 
+	  && (_nblist->getMaxSupportedInteractionLength() 
+	      < Sim->dynamics.getLongestInteraction()))
+	_nblist = NULL;
+
+      //Several slices per thread balance the load when the density
+      //is not uniform
+      const size_t threads = (Sim->threads != NULL) ? Sim->threads->getThreadCount() : 0;
+      _slices.resize(std::max(4 * threads, size_t(1)));
+      for (size_t i(0); i < _slices.size(); ++i)
+	_slices[i]._search = this;
+    }
+
+    //! \brief Run the search, the results are then in the slices
+    void run()
+    {
+      std::vector<SliceTask> tasks;
+      for (size_t slice(0); slice < _slices.size(); ++slice)
+	tasks.push_back(SliceTask(magnet::function::MakeDelegate(this, &CaptureSearch::searchSlice),
+				  slice));
+
+      if (_sim->threads == NULL)
+	BOOST_FOREACH(SliceTask& task, tasks)
+	  task();
+      else
+	{
+	  magnet::thread::TaskGroup group(*_sim->threads);
+	  BOOST_FOREACH(SliceTask& task, tasks)
+	    group.spawn(task);
+	  group.wait();
+	}
+    }
+
+    size_t captureCount() const
+    {
+      size_t count(0);
+      BOOST_FOREACH(const Slice& slice, _slices)
+	count += slice._captures.size();
+      return count;
+    }
+
+    //! \brief The captured pairs found by a slice
+    const buffer& getCaptures(size_t slice) const { return _slices[slice]._captures; }
+
+    size_t getSliceCount() const { return _slices.size(); }
+
+  private:
+    /*! \brief The per-thread storage of a slice.
+     *
+     * The padding keeps the buffers of neighbouring slices on
+     * separate cache lines.
+     */
+    struct Slice
+    {
+      void test(const Particle& p1, const size_t& ID)
+      {
+	if (ID < p1.getID()) return;
+	const T val = _search->_test(p1, _search->_sim->particleList[ID]);
+	if (val)
+	  _captures.push_back(typename buffer::value_type
+			      (ICapture::cMapKey(p1.getID(), ID), val));
+      }
+
+      CaptureSearch* _search;
+      buffer _captures;
+      char _padding[64];
+    };
+
+    void searchSlice(size_t slice)
+    {
+      Slice& data(_slices[slice]);
+      const size_t N = _sim->particleList.size();
+      const size_t start = (N * slice) / _slices.size();
+      const size_t end = (N * (slice + 1)) / _slices.size();
+
+      if (_nblist != NULL)
+	{
+	  const CGNeighbourList::nbHoodFunc func
+	    = magnet::function::MakeDelegate(&data, &Slice::test);
+	  for (size_t ID(start); ID < end; ++ID)
+	    _nblist->getParticleNeighbourhood(_sim->particleList[ID], func);
+	}
+      else
+	for (size_t ID1(start); ID1 < end; ++ID1)
+	  for (size_t ID2(ID1 + 1); ID2 < N; ++ID2)
+	    data.test(_sim->particleList[ID1], ID2);
+    }
+
+    const dynamo::SimData* _sim;
+    testFunc _test;
+    const CGNeighbourList* _nblist;
+    std::vector<Slice> _slices;
+  };
+}
+
 //////////////////////////////////////////////////////
 //////////////////////////////////////////////////////
 
 void 
-ISingleCapture::initCaptureMap(const std::vector<Particle>& particleList)
+ISingleCapture::initCaptureMap(const dynamo::SimData* Sim)
 {
   //If not loaded or invalidated
   if (noXmlLoad)
     {
       captureMap.clear();
-      
-      for (std::vector<Particle>::const_iterator iPtr
-	     = particleList.begin();
-	   iPtr != particleList.end(); iPtr++)
-	for (std::vector<Particle>::const_iterator iPtr2 = iPtr + 1;
-	     iPtr2 != particleList.end(); iPtr2++)
-	  if (captureTest(*iPtr,*iPtr2))
-	    addToCaptureMap(*iPtr, *iPtr2);
+
+      CaptureSearch<bool> search(Sim, magnet::function::MakeDelegate(this, &ISingleCapture::captureTest));
+      search.run();
+
+      captureMap.reserve(search.captureCount());
+      for (size_t slice(0); slice < search.getSliceCount(); ++slice)
+	BOOST_FOREACH(const CaptureSearch<bool>::buffer::value_type& capture,
+		      search.getCaptures(slice))
+	  captureMap.insert(capture.first);
     }
 }
 
+void
+ISingleCapture::remapCaptureMap(const std::vector<size_t>& newID)
+{
+  captureMapType newMap((cMapKey()));
+  newMap.reserve(captureMap.size());
+  BOOST_FOREACH(const cMapKey& key, captureMap)
+    newMap.insert(cMapKey(newID[key.first], newID[key.second]));
+
+  captureMap.swap(newMap);
+}
+
 void 
-ISingleCapture::loadCaptureMap(const magnet::xml::Node& XML)
+ISingleCapture::loadCaptureMap(const magnet::xml::Node& XML, const dynamo::SimData* Sim)
 {
-  if (XML.hasNode("CaptureMap"))
+  if (XML.hasNode("CaptureMap") && XML.getNode("CaptureMap").hasAttribute("Block"))
+    {
+      noXmlLoad = false;
+      captureMap.clear();
+
+      const dynamo::BinaryConfigReader& file = getReader(Sim);
+      const size_t block = XML.getNode("CaptureMap").getAttribute("Block").as<size_t>();
+      const BinaryPair* pairs = file.getBlock<BinaryPair>(block);
+      const size_t count = file.getCount(block);
+
+      captureMap.reserve(count);
+      for (size_t i(0); i < count; ++i)
+	captureMap.insert(cMapKey(pairs[i].ID1, pairs[i].ID2));
+    }
+  else if (XML.hasNode("CaptureMap"))
     {
       noXmlLoad = false;
       captureMap.clear();
+      captureMap.reserve(countPairs(XML.getNode("CaptureMap")));
 
       for (magnet::xml::Node node = XML.getNode("CaptureMap").fastGetNode("Pair");
 	   node.valid(); ++node)
@@ -59,10 +254,27 @@ ISingleCapture::loadCaptureMap(const magnet::xml::Node& XML)
 }
 
 void 
-ISingleCapture::outputCaptureMap(magnet::xml::XmlStream& XML) const 
+ISingleCapture::outputCaptureMap(magnet::xml::XmlStream& XML, const dynamo::SimData* Sim) const 
 {
   XML << magnet::xml::tag("CaptureMap");
 
+  if (Sim->binaryWriter != NULL)
+    {
+      const size_t block = Sim->binaryWriter->beginBlock("CaptureMap", sizeof(BinaryPair));
+
+      BOOST_FOREACH(const cMapKey& IDs, captureMap)
+	{
+	  const BinaryPair pair = {IDs.first, IDs.second};
+	  Sim->binaryWriter->write(pair);
+	}
+
+      Sim->binaryWriter->endBlock();
+
+      XML << magnet::xml::attr("Block") << block
+	  << magnet::xml::endtag("CaptureMap");
+      return;
+    }
+
   BOOST_FOREACH(const cMapKey& IDs, captureMap)
     XML << magnet::xml::tag("Pair")
 	<< magnet::xml::attr("ID1") << IDs.first
@@ -76,34 +288,60 @@ ISingleCapture::outputCaptureMap(magnet::xml::XmlStream& XML) const
 //////////////////////////////////////////////////////
 
 void 
-IMultiCapture::initCaptureMap(const std::vector<Particle>& particleList)
+IMultiCapture::initCaptureMap(const dynamo::SimData* Sim)
 {
   //If not loaded or invalidated
   if (noXmlLoad)
     {      
       captureMap.clear();
-      
-      for (std::vector<Particle>::const_iterator iPtr 
-	     = particleList.begin();
-	   iPtr != particleList.end(); iPtr++) 
-	for (std::vector<Particle>::const_iterator iPtr2 = iPtr + 1;
-	     iPtr2 != particleList.end(); iPtr2++)
-	  {
-	    int capval = captureTest(*iPtr,*iPtr2);
-	    if (captureTest(*iPtr,*iPtr2))
-	      captureMap[cMapKey(iPtr->getID(), iPtr2->getID())] 
-		= capval; 
-	  }
+
+      CaptureSearch<int> search(Sim, magnet::function::MakeDelegate(this, &IMultiCapture::captureTest));
+      search.run();
+
+      captureMap.reserve(search.captureCount());
+      for (size_t slice(0); slice < search.getSliceCount(); ++slice)
+	BOOST_FOREACH(const CaptureSearch<int>::buffer::value_type& capture,
+		      search.getCaptures(slice))
+	  captureMap.insert(capture);
     }
 }
 
+void
+IMultiCapture::remapCaptureMap(const std::vector<size_t>& newID)
+{
+  captureMapType newMap((cMapKey()));
+  newMap.reserve(captureMap.size());
+  BOOST_FOREACH(const captureMapType::value_type& entry, captureMap)
+    newMap.insert(captureMapType::value_type(cMapKey(newID[entry.first.first],
+						     newID[entry.first.second]),
+					     entry.second));
+
+  captureMap.swap(newMap);
+}
+
 void 
-IMultiCapture::loadCaptureMap(const magnet::xml::Node& XML)
+IMultiCapture::loadCaptureMap(const magnet::xml::Node& XML, const dynamo::SimData* Sim)
 {
-  if (XML.hasNode("CaptureMap"))
+  if (XML.hasNode("CaptureMap") && XML.getNode("CaptureMap").hasAttribute("Block"))
+    {
+      noXmlLoad = false;
+      captureMap.clear();
+
+      const dynamo::BinaryConfigReader& file = getReader(Sim);
+      const size_t block = XML.getNode("CaptureMap").getAttribute("Block").as<size_t>();
+      const BinaryMultiPair* pairs = file.getBlock<BinaryMultiPair>(block);
+      const size_t count = file.getCount(block);
+
+      captureMap.reserve(count);
+      for (size_t i(0); i < count; ++i)
+	captureMap.insert(captureMapType::value_type(cMapKey(pairs[i].ID1, pairs[i].ID2),
+						     pairs[i].val));
+    }
+  else if (XML.hasNode("CaptureMap"))
     {
       noXmlLoad = false;
       captureMap.clear();
+      captureMap.reserve(countPairs(XML.getNode("CaptureMap")));
 
       for (magnet::xml::Node node = XML.getNode("CaptureMap").fastGetNode("Pair");
 	   node.valid(); ++node)
@@ -114,11 +352,28 @@ IMultiCapture::loadCaptureMap(const magnet::xml::Node& XML)
 }
 
 void 
-IMultiCapture::outputCaptureMap(magnet::xml::XmlStream& XML) const 
+IMultiCapture::outputCaptureMap(magnet::xml::XmlStream& XML, const dynamo::SimData* Sim) const 
 {
   XML << magnet::xml::tag("CaptureMap");
 
-  typedef std::pair<const cMapKey, int> locpair;
+  typedef captureMapType::value_type locpair;
+
+  if (Sim->binaryWriter != NULL)
+    {
+      const size_t block = Sim->binaryWriter->beginBlock("MultiCaptureMap", sizeof(BinaryMultiPair));
+
+      BOOST_FOREACH(const locpair& IDs, captureMap)
+	{
+	  const BinaryMultiPair pair = {IDs.first.first, IDs.first.second, IDs.second};
+	  Sim->binaryWriter->write(pair);
+	}
+
+      Sim->binaryWriter->endBlock();
+
+      XML << magnet::xml::attr("Block") << block
+	  << magnet::xml::endtag("CaptureMap");
+      return;
+    }
 
   BOOST_FOREACH(const locpair& IDs, captureMap)
     XML << magnet::xml::tag("Pair")
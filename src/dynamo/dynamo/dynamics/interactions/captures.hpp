@@ -19,9 +19,12 @@
 
 #include "../../simulation/particle.hpp"
 #include <magnet/exception.hpp>
-#include <boost/tr1/unordered_set.hpp>
-#include <boost/tr1/unordered_map.hpp>
+#include <magnet/containers/OpenHash.hpp>
 #include <vector>
+#include <limits>
+#include <stdint.h>
+
+namespace dynamo { class SimData; }
 
 /*! \brief A general interface for \ref Interaction classes with
  *  states for the particle pairs.
@@ -34,6 +37,8 @@
 class ICapture
 {
 public:
+  ICapture(): noXmlLoad(true) {}
+
   //! \brief Returns the number of particles that are captured in some way
   virtual size_t getTotalCaptureCount() const = 0;
   
@@ -43,25 +48,61 @@ public:
   //! \brief Returns the total internal energy stored in this Interaction.
   virtual double getInternalEnergy() const = 0;
 
-protected:
+  /*! \brief Builds the capture map from the current particle
+   * positions, unless it was loaded from the configuration file.
+   *
+   * This is called by Dynamics::initialise once the globals are
+   * initialised, as the neighbour list of the scheduler (the global
+   * named "SchedulerNBList") is used to find the candidate pairs. If
+   * there is no such neighbour list, every pair of particles is
+   * tested. The tests are split over the thread pool of the
+   * simulation (if one is set), so captureTest must be thread safe.
+   */
+  virtual void initCaptureMap(const dynamo::SimData*) = 0;
+
+  /*! \brief Renumbers the particles of the captured pairs.
+   *
+   * This is used when the particles are reordered (see SReorder),
+   * \p newID holds the new ID of each particle.
+   */
+  virtual void remapCaptureMap(const std::vector<size_t>& newID) = 0;
+
   /*! \brief A key used to represent two particles.
    *
    * This key sorts the particle ID's into ascending order. This way
    * the keys can be compared and symmetric keys will compare equal.
    * \code assert(cMapKey(a,b) == cMapKey(b,a)); \endcode
+   *
+   * The ID's are stored in 32 bits to halve the size of the capture
+   * maps. The default constructed key has both ID's equal, which is
+   * never a valid pair, and is used to mark empty slots in the
+   * capture maps.
    */
-  struct cMapKey: public std::pair<size_t,size_t>
+  struct cMapKey: public std::pair<uint32_t,uint32_t>
   {
-    inline cMapKey() {}
+    inline cMapKey():
+      std::pair<uint32_t,uint32_t>(std::numeric_limits<uint32_t>::max(),
+				   std::numeric_limits<uint32_t>::max())
+    {}
     
     inline cMapKey(const size_t& a, const size_t& b):
-      std::pair<size_t,size_t>(std::min(a, b), std::max(a, b))
+      std::pair<uint32_t,uint32_t>(std::min(a, b), std::max(a, b))
     {
 #ifdef DYNAMO_DEBUG
       if (a == b) M_throw() << "Particle ID's should not be equal!";
 #endif
     }
   };
+
+  //! \brief The hash of a cMapKey, the capture maps mix the bits.
+  struct cMapKeyHash
+  {
+    inline uint64_t operator()(const cMapKey& key) const
+    { return (uint64_t(key.first) << 32) | key.second; }
+  };
+
+protected:
+  bool noXmlLoad;
 };
 
 /*! \brief This base class is for Interaction classes which only
@@ -74,16 +115,22 @@ protected:
 class ISingleCapture: public ICapture
 {
 public:
-  ISingleCapture():noXmlLoad(true) {}
+  ISingleCapture(): captureMap(cMapKey()) {}
 
   size_t getTotalCaptureCount() const { return captureMap.size(); }
   
   virtual bool isCaptured(const Particle& p1, const Particle& p2) const
   { return captureMap.count(cMapKey(p1.getID(), p2.getID())); }
 
+  virtual void initCaptureMap(const dynamo::SimData*);
+
+  virtual void remapCaptureMap(const std::vector<size_t>&);
+
 protected:
 
-  mutable std::tr1::unordered_set<cMapKey > captureMap;
+  typedef magnet::containers::OpenHashSet<cMapKey, cMapKeyHash> captureMapType;
+
+  mutable captureMapType captureMap;
 
   /*! \brief Test if two particles should be "captured".
    *
@@ -93,23 +140,22 @@ protected:
    */
   virtual bool captureTest(const Particle&, const Particle&) const = 0;
 
-  bool noXmlLoad;
-
-  void initCaptureMap(const std::vector<Particle>& particleList);
-
   /*! \brief Function to load the capture map. 
    *
    * Should be called by the derived classes
-   * Interaction::operator<<(const magnet::xml::Node&) function.
+   * Interaction::operator<<(const magnet::xml::Node&) function. The
+   * SimData is needed to read capture maps stored in a block of a
+   * binary configuration file.
    */
-  void loadCaptureMap(const magnet::xml::Node&);
+  void loadCaptureMap(const magnet::xml::Node&, const dynamo::SimData*);
 
   /*! \brief Function to write out the capture map. 
    *
    * Should be called by the derived classes Interaction::outputXML()
-   * function.
+   * function. If a binary configuration file is being written, the
+   * pairs are written to a block of the file instead of the XML.
    */
-  void outputCaptureMap(magnet::xml::XmlStream&) const;
+  void outputCaptureMap(magnet::xml::XmlStream&, const dynamo::SimData*) const;
 
   //! \brief Add a pair of particles to the capture map.
   void addToCaptureMap(const Particle& p1, const Particle& p2) const
@@ -142,16 +188,20 @@ protected:
 class IMultiCapture: public ICapture
 {
 public:
-  IMultiCapture(): noXmlLoad(true) {}
+  IMultiCapture(): captureMap(cMapKey()) {}
 
   size_t getTotalCaptureCount() const { return captureMap.size(); }
   
   virtual bool isCaptured(const Particle& p1, const Particle& p2) const
   { return captureMap.count(cMapKey(p1.getID(), p2.getID())); }
 
+  virtual void initCaptureMap(const dynamo::SimData*);
+
+  virtual void remapCaptureMap(const std::vector<size_t>&);
+
 protected:
   
-  typedef std::tr1::unordered_map<cMapKey, int, boost::hash<cMapKey> > captureMapType;
+  typedef magnet::containers::OpenHashMap<cMapKey, int, cMapKeyHash> captureMapType;
   typedef captureMapType::iterator cmap_it;
   typedef captureMapType::const_iterator const_cmap_it;
 
@@ -159,13 +209,9 @@ protected:
 
   virtual int captureTest(const Particle&, const Particle&) const = 0;
 
-  bool noXmlLoad;
-
-  void initCaptureMap(const std::vector<Particle>& particleList);
-
-  void loadCaptureMap(const magnet::xml::Node&);
+  void loadCaptureMap(const magnet::xml::Node&, const dynamo::SimData*);
 
-  void outputCaptureMap(magnet::xml::XmlStream&) const;
+  void outputCaptureMap(magnet::xml::XmlStream&, const dynamo::SimData*) const;
 
   inline cmap_it getCMap_it(const Particle& p1, const Particle& p2) const
   { return captureMap.find(cMapKey(p1.getID(), p2.getID())); }
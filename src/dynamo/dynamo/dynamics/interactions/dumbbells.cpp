@@ -41,8 +41,6 @@ void
 IDumbbells::initialise(size_t nID)
 {
   ID = nID; 
-  
-  ISingleCapture::initCaptureMap(Sim->particleList);
 }
 
 void 
@@ -62,7 +60,7 @@ IDumbbells::operator<<(const magnet::xml::Node& XML)
       _diameter = Sim->_properties.getProperty(XML.getAttribute("Diameter"),
 					       Property::Units::Length());
       intName = XML.getAttribute("Name");
-      ISingleCapture::loadCaptureMap(XML);
+      ISingleCapture::loadCaptureMap(XML, Sim);
     }
   catch (boost::bad_lexical_cast &)
     {
@@ -194,9 +192,13 @@ IDumbbells::runEvent(const Particle& p1,
 	
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, 
-		      Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retval);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, 
+			Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retval);
+	}
 
 	break;
       }
@@ -239,7 +241,7 @@ IDumbbells::outputXML(magnet::xml::XmlStream& XML) const
       << magnet::xml::attr("Name") << intName
       << range;
 
-  ISingleCapture::outputCaptureMap(XML);
+  ISingleCapture::outputCaptureMap(XML, Sim);
 }
 
 bool 
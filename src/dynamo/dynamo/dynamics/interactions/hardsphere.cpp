@@ -29,6 +29,7 @@
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cmath>
+#include <algorithm>
 #include <iomanip>
 
 IHardSphere::IHardSphere(const magnet::xml::Node& XML, dynamo::SimData* tmp):
@@ -124,6 +125,37 @@ IHardSphere::getEvent(const Particle &p1, const Particle &p2) const
   return IntEvent(p1,p2,HUGE_VAL, NONE, *this);  
 }
 
+void
+IHardSphere::getEvents(const Particle& p1, const size_t* ids, size_t N,
+		       std::vector<IntEvent>& events) const
+{
+#if defined(DYNAMO_DEBUG) || defined(DYNAMO_OverlapTesting)
+  //Use getEvent, as it carries out the checks
+  Interaction::getEvents(p1, ids, N, events);
+#else
+  const size_t blockSize = 32;
+  double d2[blockSize], dt[blockSize];
+  const double diameter1 = _diameter->getProperty(p1.getID());
+
+  for (size_t start(0); start < N; start += blockSize)
+    {
+      const size_t n = std::min(N - start, blockSize);
+      for (size_t i(0); i < n; ++i)
+	{
+	  d2[i] = (diameter1 + _diameter->getProperty(ids[start + i])) * 0.5;
+	  d2[i] *= d2[i];
+	}
+
+      Sim->dynamics.getLiouvillean().SphereSphereInRoots(p1, ids + start, d2, dt, n);
+
+      for (size_t i(0); i < n; ++i)
+	if (dt[i] != HUGE_VAL)
+	  events.push_back(IntEvent(p1, Sim->particleList[ids[start + i]], 
+				    dt[i], CORE, *this));
+    }
+#endif
+}
+
 void
 IHardSphere::runEvent(const Particle& p1,
 		      const Particle& p2,
@@ -146,8 +178,12 @@ IHardSphere::runEvent(const Particle& p1,
   //Now we're past the event, update the scheduler and plugins
   Sim->ptrScheduler->fullUpdate(p1, p2);
   
-  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-    Ptr->eventUpdate(iEvent,EDat);
+  {
+    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					dynamo::EventProfile::OUTPUT);
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+      Ptr->eventUpdate(iEvent,EDat);
+  }
 }
    
 void 
@@ -54,6 +54,9 @@ public:
   virtual Interaction* Clone() const;
   
   virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+  virtual void getEvents(const Particle&, const size_t*, size_t,
+			 std::vector<IntEvent>&) const;
  
   virtual void runEvent(const Particle&, const Particle&, const IntEvent&) const;
    
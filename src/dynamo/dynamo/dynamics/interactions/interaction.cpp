@@ -28,6 +28,18 @@ Interaction::Interaction(dynamo::SimData* tmp, C2Range* nR):
   range(nR)
 {}
 
+void
+Interaction::getEvents(const Particle& p1, const size_t* ids, size_t N,
+		       std::vector<IntEvent>& events) const
+{
+  for (size_t i(0); i < N; ++i)
+    {
+      const IntEvent event(getEvent(p1, Sim->particleList[ids[i]]));
+      if (event.getType() != NONE)
+	events.push_back(event);
+    }
+}
+
 bool 
 Interaction::isInteraction(const IntEvent &coll) const
 { 
@@ -21,6 +21,7 @@
 #include "../ranges/2range.hpp"
 #include <magnet/cloneptr.hpp>
 #include <string>
+#include <vector>
 
 class PairEventData;
 class IntEvent;
@@ -49,6 +50,16 @@ public:
   virtual IntEvent getEvent(const Particle &, 
 			     const Particle &) const = 0;
 
+  /*! \brief Calculate the events of a particle with a batch of
+   * particles.
+   *
+   * The events which occur (type != NONE) are appended to events. The
+   * default calls getEvent() on each pair, Interactions override
+   * this to use the batched Liouvillean functions.
+   */
+  virtual void getEvents(const Particle& p1, const size_t* ids, size_t N,
+			 std::vector<IntEvent>& events) const;
+
   //! Run the dynamics of an event that is occuring now.
   virtual void runEvent(const Particle&, const Particle&, const IntEvent&) const = 0;
 
@@ -40,8 +40,6 @@ void
 ILines::initialise(size_t nID)
 {
   ID = nID; 
-  
-  ISingleCapture::initCaptureMap(Sim->particleList);
 }
 
 void 
@@ -59,7 +57,7 @@ ILines::operator<<(const magnet::xml::Node& XML)
       _e = Sim->_properties.getProperty(XML.getAttribute("Elasticity"),
 					Property::Units::Dimensionless());
       intName = XML.getAttribute("Name");
-      ISingleCapture::loadCaptureMap(XML);   
+      ISingleCapture::loadCaptureMap(XML, Sim);   
     }
   catch (boost::bad_lexical_cast &)
     {
@@ -143,9 +141,13 @@ ILines::runEvent(const Particle& p1,
 	
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, 
-		      Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retval);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, 
+			Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retval);
+	}
 
 	break;
       }
@@ -187,7 +189,7 @@ ILines::outputXML(magnet::xml::XmlStream& XML) const
       << magnet::xml::attr("Name") << intName
       << range;
 
-  ISingleCapture::outputCaptureMap(XML);
+  ISingleCapture::outputCaptureMap(XML, Sim);
 }
 
 bool 
@@ -144,8 +144,12 @@ IRotatedParallelCubes::runEvent(const Particle& p1,
   //Now we're past the event, update the scheduler and plugins
   Sim->ptrScheduler->fullUpdate(p1, p2);
   
-  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-    Ptr->eventUpdate(iEvent,EDat);
+  {
+    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					dynamo::EventProfile::OUTPUT);
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+      Ptr->eventUpdate(iEvent,EDat);
+  }
 }
    
 void 
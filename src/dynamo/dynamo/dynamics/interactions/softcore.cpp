@@ -53,7 +53,7 @@ ISoftCore::operator<<(const magnet::xml::Node& XML)
     _wellDepth = Sim->_properties.getProperty(XML.getAttribute("Elasticity"),
 					      Property::Units::Energy());
     intName = XML.getAttribute("Name");
-    ISingleCapture::loadCaptureMap(XML);   
+    ISingleCapture::loadCaptureMap(XML, Sim);   
   }
   catch (boost::bad_lexical_cast &)
     { M_throw() << "Failed a lexical cast in CISoftCore"; }
@@ -71,7 +71,6 @@ void
 ISoftCore::initialise(size_t nID)
 {
   ID = nID;
-  ISingleCapture::initCaptureMap(Sim->particleList);
 }
 
 double 
@@ -174,8 +173,12 @@ ISoftCore::runEvent(const Particle& p1, const Particle& p2, const IntEvent& iEve
 	Sim->signalParticleUpdate(retVal);
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 
 
 	break;
@@ -193,9 +196,13 @@ ISoftCore::runEvent(const Particle& p1, const Particle& p2, const IntEvent& iEve
 	//Now we're past the event, update the scheduler and plugins
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, 
-		      Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, 
+			Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 
 	break;
       }
@@ -242,7 +249,7 @@ ISoftCore::outputXML(magnet::xml::XmlStream& XML) const
       << magnet::xml::attr("Name") << intName
       << range;
   
-  ISingleCapture::outputCaptureMap(XML);  
+  ISingleCapture::outputCaptureMap(XML, Sim);  
 }
 
 double 
@@ -250,7 +257,7 @@ ISoftCore::getInternalEnergy() const
 { 
   //Once the capture maps are loaded just iterate through that determining energies
   double Energy = 0.0;
-  typedef std::pair<size_t, size_t> locpair;
+  typedef cMapKey locpair;
 
   BOOST_FOREACH(const locpair& IDs, captureMap)
     Energy += 0.5 * (_wellDepth->getProperty(IDs.first)
@@ -31,6 +31,7 @@
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <cmath>
+#include <algorithm>
 #include <iomanip>
 
 ISquareWell::ISquareWell(const magnet::xml::Node& XML, dynamo::SimData* tmp):
@@ -61,7 +62,7 @@ ISquareWell::operator<<(const magnet::xml::Node& XML)
     else
       _e = Sim->_properties.getProperty(1.0, Property::Units::Dimensionless());
     intName = XML.getAttribute("Name");
-    ISingleCapture::loadCaptureMap(XML);   
+    ISingleCapture::loadCaptureMap(XML, Sim);   
   }
   catch (boost::bad_lexical_cast &)
     {
@@ -101,7 +102,6 @@ void
 ISquareWell::initialise(size_t nID)
 {
   ID = nID;
-  ISingleCapture::initCaptureMap(Sim->particleList);
 }
 
 bool 
@@ -215,6 +215,76 @@ ISquareWell::getEvent(const Particle &p1,
   return retval;
 }
 
+void
+ISquareWell::getEvents(const Particle& p1, const size_t* ids, size_t N,
+		       std::vector<IntEvent>& events) const
+{
+#if defined(DYNAMO_DEBUG) || defined(DYNAMO_OverlapTesting)
+  //Use getEvent, as it carries out the checks
+  Interaction::getEvents(p1, ids, N, events);
+#else
+  const size_t blockSize = 32;
+  //The captured pairs test their core, the others their well, so
+  //one batch of in roots covers both
+  double inD2[blockSize], inDt[blockSize];
+  //The captured pairs also test for leaving the well
+  size_t capturedIDs[blockSize];
+  double outD2[blockSize], outDt[blockSize];
+  bool captured[blockSize];
+
+  const double diameter1 = _diameter->getProperty(p1.getID());
+  const double lambda1 = _lambda->getProperty(p1.getID());
+
+  for (size_t start(0); start < N; start += blockSize)
+    {
+      const size_t n = std::min(N - start, blockSize);
+      size_t nCaptured(0);
+
+      for (size_t i(0); i < n; ++i)
+	{
+	  const size_t& ID = ids[start + i];
+	  const double d = (diameter1 + _diameter->getProperty(ID)) * 0.5;
+	  const double l = (lambda1 + _lambda->getProperty(ID)) * 0.5;
+	  const double ld2 = d * l * d * l;
+
+	  captured[i] = isCaptured(p1, Sim->particleList[ID]);
+	  if (captured[i])
+	    {
+	      inD2[i] = d * d;
+	      capturedIDs[nCaptured] = ID;
+	      outD2[nCaptured] = ld2;
+	      ++nCaptured;
+	    }
+	  else
+	    inD2[i] = ld2;
+	}
+
+      const Liouvillean& liouvillean(Sim->dynamics.getLiouvillean());
+      liouvillean.SphereSphereInRoots(p1, ids + start, inD2, inDt, n);
+      liouvillean.SphereSphereOutRoots(p1, capturedIDs, outD2, outDt, nCaptured);
+
+      for (size_t i(0), j(0); i < n; ++i)
+	{
+	  const Particle& p2(Sim->particleList[ids[start + i]]);
+
+	  if (!captured[i])
+	    {
+	      if (inDt[i] != HUGE_VAL)
+		events.push_back(IntEvent(p1, p2, inDt[i], WELL_IN, *this));
+	      continue;
+	    }
+
+	  //As in getEvent, the core wins a tie
+	  if (outDt[j] < inDt[i])
+	    events.push_back(IntEvent(p1, p2, outDt[j], WELL_OUT, *this));
+	  else if (inDt[i] != HUGE_VAL)
+	    events.push_back(IntEvent(p1, p2, inDt[i], CORE, *this));
+	  ++j;
+	}
+    }
+#endif
+}
+
 void
 ISquareWell::runEvent(const Particle& p1, 
 		       const Particle& p2,
@@ -244,8 +314,12 @@ ISquareWell::runEvent(const Particle& p1,
 	
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 
 	break;
       }
@@ -260,8 +334,12 @@ ISquareWell::runEvent(const Particle& p1,
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	Sim->signalParticleUpdate(retVal);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 
 
 	break;
@@ -278,8 +356,12 @@ ISquareWell::runEvent(const Particle& p1,
 
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 	break;
       }
     default:
@@ -348,7 +430,7 @@ ISquareWell::outputXML(magnet::xml::XmlStream& XML) const
       << magnet::xml::attr("Name") << intName
       << range;
   
-  ISingleCapture::outputCaptureMap(XML);  
+  ISingleCapture::outputCaptureMap(XML, Sim);  
 }
 
 double 
@@ -356,7 +438,7 @@ ISquareWell::getInternalEnergy() const
 { 
   //Once the capture maps are loaded just iterate through that determining energies
   double Energy = 0.0;
-  typedef std::pair<size_t, size_t> locpair;
+  typedef cMapKey locpair;
 
   BOOST_FOREACH(const locpair& IDs, captureMap)
     Energy += 0.5 * (_wellDepth->getProperty(IDs.first)
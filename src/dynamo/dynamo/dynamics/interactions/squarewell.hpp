@@ -59,6 +59,9 @@ public:
   virtual void initialise(size_t);
 
   virtual IntEvent getEvent(const Particle&, const Particle&) const;
+
+  virtual void getEvents(const Particle&, const size_t*, size_t,
+			 std::vector<IntEvent>&) const;
   
   virtual void runEvent(const Particle&, const Particle&, const IntEvent&) const;
   
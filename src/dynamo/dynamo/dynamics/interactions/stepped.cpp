@@ -79,7 +79,7 @@ IStepped::operator<<(const magnet::xml::Node& XML)
     
     std::sort(steps.rbegin(), steps.rend());
 
-    IMultiCapture::loadCaptureMap(XML);
+    IMultiCapture::loadCaptureMap(XML, Sim);
   }
   catch (boost::bad_lexical_cast &)
     {
@@ -123,12 +123,6 @@ void
 IStepped::initialise(size_t nID)
 {
   ID = nID;
-  IMultiCapture::initCaptureMap(Sim->particleList);
-  
-  dout << "Buckets in captureMap " << captureMap.bucket_count()
-	   << "\nMax bucket count " << captureMap.max_bucket_count()
-	   << "\nload Factor " << captureMap.load_factor()
-	   << "\nMax load Factor " << captureMap.max_load_factor() << std::endl;
 }
 
 int 
@@ -153,7 +147,7 @@ IStepped::getInternalEnergy() const
   //Once the capture maps are loaded just iterate through that determining energies
   double Energy = 0.0;
 
-  typedef std::pair<const std::pair<size_t, size_t>, int> locpair;
+  typedef captureMapType::value_type locpair;
 
   BOOST_FOREACH(const locpair& IDs, captureMap)
     Energy += steps[IDs.second - 1].second 
@@ -294,8 +288,12 @@ IStepped::runEvent(const Particle& p1,
 
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 	break;
       }
     case WELL_IN:
@@ -329,8 +327,12 @@ IStepped::runEvent(const Particle& p1,
 	
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 	    
 	break;
       }
@@ -363,5 +365,5 @@ IStepped::outputXML(magnet::xml::XmlStream& XML) const
 	<< magnet::xml::attr("E") << s.second
 	<< magnet::xml::endtag("Step");
   
-  IMultiCapture::outputCaptureMap(XML);  
+  IMultiCapture::outputCaptureMap(XML, Sim);  
 }
@@ -71,7 +71,7 @@ ISWSequence::outputXML(magnet::xml::XmlStream& XML) const
   XML << magnet::xml::endtag("Alphabet");
 
   
-  ISingleCapture::outputCaptureMap(XML);  
+  ISingleCapture::outputCaptureMap(XML, Sim);  
 }
 
 void 
@@ -95,7 +95,7 @@ ISWSequence::operator<<(const magnet::xml::Node& XML)
       _e = Sim->_properties.getProperty(1.0, Property::Units::Dimensionless());
 
     intName = XML.getAttribute("Name");
-    ISingleCapture::loadCaptureMap(XML);
+    ISingleCapture::loadCaptureMap(XML, Sim);
 
     //Load the sequence
     sequence.clear();
@@ -159,7 +159,7 @@ ISWSequence::getInternalEnergy() const
 { 
   //Once the capture maps are loaded just iterate through that determining energies
   double Energy = 0.0;
-  typedef std::pair<size_t, size_t> locpair;
+  typedef cMapKey locpair;
 
   BOOST_FOREACH(const locpair& IDs, captureMap)
     Energy += alphabet
@@ -197,7 +197,6 @@ void
 ISWSequence::initialise(size_t nID)
 {
   ID = nID;
-  ISingleCapture::initCaptureMap(Sim->particleList);
 }
 
 bool 
@@ -338,8 +337,12 @@ ISWSequence::runEvent(const Particle& p1,
 	
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 
 	break;
       }
@@ -360,8 +363,12 @@ ISWSequence::runEvent(const Particle& p1,
 
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 
 	break;
       }
@@ -382,8 +389,12 @@ ISWSequence::runEvent(const Particle& p1,
 
 	Sim->ptrScheduler->fullUpdate(p1, p2);
 	
-	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
-	  Ptr->eventUpdate(iEvent, retVal);
+	{
+	  dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					      dynamo::EventProfile::OUTPUT);
+	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, Sim->outputPlugins)
+	    Ptr->eventUpdate(iEvent, retVal);
+	}
 
 	break;
       }
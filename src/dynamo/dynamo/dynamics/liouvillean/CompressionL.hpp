@@ -25,6 +25,15 @@ public:
 
   virtual bool SphereSphereInRoot(CPDData&, const double&, bool p1Dynamic, bool p2Dynamic) const;
   virtual bool SphereSphereOutRoot(CPDData&, const double&, bool p1Dynamic, bool p2Dynamic) const;  
+
+  //These must use the per-pair roots above, not the LNewtonian kernels
+  virtual void SphereSphereInRoots(const Particle& p1, const size_t* ids, 
+				   const double* d2, double* dt, size_t N) const
+  { Liouvillean::SphereSphereInRoots(p1, ids, d2, dt, N); }
+
+  virtual void SphereSphereOutRoots(const Particle& p1, const size_t* ids, 
+				    const double* d2, double* dt, size_t N) const
+  { Liouvillean::SphereSphereOutRoots(p1, ids, d2, dt, N); }
   virtual bool sphereOverlap(const CPDData&, const double&) const;
 
   virtual PairEventData SmoothSpheresColl(const IntEvent&, const double&, const double&, const EEventType&) const;
@@ -38,6 +38,10 @@
 #include <magnet/math/matrix.hpp>
 #include <magnet/xmlwriter.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <algorithm>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
 
 bool 
 LNewtonian::CubeCubeInRoot(CPDData& dat, const double& d) const
@@ -134,6 +138,141 @@ LNewtonian::SphereSphereOutRoot(CPDData& dat, const double& d2, bool, bool) cons
   return true;
 }
 
+namespace {
+  /*! \brief The pair data of a block of a batch of sphere roots.
+   *
+   * The batch is processed in blocks small enough to live on the
+   * stack, so the kernels are thread safe and never allocate.
+   */
+  struct SpherePairBlock
+  {
+    static const size_t Size = 32;
+    double rvdot[Size];
+    double r2[Size];
+    double v2[Size];
+  };
+
+  //! Gather the same pair data as CPDData for a block of the batch.
+  inline void gatherSpherePairs(const dynamo::SimData& Sim, const Particle& p1,
+				const size_t* ids, size_t N, SpherePairBlock& block)
+  {
+    for (size_t i(0); i < N; ++i)
+      {
+	const Particle& p2(Sim.particleList[ids[i]]);
+	Vector rij = p1.getPosition() - p2.getPosition(),
+	  vij = p1.getVelocity() - p2.getVelocity();
+
+	Sim.dynamics.BCs().applyBC(rij, vij);
+
+	block.rvdot[i] = rij | vij;
+	block.r2[i] = rij.nrm2();
+	block.v2[i] = vij.nrm2();
+      }
+  }
+
+  //! The scalar form of LNewtonian::SphereSphereInRoot.
+  inline double sphereInRoot(double rvdot, double r2, double v2, double d2)
+  {
+    if (rvdot >= 0) return HUGE_VAL;
+    
+    //If the spheres overlap (r2 <= d2) this root is zero
+    double arg = rvdot * rvdot - v2 * (r2 - d2);
+    if (arg < 0) return HUGE_VAL;
+    
+    return std::max(0.0, (d2 - r2) / (rvdot - std::sqrt(arg)));
+  }
+
+  //! The scalar form of LNewtonian::SphereSphereOutRoot.
+  inline double sphereOutRoot(double rvdot, double r2, double v2, double d2)
+  {
+    if (v2 == 0) return HUGE_VAL;
+
+    double arg = rvdot * rvdot - v2 * (r2 - d2);
+    double dt = (arg < 0) ? (- rvdot / v2) : ((std::sqrt(arg) - rvdot) / v2);
+    return std::max(dt, 0.0);
+  }
+
+#ifdef __SSE2__
+  //! Select a where mask is set, and b elsewhere.
+  inline __m128d select(__m128d mask, __m128d a, __m128d b)
+  { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+#endif
+}
+
+void
+LNewtonian::SphereSphereInRoots(const Particle& p1, const size_t* ids, 
+				const double* d2, double* dt, size_t N) const
+{
+  SpherePairBlock block;
+  for (size_t start(0); start < N; start += SpherePairBlock::Size)
+    {
+      const size_t n = std::min(N - start, SpherePairBlock::Size);
+      gatherSpherePairs(*Sim, p1, ids + start, n, block);
+
+      size_t i(0);
+#ifdef __SSE2__
+      //The branches of sphereInRoot are replaced by masks, so two
+      //pairs are solved at once
+      const __m128d zero = _mm_setzero_pd(), huge = _mm_set1_pd(HUGE_VAL);
+      for (; i + 2 <= n; i += 2)
+	{
+	  const __m128d rvdot = _mm_loadu_pd(block.rvdot + i), 
+	    r2 = _mm_loadu_pd(block.r2 + i),
+	    v2 = _mm_loadu_pd(block.v2 + i),
+	    sd2 = _mm_loadu_pd(d2 + start + i);
+	  
+	  const __m128d arg = _mm_sub_pd(_mm_mul_pd(rvdot, rvdot), 
+					 _mm_mul_pd(v2, _mm_sub_pd(r2, sd2)));
+	  const __m128d root 
+	    = _mm_max_pd(_mm_div_pd(_mm_sub_pd(sd2, r2), 
+				    _mm_sub_pd(rvdot, _mm_sqrt_pd(_mm_max_pd(arg, zero)))),
+			 zero);
+	  const __m128d valid = _mm_and_pd(_mm_cmplt_pd(rvdot, zero), 
+					   _mm_cmpge_pd(arg, zero));
+	  _mm_storeu_pd(dt + start + i, select(valid, root, huge));
+	}
+#endif
+      for (; i < n; ++i)
+	dt[start + i] = sphereInRoot(block.rvdot[i], block.r2[i], block.v2[i], d2[start + i]);
+    }
+}
+
+void
+LNewtonian::SphereSphereOutRoots(const Particle& p1, const size_t* ids, 
+				 const double* d2, double* dt, size_t N) const
+{
+  SpherePairBlock block;
+  for (size_t start(0); start < N; start += SpherePairBlock::Size)
+    {
+      const size_t n = std::min(N - start, SpherePairBlock::Size);
+      gatherSpherePairs(*Sim, p1, ids + start, n, block);
+
+      size_t i(0);
+#ifdef __SSE2__
+      const __m128d zero = _mm_setzero_pd(), huge = _mm_set1_pd(HUGE_VAL);
+      for (; i + 2 <= n; i += 2)
+	{
+	  const __m128d rvdot = _mm_loadu_pd(block.rvdot + i), 
+	    r2 = _mm_loadu_pd(block.r2 + i),
+	    v2 = _mm_loadu_pd(block.v2 + i),
+	    sd2 = _mm_loadu_pd(d2 + start + i);
+
+	  const __m128d arg = _mm_sub_pd(_mm_mul_pd(rvdot, rvdot), 
+					 _mm_mul_pd(v2, _mm_sub_pd(r2, sd2)));
+	  //Both roots are calculated, the pairs with v2 == 0 are
+	  //masked out at the end
+	  const __m128d closest = _mm_div_pd(_mm_sub_pd(zero, rvdot), v2);
+	  const __m128d exit = _mm_div_pd(_mm_sub_pd(_mm_sqrt_pd(_mm_max_pd(arg, zero)), rvdot), v2);
+	  const __m128d root = _mm_max_pd(select(_mm_cmplt_pd(arg, zero), closest, exit), zero);
+
+	  _mm_storeu_pd(dt + start + i, select(_mm_cmpneq_pd(v2, zero), root, huge));
+	}
+#endif
+      for (; i < n; ++i)
+	dt[start + i] = sphereOutRoot(block.rvdot[i], block.r2[i], block.v2[i], d2[start + i]);
+    }
+}
+
 bool 
 LNewtonian::sphereOverlap(const CPDData& dat, const double& d2) const
 {
@@ -188,6 +327,17 @@ LNewtonian::streamParticle(Particle &particle, const double &dt) const
       * Vector(orientationData[particle.getID()].orientation); 
 }
 
+void
+LNewtonian::streamAllParticles() const
+{
+  //The qualified call lets the compiler inline the streaming
+  BOOST_FOREACH(Particle& part, Sim->particleList)
+    {
+      LNewtonian::streamParticle(part, part.getPecTime() + partPecTime);
+      part.getPecTime() = 0;
+    }
+}
+
 double 
 LNewtonian::getWallCollision(const Particle& part, 
 			     const Vector& wallLoc, 
@@ -36,6 +36,11 @@ public:
   //Pair particle dynamics
   virtual bool SphereSphereInRoot(CPDData&, const double&, bool p1Dynamic, bool p2Dynamic) const;
   virtual bool SphereSphereOutRoot(CPDData&, const double&, bool p1Dynamic, bool p2Dynamic) const;  
+
+  virtual void SphereSphereInRoots(const Particle&, const size_t*, const double*, 
+				   double*, size_t) const;
+  virtual void SphereSphereOutRoots(const Particle&, const size_t*, const double*, 
+				    double*, size_t) const;
   virtual bool sphereOverlap(const CPDData&, const double&) const;
 
   virtual bool CubeCubeInRoot(CPDData&, const double&) const;
@@ -44,6 +49,8 @@ public:
 
   virtual void streamParticle(Particle&, const double&) const;
 
+  virtual void streamAllParticles() const;
+
   virtual double getSquareCellCollision2(const Particle&, 
 				       const Vector &, 
 				       const Vector &
@@ -92,6 +92,17 @@ LNewtonianGravity::streamParticle(Particle &particle, const double &dt) const
   particle.getVelocity() += dt * g * isDynamic;
 }
 
+void
+LNewtonianGravity::streamAllParticles() const
+{
+  //The qualified call lets the compiler inline the streaming
+  BOOST_FOREACH(Particle& part, Sim->particleList)
+    {
+      LNewtonianGravity::streamParticle(part, part.getPecTime() + partPecTime);
+      part.getPecTime() = 0;
+    }
+}
+
 bool 
 LNewtonianGravity::SphereSphereInRoot(CPDData& dat, const double& d2, 
 				      bool p1Dynamic, bool p2Dynamic) const
@@ -37,6 +37,17 @@ LSLLOD::streamParticle(Particle& particle, const double& dt) const
     particle.getVelocity()[0] += particle.getVelocity()[1] * dt;
 }
 
+void
+LSLLOD::streamAllParticles() const
+{
+  //The qualified call lets the compiler inline the streaming
+  BOOST_FOREACH(Particle& part, Sim->particleList)
+    {
+      LSLLOD::streamParticle(part, part.getPecTime() + partPecTime);
+      part.getPecTime() = 0;
+    }
+}
+
 bool 
 LSLLOD::DSMCSpheresTest(const Particle& p1, 
 			 const Particle& p2, 
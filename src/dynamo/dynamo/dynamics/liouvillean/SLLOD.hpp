@@ -39,6 +39,8 @@ public:
 
   virtual void streamParticle(Particle&, const double&) const;
 
+  virtual void streamAllParticles() const;
+
   virtual double getSquareCellCollision2(const Particle&, 
 				       const Vector &, 
 				       const Vector &
@@ -18,6 +18,7 @@
 #include <dynamo/dynamics/liouvillean/include.hpp>
 #include <dynamo/dynamics/species/inertia.hpp>
 #include <dynamo/base/is_simdata.hpp>
+#include <dynamo/base/binaryconfig.hpp>
 #include <dynamo/dynamics/2particleEventData.hpp>
 #include <dynamo/dynamics/units/units.hpp>
 #include <dynamo/datatypes/vector.xml.hpp>
@@ -26,6 +27,39 @@
 #include <magnet/xmlreader.hpp>
 #include <boost/foreach.hpp>
 
+namespace {
+  //! \brief The element of the "Particles" block of a binary configuration file.
+  struct BinaryParticle
+  {
+    double position[NDIM];
+    double velocity[NDIM];
+    uint64_t isStatic;
+  };
+
+  //! \brief The element of the "Orientation" block of a binary configuration file.
+  struct BinaryOrientation
+  {
+    double orientation[NDIM];
+    double angularVelocity[NDIM];
+  };
+
+  //! \brief The element of the "Exact/Particles" block of an exact checkpoint.
+  struct ExactParticle
+  {
+    double position[NDIM];
+    double velocity[NDIM];
+    double pecTime;
+    uint64_t state;
+  };
+
+  //! \brief The "Exact/Liouvillean" block of an exact checkpoint.
+  struct ExactLiouvillean
+  {
+    double partPecTime;
+    uint64_t streamCount;
+  };
+}
+
 magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream& XML, const Liouvillean& g)
 {
   g.outputXML(XML);
@@ -107,6 +141,66 @@ Liouvillean::loadParticleXMLData(const magnet::xml::Node& XML)
 {
   dout << "Loading Particle Data" << std::endl;
 
+  if (XML.getNode("ParticleData").hasAttribute("Binary"))
+    {
+      if (Sim->binaryReader == NULL)
+	M_throw() << "The ParticleData is stored in a binary configuration file,"
+		  << " but the configuration was not loaded from one";
+
+      const dynamo::BinaryConfigReader& file = *Sim->binaryReader;
+
+      size_t block = file.findBlock("Particles");
+      const BinaryParticle* particles = file.getBlock<BinaryParticle>(block);
+      Sim->N = file.getCount(block);
+
+      Sim->particleList.reserve(Sim->N);
+      for (size_t i(0); i < Sim->N; ++i)
+	{
+	  Vector pos, vel;
+	  for (size_t iDim(0); iDim < NDIM; ++iDim)
+	    {
+	      pos[iDim] = particles[i].position[iDim];
+	      vel[iDim] = particles[i].velocity[iDim];
+	    }
+
+	  Particle part(pos, vel, i);
+	  part.getVelocity() *= Sim->dynamics.units().unitVelocity();
+	  part.getPosition() *= Sim->dynamics.units().unitLength();
+	  if (particles[i].isStatic) part.clearState(Particle::DYNAMIC);
+	  Sim->particleList.push_back(part);
+	}
+
+      dout << "Particle count " << Sim->N << std::endl;
+
+      if (XML.getNode("ParticleData").hasAttribute("OrientationData"))
+	{
+	  block = file.findBlock("Orientation");
+	  if (file.getCount(block) != Sim->N)
+	    M_throw() << "The Orientation block has " << file.getCount(block)
+		      << " entries, but there are " << Sim->N << " particles";
+
+	  const BinaryOrientation* data = file.getBlock<BinaryOrientation>(block);
+	  orientationData.resize(Sim->N);
+	  for (size_t i(0); i < Sim->N; ++i)
+	    {
+	      for (size_t iDim(0); iDim < NDIM; ++iDim)
+		{
+		  orientationData[i].orientation[iDim] = data[i].orientation[iDim];
+		  orientationData[i].angularVelocity[iDim] = data[i].angularVelocity[iDim];
+		}
+
+	      //The orientations were normalised when they were written
+	      //out. They are not normalised again as that would alter
+	      //the last bits and a restart would not be exact.
+	      if (!(orientationData[i].orientation.nrm() > 0.0))
+		M_throw() << "Particle ID " << i
+			  << " orientation vector is zero!";
+	    }
+	}
+
+      return;
+    }
+
   bool outofsequence = false;  
   
   for (magnet::xml::Node node = XML.getNode("ParticleData").fastGetNode("Pt"); 
@@ -160,6 +254,53 @@ Liouvillean::outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) co
   if (hasOrientationData())
     XML << magnet::xml::attr("OrientationData") << "Y";
 
+  if (Sim->binaryWriter != NULL)
+    {
+      dynamo::BinaryConfigWriter& file = *Sim->binaryWriter;
+
+      file.beginBlock("Particles", sizeof(BinaryParticle));
+      for (size_t i = 0; i < Sim->N; ++i)
+	{
+	  Particle tmp(Sim->particleList[i]);
+	  if (applyBC) 
+	    Sim->dynamics.BCs().applyBC(tmp.getPosition(), tmp.getVelocity());
+      
+	  tmp.getVelocity() *= (1.0 / Sim->dynamics.units().unitVelocity());
+	  tmp.getPosition() *= (1.0 / Sim->dynamics.units().unitLength());
+
+	  BinaryParticle data;
+	  for (size_t iDim(0); iDim < NDIM; ++iDim)
+	    {
+	      data.position[iDim] = tmp.getPosition()[iDim];
+	      data.velocity[iDim] = tmp.getVelocity()[iDim];
+	    }
+	  data.isStatic = !tmp.testState(Particle::DYNAMIC);
+	  file.write(data);
+	}
+      file.endBlock();
+
+      if (hasOrientationData())
+	{
+	  file.beginBlock("Orientation", sizeof(BinaryOrientation));
+	  for (size_t i = 0; i < Sim->N; ++i)
+	    {
+	      BinaryOrientation data;
+	      for (size_t iDim(0); iDim < NDIM; ++iDim)
+		{
+		  data.orientation[iDim] = orientationData[i].orientation[iDim];
+		  data.angularVelocity[iDim] = orientationData[i].angularVelocity[iDim];
+		}
+	      file.write(data);
+	    }
+	  file.endBlock();
+	}
+
+      XML << magnet::xml::attr("N") << Sim->N
+	  << magnet::xml::attr("Binary") << "Y"
+	  << magnet::xml::endtag("ParticleData");
+      return;
+    }
+
   for (size_t i = 0; i < Sim->N; ++i)
     {
       Particle tmp(Sim->particleList[i]);
@@ -187,6 +328,90 @@ Liouvillean::outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) co
   XML << magnet::xml::endtag("ParticleData");
 }
 
+void
+Liouvillean::outputExactState(dynamo::BinaryConfigWriter& file) const
+{
+  ExactLiouvillean state;
+  state.partPecTime = partPecTime;
+  state.streamCount = streamCount;
+  file.writeValue("Exact/Liouvillean", state);
+
+  file.beginBlock("Exact/Particles", sizeof(ExactParticle));
+  BOOST_FOREACH(const Particle& part, Sim->particleList)
+    {
+      ExactParticle data;
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	{
+	  data.position[iDim] = part.getPosition()[iDim];
+	  data.velocity[iDim] = part.getVelocity()[iDim];
+	}
+      data.pecTime = part.getPecTime();
+      data.state = (part.testState(Particle::DYNAMIC) ? Particle::DYNAMIC : 0)
+	| (part.testState(Particle::ALIVE) ? Particle::ALIVE : 0);
+      file.write(data);
+    }
+  file.endBlock();
+
+  if (hasOrientationData())
+    {
+      file.beginBlock("Exact/Orientation", sizeof(BinaryOrientation));
+      BOOST_FOREACH(const rotData& rdat, orientationData)
+	{
+	  BinaryOrientation data;
+	  for (size_t iDim(0); iDim < NDIM; ++iDim)
+	    {
+	      data.orientation[iDim] = rdat.orientation[iDim];
+	      data.angularVelocity[iDim] = rdat.angularVelocity[iDim];
+	    }
+	  file.write(data);
+	}
+      file.endBlock();
+    }
+}
+
+void
+Liouvillean::loadExactState(const dynamo::BinaryConfigReader& file)
+{
+  const ExactLiouvillean state = file.readValue<ExactLiouvillean>("Exact/Liouvillean");
+  partPecTime = state.partPecTime;
+  streamCount = state.streamCount;
+
+  size_t block = file.findBlock("Exact/Particles");
+  if (file.getCount(block) != Sim->N)
+    M_throw() << "The checkpoint holds the exact state of " << file.getCount(block)
+	      << " particles, but the configuration has " << Sim->N;
+
+  const ExactParticle* particles = file.getBlock<ExactParticle>(block);
+  for (size_t i = 0; i < Sim->N; ++i)
+    {
+      Particle& part = Sim->particleList[i];
+      for (size_t iDim(0); iDim < NDIM; ++iDim)
+	{
+	  part.getPosition()[iDim] = particles[i].position[iDim];
+	  part.getVelocity()[iDim] = particles[i].velocity[iDim];
+	}
+      part.getPecTime() = particles[i].pecTime;
+      part.clearState(Particle::DEFAULT);
+      part.setState(Particle::State(particles[i].state));
+    }
+
+  if (hasOrientationData())
+    {
+      block = file.findBlock("Exact/Orientation");
+      if (file.getCount(block) != Sim->N)
+	M_throw() << "The checkpoint holds the orientations of " << file.getCount(block)
+		  << " particles, but the configuration has " << Sim->N;
+
+      const BinaryOrientation* data = file.getBlock<BinaryOrientation>(block);
+      for (size_t i = 0; i < Sim->N; ++i)
+	for (size_t iDim(0); iDim < NDIM; ++iDim)
+	  {
+	    orientationData[i].orientation[iDim] = data[i].orientation[iDim];
+	    orientationData[i].angularVelocity[iDim] = data[i].angularVelocity[iDim];
+	  }
+    }
+}
+
 double 
 Liouvillean::getParticleKineticEnergy(const Particle& part) const
 {
@@ -212,6 +437,31 @@ Liouvillean::getParticleKineticEnergy(const Particle& part) const
 double 
 Liouvillean::getSystemKineticEnergy() const
 {
+#ifndef DYNAMO_SCALAR_KERNELS
+  //Looking up the species of each particle is far more expensive
+  //than the energy itself, so walk the species instead. The species
+  //are checked to cover each particle exactly once in
+  //Dynamics::initialise.
+  if (!Sim->dynamics.BCTypeTest<BCLeesEdwards>())
+    {
+      const bool rotational = hasOrientationData();
+      double sumEnergy(0);
+
+      BOOST_FOREACH(const magnet::ClonePtr<Species>& sp, Sim->dynamics.getSpecies())
+	BOOST_FOREACH(const unsigned long& ID, *sp->getRange())
+	  {
+	    sumEnergy += Sim->particleList[ID].getVelocity().nrm2() 
+	      * sp->getMass(ID);
+
+	    if (rotational)
+	      sumEnergy += orientationData[ID].angularVelocity.nrm2()
+		* sp->getScalarMomentOfInertia(ID);
+	  }
+
+      return 0.5 * sumEnergy;
+    }
+#endif
+
   double sumEnergy(0);
 
   BOOST_FOREACH(const Particle& part, Sim->particleList)
@@ -220,6 +470,18 @@ Liouvillean::getSystemKineticEnergy() const
   return sumEnergy;
 }
 
+void
+Liouvillean::streamAllParticles() const
+{
+  BOOST_FOREACH(const Particle& part, Sim->particleList)
+    {
+      streamParticle(const_cast<Particle&>(part), 
+		     part.getPecTime() + partPecTime);
+	
+      const_cast<Particle&>(part).getPecTime() = 0;
+    }
+}
+
 void
 Liouvillean::rescaleSystemKineticEnergy(const double& scale)
 {
@@ -245,6 +507,36 @@ Liouvillean::rescaleSystemKineticEnergy(const double& scale)
     rdat.angularVelocity *= scalefactor;      
 }
 
+void
+Liouvillean::SphereSphereInRoots(const Particle& p1, const size_t* ids, 
+				 const double* d2, double* dt, size_t N) const
+{
+  for (size_t i(0); i < N; ++i)
+    {
+      const Particle& p2(Sim->particleList[ids[i]]);
+      CPDData colldat(*Sim, p1, p2);
+
+      dt[i] = SphereSphereInRoot(colldat, d2[i], p1.testState(Particle::DYNAMIC), 
+				 p2.testState(Particle::DYNAMIC))
+	? colldat.dt : HUGE_VAL;
+    }
+}
+
+void
+Liouvillean::SphereSphereOutRoots(const Particle& p1, const size_t* ids, 
+				  const double* d2, double* dt, size_t N) const
+{
+  for (size_t i(0); i < N; ++i)
+    {
+      const Particle& p2(Sim->particleList[ids[i]]);
+      CPDData colldat(*Sim, p1, p2);
+
+      dt[i] = SphereSphereOutRoot(colldat, d2[i], p1.testState(Particle::DYNAMIC), 
+				  p2.testState(Particle::DYNAMIC))
+	? colldat.dt : HUGE_VAL;
+    }
+}
+
 PairEventData 
 Liouvillean::parallelCubeColl(const IntEvent& event, 
 			       const double& e, 
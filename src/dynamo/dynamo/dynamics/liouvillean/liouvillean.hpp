@@ -82,20 +82,33 @@ public:
   virtual void swapSystem(Liouvillean& oLiouvillean) {}
 
   /*! \brief Parses the XML data to see if it can load XML particle
-   * data or if it needs to decode the binary data. Then loads the
-   * particle data.
+   * data or if it needs to read the binary data from the blocks of a
+   * binary configuration file (see SimData::binaryReader). Then loads
+   * the particle data.
    *
    * \param XML The root xml::Node of the xml::Document which has the ParticleData tag within.
    */
   virtual void loadParticleXMLData(const magnet::xml::Node& XML);
   
-  /*! \brief Writes the XML particle data, either the base64 header or
-   * the entire XML form.
+  /*! \brief Writes the XML particle data, either the entire XML
+   * form or, if a binary configuration file is being written (see
+   * SimData::binaryWriter), a header referring to the blocks holding
+   * the particle data.
    * \param XML The XMLStream to write the configuration data to.
    * \param applyBC Wether to apply the boundary conditions to the final particle positions before writing them out.
    */
   void outputParticleXMLData(magnet::xml::XmlStream& XML, bool applyBC) const;
 
+  /*! \brief Writes the particle data exactly as it is held in the
+   * simulation, with the delayed states of the particles, to the
+   * "Exact/..." blocks of an exact checkpoint (see
+   * SimData::restartFile).
+   */
+  void outputExactState(dynamo::BinaryConfigWriter&) const;
+
+  //! \brief Restores the particle data written by outputExactState.
+  void loadExactState(const dynamo::BinaryConfigReader&);
+
   /*! \brief Returns the degrees of freedom per particle.
    */
   inline size_t getParticleDOF() const { return NDIM + 2 * hasOrientationData(); }
@@ -157,6 +170,30 @@ public:
    */
   virtual bool SphereSphereOutRoot(CPDData&, const double&, bool p1Dynamic, bool p2Dynamic) const = 0;  
 
+  /*! \brief Determines when a particle will intersect each of a
+   * batch of spheres.
+   *
+   * This is the batched form of SphereSphereInRoot(). The particles
+   * must all be up to date.
+   *
+   * \param p1 The particle to test against the batch.
+   * \param ids The IDs of the N particles in the batch.
+   * \param d2 The square of the interaction distance of each pair.
+   * \param dt The time until each pair intersects is written here,
+   * HUGE_VAL if they never will.
+   */
+  virtual void SphereSphereInRoots(const Particle& p1, const size_t* ids, 
+				   const double* d2, double* dt, size_t N) const;
+
+  /*! \brief Determines when a particle will stop intersecting each
+   * of a batch of spheres.
+   *
+   * This is the batched form of SphereSphereOutRoot(), see
+   * SphereSphereInRoots() for the arguments.
+   */
+  virtual void SphereSphereOutRoots(const Particle& p1, const size_t* ids, 
+				    const double* d2, double* dt, size_t N) const;
+
   /*! \brief Determines if two spheres are overlapping
    *
    * \param pd Some precomputed data about the event that is cached by
@@ -607,13 +644,11 @@ public:
   {
     //May as well take this opportunity to reset the streaming
     //Note: the Replexing coordinator RELIES on this behaviour!
-    BOOST_FOREACH(const Particle& part, Sim->particleList)
-      {
-	streamParticle(const_cast<Particle&>(part), 
-		       part.getPecTime() + partPecTime);
-	
-	const_cast<Particle&>(part).getPecTime() = 0;
-      }
+#ifdef DYNAMO_SCALAR_KERNELS
+    Liouvillean::streamAllParticles();
+#else
+    streamAllParticles();
+#endif
 
     const_cast<double&>(partPecTime) = 0;
     const_cast<size_t&>(streamCount) = 0;
@@ -747,5 +782,15 @@ protected:
   /*! \brief Moves the particles data along in time. */
   virtual void streamParticle(Particle& part, const double& dt) const = 0;
 
+  /*! \brief Moves every particle along by its delay and zeroes its
+   * peculiar time.
+   *
+   * This is the bulk kernel behind updateAllParticles(). The default
+   * calls streamParticle() on each particle, Liouvilleans override it
+   * with a loop free of per-particle virtual calls. Defining
+   * DYNAMO_SCALAR_KERNELS always uses the default.
+   */
+  virtual void streamAllParticles() const;
+
   mutable std::vector<rotData> orientationData;
 };
@@ -71,6 +71,9 @@ public:
 
   inline const size_t& getID() const { return ID; }
 
+  //! \brief The particles this acts on, this may be empty.
+  inline const magnet::ClonePtr<CRange>& getRange() const { return range; }
+
   virtual void checkOverlaps(const Particle&) const  {}
 
 protected:
@@ -32,6 +32,9 @@ public:
 
   virtual bool isInRange(const Particle&, const Particle&) const
   { return false; }
+
+  virtual bool getSingleRanges(std::vector<const CRange*>&) const
+  { return true; }
   
   virtual void operator<<(const magnet::xml::Node&);
   
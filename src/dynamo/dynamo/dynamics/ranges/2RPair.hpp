@@ -31,6 +31,13 @@ public:
   { return new C2RPair(*this); };
 
   virtual bool isInRange(const Particle&, const Particle&) const;
+
+  virtual bool getSingleRanges(std::vector<const CRange*>& ranges) const
+  { 
+    ranges.push_back(range1.get_ptr());
+    ranges.push_back(range2.get_ptr());
+    return true; 
+  }
   
   virtual void operator<<(const magnet::xml::Node&);
   
@@ -31,6 +31,9 @@ public:
   { return new C2RSingle(*this); };
 
   virtual bool isInRange(const Particle&, const Particle&) const;
+
+  virtual bool getSingleRanges(std::vector<const CRange*>& ranges) const
+  { ranges.push_back(range.get_ptr()); return true; }
   
   virtual void operator<<(const magnet::xml::Node&);
   
@@ -16,8 +16,10 @@
 */
 
 #pragma once
+#include <vector>
 
 class Particle;
+class CRange;
 namespace magnet { namespace xml { class Node; class XmlStream; } }
 namespace dynamo { class SimData; }
 
@@ -27,6 +29,17 @@ public:
   virtual ~C2Range() {};
  
   virtual bool isInRange(const Particle&, const Particle&) const =0;  
+
+  /*! \brief Collects the single particle ranges this range is
+   * built from.
+   *
+   * If whether a pair is in this range only depends on which of these
+   * ranges each particle is in, they are appended to ranges and true
+   * is returned. Ranges which depend on the particular pair (e.g.,
+   * chains) return false. This allows Dynamics to tabulate the
+   * Interaction of each pair.
+   */
+  virtual bool getSingleRanges(std::vector<const CRange*>&) const { return false; }
   virtual void operator<<(const magnet::xml::Node& XML) = 0;
   
   virtual C2Range* Clone() const = 0;
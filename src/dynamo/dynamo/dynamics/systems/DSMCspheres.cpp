@@ -99,8 +99,12 @@ CSDSMCSpheres::runEvent() const
  
   size_t nmax = static_cast<size_t>(intPart);
   
-  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
-    Ptr->eventUpdate(*this, NEventData(), locdt);
+  {
+    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					dynamo::EventProfile::OUTPUT);
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+      Ptr->eventUpdate(*this, NEventData(), locdt);
+  }
 
   if (Sim->uniform_sampler() < fracpart)
     ++nmax;
@@ -137,8 +141,12 @@ CSDSMCSpheres::runEvent() const
   
 	  Sim->ptrScheduler->fullUpdate(p1, p2);
 	  
-	  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
-	    Ptr->eventUpdate(*this, SDat, 0.0);
+	  {
+	    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+						dynamo::EventProfile::OUTPUT);
+	    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+	      Ptr->eventUpdate(*this, SDat, 0.0);
+	  }
 	}
     }
 
@@ -89,8 +89,12 @@ CSRingDSMC::runEvent() const
   locdt += Sim->freestreamAcc;
   Sim->freestreamAcc = 0;
 
-  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
-    Ptr->eventUpdate(*this, NEventData(), locdt);
+  {
+    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					dynamo::EventProfile::OUTPUT);
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+      Ptr->eventUpdate(*this, NEventData(), locdt);
+  }
 
   //////////////////// T(1,2) operator
   double intPart;
@@ -132,8 +136,12 @@ CSRingDSMC::runEvent() const
 	    
 	    Sim->ptrScheduler->fullUpdate(p1, p2);
 	    
-	    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
-	      Ptr->eventUpdate(*this, SDat, 0.0);
+	    {
+	      dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+						  dynamo::EventProfile::OUTPUT);
+	      BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+		Ptr->eventUpdate(*this, SDat, 0.0);
+	    }
 	  }
       }
   }
@@ -185,8 +193,12 @@ CSRingDSMC::runEvent() const
 	    
 	    Sim->ptrScheduler->fullUpdate(p1, p2);
 	    
-	    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
-	      Ptr->eventUpdate(*this, SDat, 0.0);
+	    {
+	      dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+						  dynamo::EventProfile::OUTPUT);
+	      BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+		Ptr->eventUpdate(*this, SDat, 0.0);
+	    }
 	  }
       }
   }
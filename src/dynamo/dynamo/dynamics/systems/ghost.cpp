@@ -25,6 +25,7 @@
 #include "../ranges/include.hpp"
 #include "../liouvillean/liouvillean.hpp"
 #include "../../schedulers/scheduler.hpp"
+#include "../../base/binaryconfig.hpp"
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/random/uniform_int.hpp>
@@ -117,8 +118,12 @@ CSysGhost::runEvent() const
 
   Sim->ptrScheduler->fullUpdate(part);
   
-  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
-    Ptr->eventUpdate(*this, SDat, locdt);
+  {
+    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					dynamo::EventProfile::OUTPUT);
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+      Ptr->eventUpdate(*this, SDat, locdt);
+  }
 
 }
 
@@ -131,6 +136,39 @@ CSysGhost::initialise(size_t nID)
   sqrtTemp = sqrt(Temp);
 }
 
+namespace {
+  //! The tuning state of the thermostat in an exact checkpoint.
+  struct ExactGhost
+  {
+    double meanFreeTime;
+    uint64_t eventCount;
+    //! Events since the last tuning, as Sim->eventCount restarts
+    //! with each run.
+    uint64_t tuneEvents;
+  };
+}
+
+void 
+CSysGhost::outputExactState(dynamo::BinaryConfigWriter& file) const
+{
+  ExactGhost state;
+  state.meanFreeTime = meanFreeTime;
+  state.eventCount = eventCount;
+  state.tuneEvents = Sim->eventCount - lastlNColl;
+  file.writeValue(exactBlockName("Ghost"), state);
+}
+
+void 
+CSysGhost::loadExactState(const dynamo::BinaryConfigReader& file)
+{
+  if (!file.hasBlock(exactBlockName("Ghost"))) return;
+
+  const ExactGhost state = file.readValue<ExactGhost>(exactBlockName("Ghost"));
+  meanFreeTime = state.meanFreeTime;
+  eventCount = state.eventCount;
+  lastlNColl = Sim->eventCount - state.tuneEvents;
+}
+
 void 
 CSysGhost::operator<<(const magnet::xml::Node& XML)
 {
@@ -35,10 +35,17 @@ public:
 
   virtual void operator<<(const magnet::xml::Node&);
 
+  virtual void outputExactState(dynamo::BinaryConfigWriter&) const;
+
+  virtual void loadExactState(const dynamo::BinaryConfigReader&);
+
   double getTemperature() const { return Temp; }
   double getReducedTemperature() const;
   void setTemperature(double nT) { Temp = nT; sqrtTemp = std::sqrt(Temp); }
   void setReducedTemperature(double nT);
+
+  //! \brief The particles which are thermostatted.
+  const magnet::ClonePtr<CRange>& getRange() const { return range; }
   
 protected:
   virtual void outputXML(magnet::xml::XmlStream&) const;
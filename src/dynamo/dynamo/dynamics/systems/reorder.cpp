@@ -0,0 +1,321 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "reorder.hpp"
+#include "schedMaintainer.hpp"
+#include "snapshot.hpp"
+#include "sysTicker.hpp"
+#include "tHalt.hpp"
+#include "ghost.hpp"
+#include "../../base/is_simdata.hpp"
+#include "../../schedulers/scheduler.hpp"
+#include "../../outputplugins/outputplugin.hpp"
+#include "../units/units.hpp"
+#include "../liouvillean/liouvillean.hpp"
+#include "../species/species.hpp"
+#include "../interactions/interaction.hpp"
+#include "../interactions/captures.hpp"
+#include "../interactions/swsequence.hpp"
+#include "../ranges/2range.hpp"
+#include "../locals/local.hpp"
+#include "../globals/gcells.hpp"
+#include "../globals/gcellsmorton.hpp"
+#include "../globals/PBCSentinel.hpp"
+#include "../globals/ParabolaSentinel.hpp"
+#include <magnet/math/dilatedint.hpp>
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#ifdef DYNAMO_DEBUG
+#include <boost/math/special_functions/fpclassify.hpp>
+#endif
+
+namespace {
+  //! \brief The sort key of a particle, see SReorder::reorder.
+  struct ReorderKey
+  {
+    size_t group;
+    uint64_t morton;
+    size_t ID;
+
+    inline bool operator<(const ReorderKey& o) const
+    {
+      if (group != o.group) return group < o.group;
+      if (morton != o.morton) return morton < o.morton;
+      return ID < o.ID;
+    }
+  };
+}
+
+SReorder::SReorder(dynamo::SimData* nSim, double nPeriod, std::string nName):
+  System(nSim),
+  _period(nPeriod * nSim->dynamics.units().unitTime()),
+  _reordered(false)
+{
+  if (_period <= 0)
+    M_throw() << "The period of the particle reordering must be positive";
+
+  //The first reordering is carried out on the first event
+  dt = 0;
+  sysName = nName;
+
+  dout << "Particle reordering set for a period of " << nPeriod << std::endl;
+}
+
+void
+SReorder::initialise(size_t nID)
+{
+  ID = nID;
+
+  if (!Sim->dynamics.getTopology().empty())
+    M_throw() << "Particle reordering does not support molecules (Topology-s)";
+
+  if (Sim->dynamics.getLiouvillean().hasOrientationData())
+    M_throw() << "Particle reordering does not support orientation data";
+
+  //The particles are exchanged only within the sets of the single
+  //particle ranges, so collect every range which is used
+  std::vector<const CRange*> ranges;
+
+  BOOST_FOREACH(const magnet::ClonePtr<Species>& sp, Sim->dynamics.getSpecies())
+    ranges.push_back(sp->getRange().get_ptr());
+
+  BOOST_FOREACH(const magnet::ClonePtr<Interaction>& interaction,
+		Sim->dynamics.getInteractions())
+    {
+      if (dynamic_cast<const ISWSequence*>(interaction.get_ptr()) != NULL)
+	M_throw() << "Particle reordering does not support the sequence of Interaction \""
+		  << interaction->getName() << "\"";
+
+      if (!interaction->getRange()->getSingleRanges(ranges))
+	M_throw() << "Particle reordering does not support the pair specific range of Interaction \""
+		  << interaction->getName() << "\"";
+    }
+
+  BOOST_FOREACH(const magnet::ClonePtr<Local>& local, Sim->dynamics.getLocals())
+    if (!local->getRange().empty())
+      ranges.push_back(local->getRange().get_ptr());
+
+  BOOST_FOREACH(const magnet::ClonePtr<Global>& glob, Sim->dynamics.getGlobals())
+    {
+      if ((dynamic_cast<const CGCells*>(glob.get_ptr()) == NULL)
+	  && (dynamic_cast<const CGCellsMorton*>(glob.get_ptr()) == NULL)
+	  && (dynamic_cast<const GPBCSentinel*>(glob.get_ptr()) == NULL)
+	  && (dynamic_cast<const CGParabolaSentinel*>(glob.get_ptr()) == NULL))
+	M_throw() << "Particle reordering does not support the Global \""
+		  << glob->getName() << "\"";
+
+      if (!glob->getRange().empty())
+	ranges.push_back(glob->getRange().get_ptr());
+    }
+
+  BOOST_FOREACH(const magnet::ClonePtr<System>& sys, Sim->dynamics.getSystemEvents())
+    {
+      const System* ptr = sys.get_ptr();
+      if (const CSysGhost* ghost = dynamic_cast<const CSysGhost*>(ptr))
+	ranges.push_back(ghost->getRange().get_ptr());
+      else if ((dynamic_cast<const SReorder*>(ptr) == NULL)
+	       && (dynamic_cast<const CSSchedMaintainer*>(ptr) == NULL)
+	       && (dynamic_cast<const SSnapshot*>(ptr) == NULL)
+	       && (dynamic_cast<const CSTicker*>(ptr) == NULL)
+	       && (dynamic_cast<const CStHalt*>(ptr) == NULL))
+	M_throw() << "Particle reordering does not support the System \""
+		  << sys->getName() << "\"";
+    }
+
+  //The cells are used to sort the particles
+  const CGNeighbourList* nblist = dynamic_cast<const CGNeighbourList*>
+    (Sim->dynamics.getGlobal("SchedulerNBList").get_ptr());
+
+  if ((dynamic_cast<const CGCells*>(nblist) == NULL)
+      && (dynamic_cast<const CGCellsMorton*>(nblist) == NULL))
+    M_throw() << "Particle reordering requires the SchedulerNBList to be a cell list";
+
+  if (ranges.size() > std::numeric_limits<uint64_t>::digits)
+    M_throw() << "Particle reordering supports up to "
+	      << std::numeric_limits<uint64_t>::digits << " ranges, this system has "
+	      << ranges.size();
+
+  //Each particle's group is the set of ranges it is in
+  std::map<uint64_t, size_t> groupIDs;
+  _group.clear();
+  _group.reserve(Sim->N);
+  BOOST_FOREACH(const Particle& part, Sim->particleList)
+    {
+      uint64_t key(0);
+      for (size_t i(0); i < ranges.size(); ++i)
+	if (ranges[i]->isInRange(part))
+	  key |= uint64_t(1) << i;
+
+      std::map<uint64_t, size_t>::const_iterator it = groupIDs.find(key);
+      if (it == groupIDs.end())
+	it = groupIDs.insert(std::make_pair(key, groupIDs.size())).first;
+
+      _group.push_back(it->second);
+    }
+
+  //The IDs of each group, in order
+  std::vector<std::pair<size_t, size_t> > slots;
+  slots.reserve(Sim->N);
+  for (size_t pID(0); pID < Sim->N; ++pID)
+    slots.push_back(std::make_pair(_group[pID], pID));
+  std::sort(slots.begin(), slots.end());
+
+  _slots.clear();
+  _slots.reserve(Sim->N);
+  for (size_t i(0); i < slots.size(); ++i)
+    _slots.push_back(slots[i].second);
+
+  _originalID.resize(Sim->N);
+  for (size_t pID(0); pID < Sim->N; ++pID)
+    _originalID[pID] = pID;
+  _reordered = false;
+
+  dout << "Reordering the particles in " << groupIDs.size() << " groups" << std::endl;
+}
+
+void
+SReorder::runEvent() const
+{
+  double locdt = dt;
+
+#ifdef DYNAMO_DEBUG
+  if (boost::math::isnan(dt))
+    M_throw() << "A NAN system event time has been found";
+#endif
+
+  Sim->dSysTime += locdt;
+
+  Sim->ptrScheduler->stream(locdt);
+
+  //dynamics must be updated first
+  Sim->dynamics.stream(locdt);
+
+  Sim->freestreamAcc += locdt;
+
+  dt = _period;
+
+  reorder();
+}
+
+void
+SReorder::reorder() const
+{
+  Sim->dynamics.getLiouvillean().updateAllParticles();
+
+  const CGNeighbourList& nblist = dynamic_cast<const CGNeighbourList&>
+    (*Sim->dynamics.getGlobal("SchedulerNBList"));
+
+  std::vector<ReorderKey> keys;
+  keys.reserve(Sim->N);
+  BOOST_FOREACH(const Particle& part, Sim->particleList)
+    {
+      const CVector<int> coords = part.testState(Particle::ALIVE)
+	? nblist.getParticleCellCoords(part)
+	: nblist.getCellCoords(part.getPosition());
+      const magnet::math::DilatedVector cell
+	(uint32_t(coords[0] & magnet::math::DilatedInteger::undilatedMask),
+	 uint32_t(coords[1] & magnet::math::DilatedInteger::undilatedMask),
+	 uint32_t(coords[2] & magnet::math::DilatedInteger::undilatedMask));
+
+      ReorderKey key;
+      key.group = _group[part.getID()];
+      key.morton = cell.getMortonNum();
+      key.ID = part.getID();
+      keys.push_back(key);
+    }
+
+  std::sort(keys.begin(), keys.end());
+
+  //The i'th particle along the curve takes the i'th ID of its group
+  std::vector<size_t> newID(Sim->N);
+  for (size_t i(0); i < keys.size(); ++i)
+    newID[keys[i].ID] = _slots[i];
+
+  renumber(newID);
+}
+
+void
+SReorder::restoreOriginalOrder()
+{
+  if (!_reordered) return;
+
+  Sim->dynamics.getLiouvillean().updateAllParticles();
+  renumber(std::vector<size_t>(_originalID));
+}
+
+void
+SReorder::renumber(const std::vector<size_t>& newID) const
+{
+  //The output plugins are told first, as they may not support it
+  if (Sim->status >= INITIALISED)
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+      Ptr->particlesReordered(newID);
+
+  std::vector<size_t> oldID(newID.size());
+  for (size_t pID(0); pID < newID.size(); ++pID)
+    oldID[newID[pID]] = pID;
+
+  std::vector<Particle> particles;
+  particles.reserve(Sim->N);
+  std::vector<size_t> originalID;
+  originalID.reserve(Sim->N);
+  for (size_t pID(0); pID < Sim->N; ++pID)
+    {
+      const Particle& old = Sim->particleList[oldID[pID]];
+      particles.push_back(Particle(old.getPosition(), old.getVelocity(), pID));
+      particles.back().getPecTime() = old.getPecTime();
+
+      if (!old.testState(Particle::DYNAMIC))
+	particles.back().clearState(Particle::DYNAMIC);
+
+      if (!old.testState(Particle::ALIVE))
+	particles.back().clearState(Particle::ALIVE);
+
+      originalID.push_back(_originalID[oldID[pID]]);
+    }
+
+  Sim->particleList.swap(particles);
+  _originalID.swap(originalID);
+
+  _reordered = false;
+  for (size_t pID(0); pID < Sim->N; ++pID)
+    if (_originalID[pID] != pID)
+      {
+	_reordered = true;
+	break;
+      }
+
+  Sim->_properties.permuteParticles(oldID);
+
+  BOOST_FOREACH(magnet::ClonePtr<Interaction>& ptr, Sim->dynamics.getInteractions())
+    {
+      ICapture* capture = dynamic_cast<ICapture*>(ptr.get_ptr());
+      if (capture != NULL) capture->remapCaptureMap(newID);
+    }
+
+  BOOST_FOREACH(magnet::ClonePtr<Global>& glob, Sim->dynamics.getGlobals())
+    {
+      CGNeighbourList* nblist = dynamic_cast<CGNeighbourList*>(glob.get_ptr());
+      if (nblist != NULL) nblist->renumberParticles(newID);
+    }
+
+  if (Sim->status >= INITIALISED)
+    Sim->ptrScheduler->rebuildList();
+}
@@ -0,0 +1,87 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "system.hpp"
+#include <vector>
+
+/*! \brief A System Event which periodically renumbers the particles
+ * so that particles close in space are close in memory.
+ *
+ * The particles are sorted along the Morton curve of the cells of the
+ * scheduler's neighbour list (the Global named "SchedulerNBList"),
+ * and every structure indexed by the particle IDs (the particle list,
+ * the Property-s, the capture maps, the cell lists, the scheduler and
+ * the OutputPlugin-s) is renumbered to match.
+ *
+ * Particles are only exchanged with other particles in exactly the
+ * same single particle ranges (of the Species, Interaction-s,
+ * Local-s, Global-s and thermostats), so every range stays valid.
+ * Systems where the particles cannot be renumbered (e.g., with
+ * molecules, orientations or per-particle state held elsewhere) are
+ * rejected when the System is initialised.
+ *
+ * The ID each particle had in the configuration file is kept, and the
+ * particles are put back into that order before a configuration is
+ * written (see SimData::writeXMLfile), so the output files are
+ * numbered as if no reordering had taken place.
+ */
+class SReorder: public System
+{
+public:
+  /*! \param nPeriod The time between the reorderings.
+   * \param nName The name of the System.
+   */
+  SReorder(dynamo::SimData*, double nPeriod, std::string nName);
+
+  virtual System* Clone() const { return new SReorder(*this); }
+
+  virtual void runEvent() const;
+
+  virtual void initialise(size_t);
+
+  virtual void operator<<(const magnet::xml::Node&) {}
+
+  //! \brief Renumber the particles back to their original IDs.
+  void restoreOriginalOrder();
+
+  //! \brief The original ID of each particle, indexed by its current ID.
+  const std::vector<size_t>& getOriginalIDs() const { return _originalID; }
+
+protected:
+  virtual void outputXML(magnet::xml::XmlStream&) const {}
+
+  //! \brief Sort the particles along the Morton curve of the cells.
+  void reorder() const;
+
+  //! \brief Renumber the particles, the particle with the ID \p i
+  //! takes the ID newID[i].
+  void renumber(const std::vector<size_t>& newID) const;
+
+  double _period;
+
+  //! \brief The group of each particle, particles are only exchanged
+  //! within their group.
+  std::vector<size_t> _group;
+
+  //! \brief The IDs of the particles sorted by their group.
+  std::vector<size_t> _slots;
+
+  mutable std::vector<size_t> _originalID;
+
+  mutable bool _reordered;
+};
@@ -28,10 +28,13 @@
 #include <boost/math/special_functions/fpclassify.hpp>
 #endif
 
-SSnapshot::SSnapshot(dynamo::SimData* nSim, double nPeriod, std::string nName):
+SSnapshot::SSnapshot(dynamo::SimData* nSim, double nPeriod, std::string nName,
+		     std::string fileFormat, bool background):
   System(nSim),
   _applyBC(false),
-  _saveCounter(0)
+  _saveCounter(0),
+  _fileFormat(fileFormat),
+  _background(background)
 
 {
   if (nPeriod <= 0.0)
@@ -74,11 +77,25 @@ SSnapshot::runEvent() const
   //This is done here as most ticker properties require it
   Sim->dynamics.getLiouvillean().updateAllParticles();
 
-  BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
-    Ptr->eventUpdate(*this, NEventData(), locdt);
+  {
+    dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					dynamo::EventProfile::OUTPUT);
+    BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+      Ptr->eventUpdate(*this, NEventData(), locdt);
+  }
   
-  std::string filename = magnet::string::search_replace("Snapshot.%i.xml.bz2", "%i", boost::lexical_cast<std::string>(_saveCounter++));
-  Sim->writeXMLfile(filename, _applyBC);
+  std::string filename = magnet::string::search_replace(_fileFormat, "%i", boost::lexical_cast<std::string>(_saveCounter++));
+
+  //Bring the system event list up to date with the new dt, so the
+  //event queue in a binary snapshot is the one the simulation
+  //continues with. The scheduler rebuilds it again after this event
+  //without changing it.
+  Sim->ptrScheduler->rebuildSystemEvents();
+
+  if (_background)
+    Sim->writeXMLfileAsync(filename, _applyBC);
+  else
+    Sim->writeXMLfile(filename, _applyBC);
 }
 
 void 
@@ -18,11 +18,25 @@
 #pragma once
 #include "system.hpp"
 
-//! \brief A System Event which periodically saves the state of the system.
+/*! \brief A System Event which periodically saves the state of the system.
+ *
+ * By default the snapshots are captured into memory and written out
+ * in the background (see SimData::writeXMLfileAsync), so the
+ * simulation only pauses while the configuration is copied.
+ */
 class SSnapshot: public System
 {
 public:
-  SSnapshot(dynamo::SimData*, double, std::string);
+  /*! \param nPeriod The time between the snapshots.
+   * \param nName The name of the System.
+   * \param fileFormat The file name of the snapshots, "%i" is
+   * replaced by the number of the snapshot.
+   * \param background If the snapshots are written on a background
+   * thread.
+   */
+  SSnapshot(dynamo::SimData*, double nPeriod, std::string nName,
+	    std::string fileFormat = "Snapshot.%i.xml.bz2",
+	    bool background = true);
   
   virtual System* Clone() const { return new SSnapshot(*this); }
 
@@ -45,4 +59,6 @@ protected:
   double _period;
   bool _applyBC;
   mutable size_t _saveCounter;
+  std::string _fileFormat;
+  bool _background;
 };
@@ -21,6 +21,7 @@
 #include <string>
 
 namespace magnet { namespace xml { class Node; class XmlStream; } }
+namespace dynamo { class BinaryConfigWriter; class BinaryConfigReader; }
 class IntEvent;
 class GlobalEvent;
 class NEventData;
@@ -49,6 +50,21 @@ public:
   bool operator<(const System&) const;
   
   double getdt() const { return dt; }
+
+  //! \brief Set the time to the next event, used when restoring a checkpoint.
+  void setdt(double ndt) { dt = ndt; }
+
+  /*! \brief Write any state the System changes as the simulation
+   * runs (e.g., the tuning of a thermostat) to an exact checkpoint
+   * (see SimData::restartFile).
+   *
+   * The time to the next event is restored by the scheduler, so
+   * Systems without any other state need not implement these.
+   */
+  virtual void outputExactState(dynamo::BinaryConfigWriter&) const {}
+
+  //! \brief Restore the state written by outputExactState.
+  virtual void loadExactState(const dynamo::BinaryConfigReader&) {}
   
   friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream&, const System&);
   
@@ -67,6 +83,10 @@ public:
 protected:
   virtual void outputXML(magnet::xml::XmlStream&) const = 0;
 
+  //! \brief The name of a block of this System in an exact checkpoint.
+  std::string exactBlockName(const std::string& name) const
+  { return "Exact/System/" + sysName + "/" + name; }
+
   std::string sysName;  
   mutable double dt;
   EEventType type;
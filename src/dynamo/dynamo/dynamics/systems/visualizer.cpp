@@ -115,8 +115,12 @@ SVisualizer::runEvent() const
       if (_CLWindow.as<CLGLWindow>().dynamoParticleSync())
 	Sim->dynamics.getLiouvillean().updateAllParticles();
       
-      BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
-	Ptr->eventUpdate(*this, NEventData(), locdt);
+      {
+	dynamo::EventProfile::Scope profile(Sim->ptrScheduler->getProfile(),
+					    dynamo::EventProfile::OUTPUT);
+	BOOST_FOREACH(magnet::ClonePtr<OutputPlugin>& Ptr, Sim->outputPlugins)
+	  Ptr->eventUpdate(*this, NEventData(), locdt);
+      }
       
       {
 	const magnet::thread::ScopedLock lock(static_cast<CLGLWindow&>(*_CLWindow).getDestroyLock());
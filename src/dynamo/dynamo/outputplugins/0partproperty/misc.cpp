@@ -19,6 +19,7 @@
 #include "misc.hpp"
 #include "../../dynamics/include.hpp"
 #include "../../base/is_simdata.hpp"
+#include "../../base/checkpoint.hpp"
 #include "../../datatypes/vector.xml.hpp"
 #include <boost/foreach.hpp>
 #include <magnet/memUsage.hpp>
@@ -200,9 +201,18 @@ OPMisc::output(magnet::xml::XmlStream &XML)
       << magnet::xml::tag("CollPerSec")
       << magnet::xml::attr("val") << collpersec
       << magnet::xml::attr("CondorWarning") << std::string("true")
-      << magnet::xml::endtag("CollPerSec")
-
-      << magnet::xml::endtag("Timing")
+      << magnet::xml::endtag("CollPerSec");
+
+  //The time the simulation was paused to capture configurations
+  //written in the background
+  if (Sim->checkpointWriter)
+    XML << magnet::xml::tag("Checkpoints")
+	<< magnet::xml::attr("Count") << Sim->checkpointWriter->getCount()
+	<< magnet::xml::attr("TotalStall") << Sim->checkpointWriter->getTotalStall()
+	<< magnet::xml::attr("MaxStall") << Sim->checkpointWriter->getMaxStall()
+	<< magnet::xml::endtag("Checkpoints");
+
+  XML << magnet::xml::endtag("Timing")
       << magnet::xml::tag("SystemBoxLength")
       << magnet::xml::attr("val")
       << 1.0/Sim->dynamics.units().unitLength();
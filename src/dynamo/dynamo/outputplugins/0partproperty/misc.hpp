@@ -47,6 +47,13 @@ public:
   
   void changeSystem(OutputPlugin*);
 
+  void particlesReordered(const std::vector<size_t>&) {}
+
+  //! \brief Account for events which were executed outside of this
+  //! Simulation (e.g., by the domain decomposition engine).
+  void addEventCounts(unsigned long dual, unsigned long single)
+  { dualEvents += dual; singleEvents += single; }
+
 protected:
   std::time_t tstartTime;
   timespec acc_tstartTime;
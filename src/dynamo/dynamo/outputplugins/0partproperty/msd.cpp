@@ -39,6 +39,17 @@ OPMSD::initialise()
     initPos[ID] = Sim->particleList[ID].getPosition();
 }
 
+void
+OPMSD::particlesReordered(const std::vector<size_t>& newID)
+{
+  std::vector<Vector> oldPos;
+  oldPos.swap(initPos);
+  initPos.resize(oldPos.size());
+
+  for (size_t ID = 0; ID < oldPos.size(); ++ID)
+    initPos[newID[ID]] = oldPos[ID];
+}
+
 void
 OPMSD::output(magnet::xml::XmlStream &XML)
 {
@@ -40,6 +40,8 @@ class OPMSD: public OutputPlugin
 
   virtual OutputPlugin *Clone() const { return new OPMSD(*this); };
 
+  virtual void particlesReordered(const std::vector<size_t>&);
+
   double calcMSD(const CRange& range) const;
 
   double calcStructMSD(const Topology&) const;
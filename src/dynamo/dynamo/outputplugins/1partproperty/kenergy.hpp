@@ -46,6 +46,8 @@ class OPKEnergy: public OP1PP
   
   void changeSystem(OutputPlugin*);
 
+  void particlesReordered(const std::vector<size_t>&) {}
+
   void temperatureRescale(const double&);
   
   const double& getCurrentkT() const { return KECurrent; }
@@ -46,6 +46,8 @@ class OPUEnergy: public OP1PP
 
   void changeSystem(OutputPlugin*);
 
+  void particlesReordered(const std::vector<size_t>&) {}
+
  protected:
 
   double intECurrent;
@@ -0,0 +1,159 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "eventprofile.hpp"
+#include "../../dynamics/include.hpp"
+#include "../../dynamics/globals/neighbourList.hpp"
+#include "../../schedulers/scheduler.hpp"
+#include <magnet/xmlwriter.hpp>
+#include <magnet/xmlreader.hpp>
+
+OPEventProfile::OPEventProfile(const dynamo::SimData* t1,
+			       const magnet::xml::Node& XML):
+  OutputPlugin(t1, "EventProfile"),
+  _sampleInterval(64),
+  _periodic(false)
+{
+  operator<<(XML);
+}
+
+void
+OPEventProfile::operator<<(const magnet::xml::Node& XML)
+{
+  try
+    {
+      if (XML.hasAttribute("SampleInterval"))
+	_sampleInterval = XML.getAttribute("SampleInterval").as<size_t>();
+
+      _periodic = XML.hasAttribute("Periodic");
+    }
+  catch (boost::bad_lexical_cast &)
+    {
+      M_throw() << "Failed a lexical cast in OPEventProfile";
+    }
+
+  if (!_sampleInterval)
+    M_throw() << "The SampleInterval of the EventProfile must be at least 1";
+}
+
+void
+OPEventProfile::initialise()
+{
+  dynamo::EventProfile& profile = Sim->ptrScheduler->getProfile();
+
+  //Count the cell transitions of the neighbour lists separately
+  for (size_t ID(0); ID < Sim->dynamics.getGlobals().size(); ++ID)
+    profile.setGlobalType(ID, dynamic_cast<const CGNeighbourList*>
+			  (Sim->dynamics.getGlobals()[ID].get_ptr())
+			  ? CELL : GLOBAL);
+
+  //Only profile this run, not the initialisation
+  profile.reset();
+  profile.enable(_sampleInterval);
+
+  for (size_t i(0); i < dynamo::EventProfile::SECTIONS; ++i)
+    _lastSectionTime[i] = 0;
+
+  dout << "Timing one in every " << _sampleInterval << " events" << std::endl;
+}
+
+void
+OPEventProfile::periodicOutput()
+{
+  if (!_periodic) return;
+
+  const dynamo::EventProfile& profile = Sim->ptrScheduler->getProfile();
+
+  uint64_t time[dynamo::EventProfile::SECTIONS];
+  uint64_t total(0);
+  for (size_t i(0); i < dynamo::EventProfile::SECTIONS; ++i)
+    {
+      const dynamo::EventProfile::Section section
+	= static_cast<dynamo::EventProfile::Section>(i);
+      time[i] = profile.getSectionTime(section) - _lastSectionTime[i];
+      _lastSectionTime[i] = profile.getSectionTime(section);
+      total += time[i];
+    }
+
+  if (!total) return;
+
+  I_Pcout() << "Sort/Predict/Execute/Output ";
+  for (size_t i(0); i < dynamo::EventProfile::SECTIONS; ++i)
+    I_Pcout() << (i ? "/" : "") << (100 * time[i] + total / 2) / total;
+  I_Pcout() << "%, ";
+}
+
+void
+OPEventProfile::output(magnet::xml::XmlStream& XML)
+{
+  const dynamo::EventProfile& profile = Sim->ptrScheduler->getProfile();
+
+  //Every sampleInterval'th pass of the event loop is timed, so the
+  //sampled times are scaled up to estimate the total times
+  const double timeScale = 1e-9 * profile.getSampleInterval();
+
+  uint64_t total(0);
+  for (size_t i(0); i < dynamo::EventProfile::SECTIONS; ++i)
+    total += profile.getSectionTime(static_cast<dynamo::EventProfile::Section>(i));
+
+  XML << magnet::xml::tag("EventProfile")
+      << magnet::xml::attr("SampleInterval") << profile.getSampleInterval()
+      << magnet::xml::attr("SampledEvents") << profile.getSampledEvents()
+      << magnet::xml::attr("LazyDeletions") << profile.getLazyDeletions();
+
+  for (size_t i(0); i < dynamo::EventProfile::SECTIONS; ++i)
+    {
+      const dynamo::EventProfile::Section section
+	= static_cast<dynamo::EventProfile::Section>(i);
+
+      XML << magnet::xml::tag("Section")
+	  << magnet::xml::attr("Name") << dynamo::EventProfile::getSectionName(section)
+	  << magnet::xml::attr("Time") << timeScale * profile.getSectionTime(section)
+	  << magnet::xml::attr("Fraction")
+	  << (total ? double(profile.getSectionTime(section)) / total : 0.0)
+	  << magnet::xml::endtag("Section");
+    }
+
+  for (size_t type(0); type < dynamo::EventProfile::TYPES; ++type)
+    {
+      const dynamo::EventProfile::TypeStats& stats
+	= profile.getTypeStats(static_cast<EEventType>(type));
+
+      if (!stats.count && !stats.rejections && !stats.samples) continue;
+
+      XML << magnet::xml::tag("Event")
+	  << magnet::xml::attr("Type") << static_cast<EEventType>(type)
+	  << magnet::xml::attr("Count") << stats.count
+	  << magnet::xml::attr("Rejections") << stats.rejections
+	  << magnet::xml::attr("Samples") << stats.samples
+	  << magnet::xml::attr("MeanTime")
+	  << (stats.samples ? 1e-9 * stats.time / stats.samples : 0.0);
+
+      //The histogram of the sampled event times, the bins hold the
+      //events which took under MaxTime and at least half of it
+      for (size_t bin(0); bin < dynamo::EventProfile::BINS; ++bin)
+	if (stats.histogram[bin])
+	  XML << magnet::xml::tag("Bin")
+	      << magnet::xml::attr("MaxTime") << 1e-9 * double(uint64_t(2) << bin)
+	      << magnet::xml::attr("Count") << stats.histogram[bin]
+	      << magnet::xml::endtag("Bin");
+
+      XML << magnet::xml::endtag("Event");
+    }
+
+  XML << magnet::xml::endtag("EventProfile");
+}
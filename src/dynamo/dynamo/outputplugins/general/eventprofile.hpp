@@ -0,0 +1,61 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "../outputplugin.hpp"
+#include "../../schedulers/eventprofile.hpp"
+
+/*! \brief Enables the profile of the event loop of the scheduler
+ * (see dynamo::EventProfile) and writes it to the output file.
+ *
+ * The SampleInterval option sets how often an event is timed (every
+ * 64th event by default). The Periodic option adds the share of the
+ * time spent in each section of the event loop since the last
+ * periodic output to the screen output.
+ */
+class OPEventProfile: public OutputPlugin
+{
+public:
+  OPEventProfile(const dynamo::SimData*, const magnet::xml::Node&);
+
+  void eventUpdate(const IntEvent&, const PairEventData&) {}
+
+  void eventUpdate(const GlobalEvent&, const NEventData&) {}
+
+  void eventUpdate(const LocalEvent&, const NEventData&) {}
+
+  void eventUpdate(const System&, const NEventData&, const double&) {}
+
+  OutputPlugin *Clone() const { return new OPEventProfile(*this); }
+
+  virtual void initialise();
+
+  virtual void output(magnet::xml::XmlStream&);
+
+  virtual void periodicOutput();
+
+  virtual void changeSystem(OutputPlugin*) {}
+
+  virtual void particlesReordered(const std::vector<size_t>&) {}
+
+  virtual void operator<<(const magnet::xml::Node&);
+
+private:
+  size_t _sampleInterval;
+  bool _periodic;
+  uint64_t _lastSectionTime[dynamo::EventProfile::SECTIONS];
+};
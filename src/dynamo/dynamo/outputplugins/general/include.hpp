@@ -19,3 +19,4 @@
 #include "colldistcheck.hpp"
 #include "reverseEvents.hpp"
 #include "trajectory.hpp"
+#include "eventprofile.hpp"
@@ -39,6 +39,8 @@ public:
 
   virtual void changeSystem(OutputPlugin*) {}
 
+  virtual void particlesReordered(const std::vector<size_t>&) {}
+
   virtual void initialise();
 
   virtual void output(magnet::xml::XmlStream&);
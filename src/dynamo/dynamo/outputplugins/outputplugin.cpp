@@ -161,6 +161,10 @@ OutputPlugin::getPlugin(const magnet::xml::Node& XML, const dynamo::SimData* Sim
     return testGeneratePlugin<OPChainBondAngles>(Sim, XML);
   else if (!Name.compare("Trajectory"))
     return testGeneratePlugin<OPTrajectory>(Sim, XML);
+#ifndef DYNAMO_NO_EVENT_PROFILE
+  else if (!Name.compare("EventProfile"))
+    return testGeneratePlugin<OPEventProfile>(Sim, XML);
+#endif
   else if (!Name.compare("ChainBondLength"))
     return testGeneratePlugin<OPChainBondLength>(Sim, XML);
   else if (!Name.compare("ReverseEventsCheck"))
@@ -18,6 +18,7 @@
 #pragma once
 #include <dynamo/base.hpp>
 #include <dynamo/base/is_simdata.hpp>
+#include <vector>
 
 class IntEvent;
 class GlobalEvent;
@@ -66,6 +67,14 @@ public:
   { M_throw() << "This plugin hasn't been prepared for changes of system\n Plugin " <<  name; }
   
   virtual void temperatureRescale(const double&) {}
+
+  /*! \brief Called when the particles are renumbered (see SReorder).
+   *
+   * The particle with the ID \p i now has the ID newID[i]. Plugins
+   * holding data for each particle must reorder it.
+   */
+  virtual void particlesReordered(const std::vector<size_t>& newID)
+  { M_throw() << "This plugin hasn't been prepared for the reordering of the particles\n Plugin " <<  name; }
   
 protected:
   std::ostream& I_Pcout() const;
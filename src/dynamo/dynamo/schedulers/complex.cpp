@@ -54,6 +54,8 @@ CSComplex::initialise()
   BOOST_FOREACH(magnet::ClonePtr<CSCEntry>& ent, entries)
     ent->initialise();
 
+  if (restoreEventQueue()) return;
+
   sorter->clear();
 
   //The plus one is because system events are stored in the last heap;
@@ -53,6 +53,8 @@ CSDumb::operator<<(const magnet::xml::Node& XML)
 void
 CSDumb::initialise()
 {
+  if (restoreEventQueue()) return;
+
   dout << "Reinitialising on collision " << Sim->eventCount << std::endl;
   
   sorter->clear();
@@ -0,0 +1,278 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <dynamo/dynamics/eventtypes.hpp>
+#include <vector>
+#include <stdint.h>
+#include <time.h>
+
+namespace dynamo {
+  /*! \brief Counters and timings of the event loop of a CScheduler.
+   *
+   * Every event run by CScheduler::runNextEvent is counted by its
+   * type, along with the events rejected after being recalculated and
+   * the out of date events discarded by the lazy deletion. GLOBAL
+   * events are counted under the type set by setGlobalType, so the
+   * cell transitions of the neighbour lists are counted as CELL
+   * events.
+   *
+   * Once enabled, one event in every sampleInterval is also timed,
+   * as reading the clock for every event would cost more than a
+   * cheap event. The time of a sampled event is split between the
+   * Section's of the event loop by the Scope guards, each Section is
+   * timed exclusively (e.g., the time spent sorting new events while
+   * executing an event is charged to SORT, not EXECUTE). The sampling
+   * is deterministic and does not use the simulation's random number
+   * generator, so profiling does not change the trajectory.
+   *
+   * The profile is enabled and written out by the EventProfile output
+   * plugin. Defining DYNAMO_NO_EVENT_PROFILE removes it at compile
+   * time, the Scope guards and counters then compile to nothing.
+   */
+  class EventProfile
+  {
+  public:
+    //! \brief The exclusively timed sections of the event loop.
+    enum Section
+      {
+	SORT, //!< Sorting the event queue and the lazy deletion.
+	PREDICT, //!< Calculating the events of particles.
+	EXECUTE, //!< The rest of the event (e.g., the dynamics).
+	OUTPUT, //!< Updating the output plugins.
+	SECTIONS //!< The number of sections.
+      };
+
+    //! \brief The number of event types (see EEventType).
+    static const size_t TYPES = CORRECT + 1;
+
+    //! \brief The number of bins of the log2 histograms of the
+    //! sampled event times, the first bin holds events under 2ns.
+    static const size_t BINS = 40;
+
+    //! \brief The counters and sampled timings of one event type.
+    struct TypeStats
+    {
+      //! Events run.
+      uint64_t count;
+      //! Events rejected as they were recalculated to occur later.
+      uint64_t rejections;
+      //! Sampled events, and the sum of their times in nanoseconds.
+      uint64_t samples;
+      uint64_t time;
+      //! The histogram of the sampled event times, in log2(ns) bins.
+      uint64_t histogram[BINS];
+    };
+
+    EventProfile(): _sampleInterval(0), _countdown(0), _sampling(false)
+    { reset(); }
+
+    /*! \brief Start timing one event in every sampleInterval.
+     *
+     * A sampleInterval of zero stops the timing.
+     */
+    void enable(size_t sampleInterval)
+    {
+      _sampleInterval = sampleInterval;
+      _countdown = sampleInterval;
+    }
+
+    //! \brief Clear all counters and timings.
+    void reset()
+    {
+      for (size_t i(0); i < TYPES; ++i)
+	_types[i] = TypeStats();
+      for (size_t i(0); i < SECTIONS; ++i)
+	_sectionTime[i] = 0;
+      _lazyDeletions = 0;
+      _sampledEvents = 0;
+    }
+
+    //! \brief Set the type under which the events of a Global are
+    //! counted (e.g., CELL for neighbour lists).
+    void setGlobalType(size_t globalID, EEventType type)
+    {
+      if (globalID >= _globalTypes.size())
+	_globalTypes.resize(globalID + 1, GLOBAL);
+      _globalTypes[globalID] = type;
+    }
+
+    size_t getSampleInterval() const { return _sampleInterval; }
+    const TypeStats& getTypeStats(EEventType type) const { return _types[type]; }
+    //! \brief The sampled time of a Section, in nanoseconds.
+    uint64_t getSectionTime(Section section) const { return _sectionTime[section]; }
+    uint64_t getLazyDeletions() const { return _lazyDeletions; }
+    uint64_t getSampledEvents() const { return _sampledEvents; }
+
+    //! \brief The name of a Section, as written to the output.
+    static const char* getSectionName(Section section)
+    {
+      static const char* names[SECTIONS]
+	= {"Sort", "Predict", "Execute", "Output"};
+      return names[section];
+    }
+
+    /*! \brief Marks one pass of CScheduler::runNextEvent, which
+     * decides if the event is timed.
+     */
+    class Event
+    {
+    public:
+      Event(EventProfile& profile): _profile(profile)
+      {
+#ifndef DYNAMO_NO_EVENT_PROFILE
+	if (profile._countdown && !--profile._countdown)
+	  profile.startSample();
+#endif
+      }
+
+      ~Event()
+      {
+#ifndef DYNAMO_NO_EVENT_PROFILE
+	if (_profile._sampling)
+	  _profile.endSample();
+#endif
+      }
+
+    private:
+      EventProfile& _profile;
+    };
+
+    /*! \brief Charges the time until it is destroyed, or end() is
+     * called, to a Section.
+     */
+    class Scope
+    {
+    public:
+      Scope(EventProfile& profile, Section section):
+	_profile(profile), _previous(EXECUTE), _active(false)
+      {
+#ifndef DYNAMO_NO_EVENT_PROFILE
+	if (profile._sampling)
+	  {
+	    _previous = profile.enterSection(section);
+	    _active = true;
+	  }
+#endif
+      }
+
+      ~Scope() { end(); }
+
+      //! \brief Return to the enclosing Section.
+      void end()
+      {
+#ifndef DYNAMO_NO_EVENT_PROFILE
+	if (_active)
+	  {
+	    _profile.enterSection(_previous);
+	    _active = false;
+	  }
+#endif
+      }
+
+    private:
+      EventProfile& _profile;
+      Section _previous;
+      bool _active;
+    };
+
+    //! \brief Count an event run, the type given is as sorted.
+    void eventRun(EEventType type, size_t ID)
+    {
+#ifndef DYNAMO_NO_EVENT_PROFILE
+      if ((type == GLOBAL) && (ID < _globalTypes.size()))
+	type = _globalTypes[ID];
+      _eventType = type;
+      ++_types[type].count;
+#endif
+    }
+
+    //! \brief Count an event rejected after it was recalculated.
+    void eventRejected(EEventType type)
+    {
+#ifndef DYNAMO_NO_EVENT_PROFILE
+      _eventType = type;
+      ++_types[type].rejections;
+#endif
+    }
+
+    //! \brief Count an out of date event removed from the queue.
+    void lazyDeletion()
+    {
+#ifndef DYNAMO_NO_EVENT_PROFILE
+      ++_lazyDeletions;
+#endif
+    }
+
+  private:
+    static uint64_t now()
+    {
+      timespec time;
+      clock_gettime(CLOCK_MONOTONIC, &time);
+      return uint64_t(time.tv_sec) * 1000000000 + time.tv_nsec;
+    }
+
+    void startSample()
+    {
+      _countdown = _sampleInterval;
+      _sampling = true;
+      _section = EXECUTE;
+      _eventType = NONE;
+      _eventStart = _sectionStart = now();
+    }
+
+    void endSample()
+    {
+      _sampling = false;
+      const uint64_t end = now();
+      _sectionTime[_section] += end - _sectionStart;
+      ++_sampledEvents;
+
+      const uint64_t time = end - _eventStart;
+      TypeStats& stats = _types[_eventType];
+      ++stats.samples;
+      stats.time += time;
+      size_t bin = 0;
+      while ((bin + 1 < BINS) && (time >> (bin + 1))) ++bin;
+      ++stats.histogram[bin];
+    }
+
+    Section enterSection(Section section)
+    {
+      const uint64_t time = now();
+      _sectionTime[_section] += time - _sectionStart;
+      _sectionStart = time;
+      const Section previous = _section;
+      _section = section;
+      return previous;
+    }
+
+    size_t _sampleInterval;
+    size_t _countdown;
+    bool _sampling;
+    Section _section;
+    EEventType _eventType;
+    uint64_t _eventStart;
+    uint64_t _sectionStart;
+
+    TypeStats _types[TYPES];
+    uint64_t _sectionTime[SECTIONS];
+    uint64_t _lazyDeletions;
+    uint64_t _sampledEvents;
+    std::vector<EEventType> _globalTypes;
+  };
+}
@@ -61,6 +61,8 @@ CSNeighbourList::initialise()
     (*Sim->dynamics.getGlobals()[NBListID].get_ptr())
     .markAsUsedInScheduler();
 
+  if (restoreEventQueue()) return;
+
   dout << "Building all events on collision " << Sim->eventCount << std::endl;
   std::cout.flush();
 
@@ -76,7 +78,8 @@ CSNeighbourList::initialise()
  
     BOOST_FOREACH(const Particle& part, Sim->particleList)
       {
-	addEventsInit(part);
+	if (part.testState(Particle::ALIVE))
+	  addEventsInit(part);
 	++prog;
       }
   }
@@ -99,7 +102,8 @@ CSNeighbourList::rebuildList()
   eventCount.resize(Sim->N+1, 0);
 
   BOOST_FOREACH(const Particle& part, Sim->particleList)
-    addEventsInit(part);
+    if (part.testState(Particle::ALIVE))
+      addEventsInit(part);
   
   sorter->rebuild();
   
@@ -154,9 +158,12 @@ CSNeighbourList::addEvents(const Particle& part)
   nblist.getParticleLocalNeighbourhood
     (part, magnet::function::MakeDelegate(this, &CScheduler::addLocalEvent));
 
-  //Add the interaction events
+  //Add the interaction events, gathering the neighbours first so
+  //their events are predicted as one batch
+  _nbIDs.clear();
   nblist.getParticleNeighbourhood
-    (part, magnet::function::MakeDelegate(this, &CScheduler::addInteractionEvent));  
+    (part, magnet::function::MakeDelegate(this, &CSNeighbourList::addNBID));
+  addInteractionEvents(part, _nbIDs);
 }
 
 void 
@@ -187,7 +194,9 @@ CSNeighbourList::addEventsInit(const Particle& part)
      (this, &CScheduler::addLocalEvent));
 
   //Add the interaction events
+  _nbIDs.clear();
   nblist.getParticleNeighbourhood
     (part, magnet::function::MakeDelegate
-     (this, &CScheduler::addInteractionEventInit));  
+     (this, &CSNeighbourList::addNBIDInit));
+  addInteractionEvents(part, _nbIDs);
 }
@@ -37,6 +37,17 @@ protected:
   virtual void outputXML(magnet::xml::XmlStream&) const;
 
   void addEventsInit(const Particle&);
+
+  //! Delegate target to collect the neighbours of a particle.
+  void addNBID(const Particle&, const size_t& ID) { _nbIDs.push_back(ID); }
+
+  //! Delegate target to collect the neighbours of a particle which
+  //! it stores the initial events of.
+  void addNBIDInit(const Particle& part, const size_t& ID) 
+  { if (storesInitEvent(part.getID(), ID)) _nbIDs.push_back(ID); }
   
   size_t NBListID;
+
+  //! The neighbours of the particle whose events are being added.
+  std::vector<size_t> _nbIDs;
 };
@@ -23,6 +23,7 @@
 #include "../dynamics/systems/system.hpp"
 #include "../dynamics/liouvillean/liouvillean.hpp"
 #include "../base/is_simdata.hpp"
+#include "../base/binaryconfig.hpp"
 #include "include.hpp"
 #include "../dynamics/units/units.hpp"
 
@@ -34,6 +35,7 @@
 #include <magnet/xmlwriter.hpp>
 #include <magnet/xmlreader.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <cstring>
 
 CScheduler::CScheduler(dynamo::SimData* const tmp, const char * aName,
 		       CSSorter* nS):
@@ -83,6 +85,102 @@ CScheduler::rebuildSystemEvents() const
   sorter->update(Sim->N);
 }
 
+namespace {
+  //Layouts of the blocks written by CScheduler::outputExactState
+  struct ExactScheduler
+  {
+    uint64_t interactionRejections;
+    uint64_t localRejections;
+  };
+
+  struct ExactSystem
+  {
+    char name[56];
+    double dt;
+  };
+}
+
+void
+CScheduler::outputExactState(dynamo::BinaryConfigWriter& file) const
+{
+  if (!sorter->saveState(file)) return;
+
+  ExactScheduler state;
+  state.interactionRejections = _interactionRejectionCounter;
+  state.localRejections = _localRejectionCounter;
+  file.writeValue("Exact/Scheduler", state);
+  file.writeBlock("Exact/EventCount", eventCount);
+
+  std::vector<ExactSystem> systems;
+  BOOST_FOREACH(const magnet::ClonePtr<System>& sysptr, 
+		Sim->dynamics.getSystemEvents())
+    {
+      ExactSystem sys;
+      std::memset(&sys, 0, sizeof(sys));
+      std::strncpy(sys.name, sysptr->getName().c_str(), sizeof(sys.name) - 1);
+      sys.dt = sysptr->getdt();
+      systems.push_back(sys);
+    }
+  file.writeBlock("Exact/Systems", systems);
+}
+
+bool
+CScheduler::restoreEventQueue()
+{
+  if ((Sim->restartFile == NULL) 
+      || !Sim->restartFile->hasBlock("Exact/Scheduler"))
+    return false;
+
+  const dynamo::BinaryConfigReader& file = *Sim->restartFile;
+
+  sorter->clear();
+  sorter->resize(Sim->N+1);
+  if (!sorter->loadState(file))
+    {
+      dout << "The checkpoint holds the events of a different sorter, "
+	"rebuilding the event queue" << std::endl;
+      return false;
+    }
+
+  file.readBlock("Exact/EventCount", eventCount);
+  if (eventCount.size() != Sim->N + 1)
+    M_throw() << "The event counters of the checkpoint are for " 
+	      << eventCount.size() - 1 << " particles, not " << Sim->N;
+
+  const ExactScheduler state = file.readValue<ExactScheduler>("Exact/Scheduler");
+  _interactionRejectionCounter = state.interactionRejections;
+  _localRejectionCounter = state.localRejections;
+
+  //The System events are matched by name, as Systems may have been
+  //added or removed (e.g., by dynarun options). The system event
+  //list refers to the Systems by their IDs, so it is only kept if
+  //the Systems are unchanged. Otherwise it is rebuilt, which
+  //perturbs the rounding of the event times.
+  std::vector<ExactSystem> systems;
+  file.readBlock("Exact/Systems", systems);
+  bool rebuild = (systems.size() != Sim->dynamics.getSystemEvents().size());
+  for (size_t id(0); id < Sim->dynamics.getSystemEvents().size(); ++id)
+    {
+      System& system = *Sim->dynamics.getSystemEvents()[id];
+      bool found = false;
+      for (size_t i(0); i < systems.size(); ++i)
+	if (system.getName() == systems[i].name)
+	  {
+	    system.setdt(systems[i].dt);
+	    found = true;
+	    rebuild |= (i != id);
+	    break;
+	  }
+      rebuild |= !found;
+    }
+
+  if (rebuild)
+    rebuildSystemEvents();
+
+  dout << "Restored the event queue from the checkpoint" << std::endl;
+  return true;
+}
+
 void 
 CScheduler::popNextEvent()
 {
@@ -99,6 +197,7 @@ CScheduler::pushEvent(const Particle& part,
 void 
 CScheduler::sort(const Particle& part)
 {
+  dynamo::EventProfile::Scope profile(_profile, dynamo::EventProfile::SORT);
   sorter->update(part.getID());
 }
 
@@ -113,14 +212,19 @@ CScheduler::invalidateEvents(const Particle& part)
 void
 CScheduler::runNextEvent()
 {
-  sorter->sort();
+  dynamo::EventProfile::Event profiledEvent(_profile);
+
+  {
+    dynamo::EventProfile::Scope profile(_profile, dynamo::EventProfile::SORT);
+    sorter->sort();
 
 #ifdef DYNAMO_DEBUG
-  if (sorter->nextPELEmpty())
-    M_throw() << "Next particle list is empty but top of list!";
+    if (sorter->nextPELEmpty())
+      M_throw() << "Next particle list is empty but top of list!";
 #endif
 
-  lazyDeletionCleanup();
+    lazyDeletionCleanup();
+  }
 
   if (boost::math::isnan(sorter->next_dt()))
     M_throw() << "Next event time is NaN"
@@ -191,14 +295,19 @@ CScheduler::runNextEvent()
 	const Particle& p2(Sim->particleList[sorter->next_p2()]);
 
 	//Ready the next event in the FEL
-	sorter->popNextEvent();
-	sorter->update(sorter->next_ID());
-	sorter->sort();	
-	lazyDeletionCleanup();
+	{
+	  dynamo::EventProfile::Scope profile(_profile, dynamo::EventProfile::SORT);
+	  sorter->popNextEvent();
+	  sorter->update(sorter->next_ID());
+	  sorter->sort();	
+	  lazyDeletionCleanup();
+	}
 
 	//Now recalculate the FEL event
+	dynamo::EventProfile::Scope predict(_profile, dynamo::EventProfile::PREDICT);
 	Sim->dynamics.getLiouvillean().updateParticlePair(p1, p2);       
 	IntEvent Event(Sim->dynamics.getEvent(p1, p2));
+	predict.end();
 	
 #ifdef DYNAMO_DEBUG
 	if (sorter->nextPELEmpty())
@@ -214,6 +323,7 @@ CScheduler::runNextEvent()
 		 << ",dt=" << Event.getdt() << ">nextdt=" << sorter->next_dt()
 		 << ",p1=" << p1.getID() << ",p2=" << p2.getID() << std::endl;
 #endif		
+	    _profile.eventRejected(INTERACTION);
 	    this->fullUpdate(p1, p2);
 	    return;
 	  }
@@ -225,6 +335,7 @@ CScheduler::runNextEvent()
 
 	//Reset the rejection watchdog, we will run an interaction event now
 	_interactionRejectionCounter = 0;
+	_profile.eventRun(INTERACTION, Event.getInteractionID());
 		
 #ifdef DYNAMO_DEBUG
 
@@ -268,6 +379,7 @@ CScheduler::runNextEvent()
 	//optimise this (they dont need it).
 
 	//We also don't recheck Global events! (Check, some events might rely on this behavior)
+	_profile.eventRun(GLOBAL, sorter->next_p2());
 	Sim->dynamics.getGlobals()[sorter->next_p2()]
 	  ->runEvent(Sim->particleList[sorter->next_ID()], sorter->next_dt());       	
 	break;	           
@@ -280,13 +392,18 @@ CScheduler::runNextEvent()
 	size_t localID = sorter->next_p2();
 
 	//Ready the next event in the FEL
-	sorter->popNextEvent();
-	sorter->update(sorter->next_ID());
-	sorter->sort();
-	lazyDeletionCleanup();
-
+	{
+	  dynamo::EventProfile::Scope profile(_profile, dynamo::EventProfile::SORT);
+	  sorter->popNextEvent();
+	  sorter->update(sorter->next_ID());
+	  sorter->sort();
+	  lazyDeletionCleanup();
+	}
+
+	dynamo::EventProfile::Scope predict(_profile, dynamo::EventProfile::PREDICT);
 	Sim->dynamics.getLiouvillean().updateParticle(part);
 	LocalEvent iEvent(Sim->dynamics.getLocals()[localID]->getEvent(part));
+	predict.end();
 
 	if (iEvent.getType() == NONE)
 	  {
@@ -294,6 +411,7 @@ CScheduler::runNextEvent()
 	    derr << "Local event found not to occur [" << part.getID()
 		     << "] (possible glancing/tenuous event canceled due to numerical error)" << std::endl;
 #endif		
+	    _profile.eventRejected(LOCAL);
 	    this->fullUpdate(part);
 	    return;
 	  }
@@ -305,11 +423,13 @@ CScheduler::runNextEvent()
 #ifdef DYNAMO_DEBUG 
 	    derr << "Recalculated LOCAL event time is greater than the next event time, recalculating" << std::endl;
 #endif
+	    _profile.eventRejected(LOCAL);
 	    this->fullUpdate(part);
 	    return;
 	  }
 
 	_localRejectionCounter = 0;
+	_profile.eventRun(LOCAL, localID);
 
 #ifdef DYNAMO_DEBUG 
 	if (boost::math::isnan(iEvent.getdt()))
@@ -336,9 +456,11 @@ CScheduler::runNextEvent()
       }
     case SYSTEM:
       {
+	_profile.eventRun(SYSTEM, sorter->next_p2());
 	Sim->dynamics.getSystemEvents()[sorter->next_p2()]
 	  ->runEvent();
 	//This saves the system events rebuilding themselves
+	dynamo::EventProfile::Scope profile(_profile, dynamo::EventProfile::SORT);
 	rebuildSystemEvents();
 	break;
       }
@@ -349,6 +471,7 @@ CScheduler::runNextEvent()
 	//for a specific reason)
 	//derr << "VIRTUAL for " << sorter->next_ID() << std::endl;
 
+	_profile.eventRun(VIRTUAL, sorter->next_p2());
 	this->fullUpdate(Sim->particleList[sorter->next_ID()]);
 	break;
       }
@@ -382,6 +505,29 @@ CScheduler::addInteractionEvent(const Particle& part,
 void 
 CScheduler::addInteractionEventInit(const Particle& part, 
 					 const size_t& id) const
+{
+  if (storesInitEvent(part.getID(), id))
+    addInteractionEvent(part, id);
+}
+
+void
+CScheduler::addInteractionEvents(const Particle& part, 
+				 const std::vector<size_t>& ids) const
+{
+  if (ids.empty()) return;
+
+  BOOST_FOREACH(const size_t& id, ids)
+    Sim->dynamics.getLiouvillean().updateParticle(Sim->particleList[id]);
+
+  _batchEvents.clear();
+  Sim->dynamics.getEvents(part, &ids[0], ids.size(), _batchEvents);
+
+  BOOST_FOREACH(const IntEvent& eevent, _batchEvents)
+    sorter->push(intPart(eevent, eventCount[eevent.getParticle2ID()]), part.getID());
+}
+
+bool
+CScheduler::storesInitEvent(const size_t& ID, const size_t& partnerID)
 {
   //We'll be smart about memory and try to add events evenly on
   //initialisation to all particles
@@ -395,21 +541,18 @@ CScheduler::addInteractionEventInit(const Particle& part,
   //We can mix this up a little, by also testing for odd and evenness
   //and using this to switch which particles are chosen
 
-  size_t val = (part.getID() % 2) + 2 * (id % 2);
+  size_t val = (ID % 2) + 2 * (partnerID % 2);
   switch (val)//part-id
     {
     case 0: //even-even (accept half)
-      if (part.getID() > id) return;      
-      break;
+      return ID < partnerID;
     case 1: //odd-even (accept)
-      break;
+      return true;
     case 2: //even-odd (reject)
-      return;
-    case 3: //odd-odd (accept half)
-      if (part.getID() < id) return;      
+      return false;
+    default: //odd-odd (accept half)
+      return ID > partnerID;
     }
-
-  addInteractionEvent(part, id);
 }
 
 void 
@@ -441,11 +584,21 @@ CScheduler::fullUpdate(const Particle& p1, const Particle& p2)
 void 
 CScheduler::fullUpdate(const Particle& part)
 {
+  //The sorting is charged to SORT by sort()
+  dynamo::EventProfile::Scope profile(_profile, dynamo::EventProfile::PREDICT);
   invalidateEvents(part);
   addEvents(part);
   sort(part);
 }
 
+double
+CScheduler::getNextEventTime()
+{
+  sorter->sort();
+  lazyDeletionCleanup();
+  return Sim->dSysTime + sorter->next_dt();
+}
+
 void 
 CScheduler::lazyDeletionCleanup()
 {
@@ -454,6 +607,7 @@ CScheduler::lazyDeletionCleanup()
 	     != eventCount[sorter->next_p2()]))
     {
       //Not valid, update the list
+      _profile.lazyDeletion();
       sorter->popNextEvent();
       sorter->update(sorter->next_ID());
       sorter->sort();
@@ -18,13 +18,16 @@
 #pragma once
 #include <dynamo/base.hpp>
 #include <dynamo/schedulers/sorters/sorter.hpp>
+#include <dynamo/schedulers/eventprofile.hpp>
 #include <dynamo/dynamics/interactions/intEvent.hpp>
 #include <dynamo/dynamics/globals/globEvent.hpp>
 #include <vector>
+#include <stdint.h>
 
 class Particle;
 class intPart;
 namespace magnet { namespace xml { class Node; } }
+namespace dynamo { class BinaryConfigWriter; }
 
 class CScheduler: public dynamo::SimBase
 {
@@ -53,6 +56,11 @@ public:
   
   void runNextEvent();
 
+  /*! \brief Returns the absolute time of the next valid event in
+   * the queue, or HUGE_VAL if there are no events.
+   */
+  double getNextEventTime();
+
   virtual void rebuildList() = 0;
 
   friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream&, const CScheduler&);
@@ -67,11 +75,31 @@ public:
 
   void rebuildSystemEvents() const;
 
+  //! \brief Test if the event queue has been built by initialise().
+  bool hasEvents() const { return !eventCount.empty(); }
+
+  /*! \brief Write the event queue to the blocks of an exact
+   * checkpoint (see SimData::restartFile).
+   *
+   * This holds the event counters, the sorter and the times of the
+   * System events. Nothing is written if the sorter cannot save its
+   * state, the queue is then rebuilt on restart.
+   */
+  void outputExactState(dynamo::BinaryConfigWriter&) const;
+
   void addInteractionEvent(const Particle&, const size_t&) const;
 
   void addInteractionEventInit(const Particle&, const size_t&) const;
 
+  /*! \brief Streams the particles in ids up to date and adds their
+   * interaction events with part as one batch.
+   */
+  void addInteractionEvents(const Particle&, const std::vector<size_t>&) const;
+
   void addLocalEvent(const Particle&, const size_t&) const;
+
+  //! \brief The counters and timings of the event loop.
+  dynamo::EventProfile& getProfile() const { return _profile; }
   
 protected:
   /*! \brief Performs the lazy deletion algorithm to find the next
@@ -83,11 +111,31 @@ protected:
    */
   void lazyDeletionCleanup();
 
+  /*! \brief Decides which particle of a pair stores their event
+   * while the events are first being built.
+   */
+  static bool storesInitEvent(const size_t& ID, const size_t& partnerID);
+
+  /*! \brief Restore the event queue from the exact checkpoint being
+   * loaded, if there is one.
+   *
+   * This is called by initialise() in place of building the events.
+   * \return True if the queue was restored and does not need to be
+   * built.
+   */
+  bool restoreEventQueue();
+
   mutable magnet::ClonePtr<CSSorter> sorter;
-  mutable std::vector<unsigned long> eventCount;
+  //! Compared against intPart::collCounter2, so it is only 32 bits
+  mutable std::vector<uint32_t> eventCount;
+
+  //! Reused storage for the events of addInteractionEvents.
+  mutable std::vector<IntEvent> _batchEvents;
   
   size_t _interactionRejectionCounter;
   size_t _localRejectionCounter;
 
+  mutable dynamo::EventProfile _profile;
+
   virtual void outputXML(magnet::xml::XmlStream&) const = 0;
 };
@@ -104,6 +104,24 @@ public:
   {
     _innerHeap.swap(rhs._innerHeap);
   }
+
+  //! Append the events to an array, see CSSorter::saveState.
+  inline void exportEvents(std::vector<intPart>& events) const
+  { events.insert(events.end(), _innerHeap.begin(), _innerHeap.end()); }
+
+  //! Replace the events with those written by exportEvents. The
+  //! array is already in heap order, so inserting it in sequence
+  //! rebuilds exactly the same heap.
+  inline void importEvents(const intPart* first, const intPart* last)
+  {
+    if (last - first > std::ptrdiff_t(Size))
+      M_throw() << "Cannot load " << (last - first) 
+		<< " events into a heap of size " << Size;
+
+    clear();
+    for (; first != last; ++first)
+      _innerHeap.insert(*first);
+  }
   
 };
 
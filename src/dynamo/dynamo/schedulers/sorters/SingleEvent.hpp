@@ -76,6 +76,17 @@ public:
 
   inline void swap(PELSingleEvent& rhs)
   { std::swap(_event, rhs._event); }
+
+  //! Append the event to an array, see CSSorter::saveState.
+  inline void exportEvents(std::vector<intPart>& events) const
+  { if (!empty()) events.push_back(_event); }
+
+  //! Replace the event with the one written by exportEvents.
+  inline void importEvents(const intPart* first, const intPart* last)
+  { 
+    clear();
+    if (first != last) _event = *first;
+  }
   
 };
 
@@ -21,6 +21,7 @@
 
 #include "../../dynamics/units/units.hpp"
 #include "../../base/is_simdata.hpp"
+#include "../../base/binaryconfig.hpp"
 #include <boost/static_assert.hpp>
 #include <magnet/exception.hpp>
 #include <string>
@@ -91,6 +92,26 @@ private:
   size_t NP, N;
   size_t exceptionCount;
 
+  //Layouts of the blocks written by saveState
+  struct ExactState
+  {
+    double scale;
+    double pecTime;
+    double listWidth;
+    int64_t currentIndex;
+    int64_t nlists;
+    uint64_t NP;
+    uint64_t N;
+    uint64_t exceptionCount;
+  };
+
+  struct ExactLinks
+  {
+    int next;
+    int previous;
+    int qIndex;
+  };
+
 public:  
   CSSBoundedPQ(const dynamo::SimData* const& SD):
     CSSorter(SD, "BoundedPQ"),
@@ -136,6 +157,7 @@ public:
 
   void resize(const size_t& a)
   {
+    checkSize(a);
     clear();
     N = a;
     CBT.resize(2 * N);
@@ -335,6 +357,95 @@ public:
 
   }
 
+  bool saveState(dynamo::BinaryConfigWriter& file) const
+  {
+    const std::string type = CSSBoundedPQName<T>::name();
+    file.writeBlock("Exact/Sorter/Type", std::vector<char>(type.begin(), type.end()));
+
+    ExactState state;
+    state.scale = scale;
+    state.pecTime = pecTime;
+    state.listWidth = listWidth;
+    state.currentIndex = currentIndex;
+    state.nlists = nlists;
+    state.NP = NP;
+    state.N = N;
+    state.exceptionCount = exceptionCount;
+    file.writeValue("Exact/Sorter", state);
+
+    file.writeBlock("Exact/Sorter/Lists", linearLists);
+    file.writeBlock("Exact/Sorter/CBT", CBT);
+    file.writeBlock("Exact/Sorter/Leaf", Leaf);
+
+    std::vector<ExactLinks> links(Min.size());
+    std::vector<intPart> events;
+    std::vector<uint32_t> eventCounts(Min.size());
+    for (size_t i(0); i < Min.size(); ++i)
+      {
+	links[i].next = Min[i].next;
+	links[i].previous = Min[i].previous;
+	links[i].qIndex = Min[i].qIndex;
+	const size_t start = events.size();
+	Min[i].data.exportEvents(events);
+	eventCounts[i] = events.size() - start;
+      }
+
+    file.writeBlock("Exact/Sorter/Links", links);
+    file.writeBlock("Exact/Sorter/EventCounts", eventCounts);
+    file.writeBlock("Exact/Sorter/Events", events);
+    return true;
+  }
+
+  bool loadState(const dynamo::BinaryConfigReader& file)
+  {
+    std::vector<char> type;
+    file.readBlock("Exact/Sorter/Type", type);
+    if (std::string(type.begin(), type.end()) != CSSBoundedPQName<T>::name())
+      return false;
+
+    const ExactState state = file.readValue<ExactState>("Exact/Sorter");
+    if (state.N != N)
+      M_throw() << "The event queue of the checkpoint is for " << state.N
+		<< " particles, not " << N;
+
+    scale = state.scale;
+    pecTime = state.pecTime;
+    listWidth = state.listWidth;
+    currentIndex = state.currentIndex;
+    nlists = state.nlists;
+    NP = state.NP;
+    exceptionCount = state.exceptionCount;
+
+    file.readBlock("Exact/Sorter/Lists", linearLists);
+    file.readBlock("Exact/Sorter/CBT", CBT);
+    file.readBlock("Exact/Sorter/Leaf", Leaf);
+
+    const size_t linkBlock = file.findBlock("Exact/Sorter/Links");
+    const size_t countBlock = file.findBlock("Exact/Sorter/EventCounts");
+    if ((file.getCount(linkBlock) != Min.size())
+	|| (file.getCount(countBlock) != Min.size()))
+      M_throw() << "The event lists of the checkpoint do not match the simulation";
+
+    const ExactLinks* links = file.getBlock<ExactLinks>(linkBlock);
+    const uint32_t* eventCounts = file.getBlock<uint32_t>(countBlock);
+    const size_t eventBlock = file.findBlock("Exact/Sorter/Events");
+    const intPart* events = file.getBlock<intPart>(eventBlock);
+    const intPart* const eventsEnd = events + file.getCount(eventBlock);
+
+    for (size_t i(0); i < Min.size(); ++i)
+      {
+	Min[i].next = links[i].next;
+	Min[i].previous = links[i].previous;
+	Min[i].qIndex = links[i].qIndex;
+	if (eventCounts[i] > size_t(eventsEnd - events))
+	  M_throw() << "The event lists of the checkpoint are truncated";
+	Min[i].data.importEvents(events, events + eventCounts[i]);
+	events += eventCounts[i];
+      }
+
+    return true;
+  }
+
 private:
   virtual CSSorter* Clone() const { return new CSSBoundedPQ(*this); };
   ///////////////////////////BOUNDED QUEUE IMPLEMENTATION
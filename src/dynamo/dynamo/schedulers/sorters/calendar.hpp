@@ -0,0 +1,535 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "datastruct.hpp"
+#include "sorter.hpp"
+
+#include "../../dynamics/units/units.hpp"
+#include "../../base/is_simdata.hpp"
+#include <boost/static_assert.hpp>
+#include <boost/lexical_cast.hpp>
+#include <magnet/exception.hpp>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+#ifdef DYNAMO_DEBUG
+#include <boost/math/special_functions/fpclassify.hpp>
+#endif
+
+template<size_t Size>
+class MinMaxHeapPList;
+
+class pList;
+
+class PELSingleEvent;
+
+template<class T>
+struct CSSCalendarQueueName
+{
+  BOOST_STATIC_ASSERT(sizeof(T) == 0);
+};
+
+template<>
+struct CSSCalendarQueueName<pList>
+{
+  inline static std::string name() { return "CalendarQueue"; }
+};
+
+template<size_t I>
+struct CSSCalendarQueueName<MinMaxHeapPList<I> >
+{
+  inline static std::string name() { return std::string("CalendarQueueMinMax") + boost::lexical_cast<std::string>(I); }
+};
+
+template<>
+struct CSSCalendarQueueName<PELSingleEvent>
+{
+  inline static std::string name() { return "CalendarQueueSingleEvent"; }
+};
+
+/*! \brief A self tuning calendar queue.
+ *
+ * Like the CSSBoundedPQ, the particles are binned by the time of
+ * their next event into buckets of a fixed width and the particles
+ * in the current bucket are sorted using a complete binary tree.
+ *
+ * Unlike the CSSBoundedPQ, there is no overflow list. The buckets
+ * wrap around (a "year" of buckets) and each particle remembers the
+ * absolute (virtual) bucket it belongs to, so events far in the
+ * future are only skipped over when their physical bucket is
+ * visited. If a whole year of buckets is empty, the queue jumps
+ * straight to the earliest bucket.
+ *
+ * The bucket width is not a tuning parameter. The mean time between
+ * the events leaving the queue is measured, and whenever the ideal
+ * width (three events per bucket) drifts by more than a factor of two
+ * from the current width, the queue is rebuilt. Every operation is
+ * therefore O(1) amortised, whatever the event time distribution.
+ *
+ * Events at infinite times are kept in the binary tree, as they can
+ * only be the next event when the queue holds no other events.
+ */
+template<typename T = pList>
+class CSSCalendarQueue: public CSSorter
+{
+private:
+  struct eventQEntry
+  {
+    eventQEntry(): next(-1), previous(-1), bucket(0) {}
+
+    T data;
+    int next;
+    int previous;
+    //! Entries with a bucket at or before currentBucket are in the tree
+    long long bucket;
+  };
+
+  //! The bucket of entries with an infinite event time
+  inline static long long infBucket()
+  { return std::numeric_limits<long long>::min(); }
+
+  std::vector<int> buckets;
+  unsigned long long bucketMask;
+  long long currentBucket;
+  double width;
+  double pecTime;
+
+  size_t bucketed;
+  size_t treeFinite;
+  size_t emptyScans;
+
+  //Instrumentation of the event times leaving the queue
+  size_t samples;
+  double sampleStart;
+  double lastSample;
+  size_t retuneCount;
+
+  //Binary tree variables
+  std::vector<unsigned long> CBT;
+  std::vector<unsigned long> Leaf;
+  std::vector<eventQEntry> Min;
+  size_t NP, N;
+
+public:
+  CSSCalendarQueue(const dynamo::SimData* const& SD):
+    CSSorter(SD, "CalendarQueue"),
+    bucketMask(0),
+    currentBucket(0),
+    width(1),
+    retuneCount(0)
+  { clear(); }
+
+  ~CSSCalendarQueue()
+  {
+    dout << "Bucket width retunes = " << retuneCount << std::endl;
+  }
+
+  inline size_t size() const { return Min.size() - 1; }
+  inline bool empty() const { return Min.empty(); }
+
+  inline const double& bucketWidth() const { return width; }
+  inline size_t bucketCount() const { return buckets.size(); }
+  inline const size_t& retunes() const { return retuneCount; }
+
+  void resize(const size_t& a)
+  {
+    checkSize(a);
+    clear();
+    N = a;
+    CBT.resize(2 * N);
+    Leaf.resize(N + 1);
+    Min.resize(N + 1);
+  }
+
+  void clear()
+  {
+    CBT.clear();
+    Leaf.clear();
+    Min.clear();
+    buckets.clear();
+    N = 0;
+    NP = 0;
+    currentBucket = 0;
+    pecTime = 0.0;
+    bucketed = 0;
+    treeFinite = 0;
+    emptyScans = 0;
+    samples = 0;
+    sampleStart = 0;
+    lastSample = -HUGE_VAL;
+  }
+
+  inline void stream(const double& ndt) { pecTime += ndt; }
+
+  void init() { init(false); }
+
+  void rebuild() { init(true); }
+
+  void init(bool quiet)
+  {
+    //Make a first guess of the bucket width by instrumenting the
+    //queue, it is corrected once events are run
+    double minVal(HUGE_VAL), maxVal(-HUGE_VAL);
+    size_t counter(0);
+
+    for (size_t i(1); i <= N; ++i)
+      if (!std::isinf(Min[i].data.getdt()))
+	{
+	  minVal = std::min(minVal, Min[i].data.getdt());
+	  maxVal = std::max(maxVal, Min[i].data.getdt());
+	  ++counter;
+	}
+
+    if ((counter < 2) || (maxVal <= minVal))
+      width = Sim->dynamics.units().unitTime();
+    else
+      width = 3 * (maxVal - minVal) / counter;
+
+    rebuildBuckets();
+
+    if (!quiet)
+      dout << "Calendar of " << buckets.size() << " buckets, bucket width = "
+	   << width / Sim->dynamics.units().unitTime()
+	   << std::endl;
+  }
+
+  inline void push(const intPart& tmpVal, const size_t& pID)
+  {
+#ifdef DYNAMO_DEBUG
+    if (boost::math::isnan(tmpVal.dt))
+      M_throw() << "NaN value pushed into the sorter! Should be Inf I guess?";
+#endif
+
+    tmpVal.dt += pecTime;
+    Min[pID + 1].data.push(tmpVal);
+  }
+
+  inline void update(const size_t& pID)
+  {
+    deleteFromEventQ(pID + 1);
+    insertInEventQ(pID + 1);
+  }
+
+  inline void clearPEL(const size_t& ID) { Min[ID+1].data.clear(); }
+  inline void popNextPELEvent(const size_t& ID) { Min[ID+1].data.pop(); }
+  inline void popNextEvent() { Min[CBT[1]].data.pop(); }
+  inline bool nextPELEmpty() const { return Min[CBT[1]].data.empty(); }
+
+  inline intPart copyNextEvent() const
+  { intPart retval(Min[CBT[1]].data.top());
+    retval.dt -= pecTime;
+    return retval;
+  }
+
+  inline size_t next_ID() const { return CBT[1] - 1; }
+  inline EEventType next_type() const { return Min[CBT[1]].data.top().type; }
+  inline unsigned long next_collCounter2() const { return Min[CBT[1]].data.top().collCounter2; }
+  inline size_t next_p2() const { return Min[CBT[1]].data.top().p2; }
+
+  inline double next_dt() const { return Min[CBT[1]].data.getdt() - pecTime; }
+
+  inline void sort()
+  {
+    orderNextEvent();
+
+    if (!treeFinite) return;
+
+    //Sample the times of the events leaving the queue
+    const double t = Min[CBT[1]].data.getdt();
+    if (t <= lastSample) return;
+
+    if (!samples) sampleStart = t;
+    lastSample = t;
+
+    if (++samples > std::max(N, size_t(64)))
+      retune();
+  }
+
+  inline void rescaleTimes(const double& factor)
+  {
+    BOOST_FOREACH(eventQEntry& dat, Min)
+      dat.data.rescaleTimes(factor);
+
+    //The buckets are unchanged if the width is scaled too
+    pecTime *= factor;
+    width *= factor;
+    sampleStart *= factor;
+    lastSample *= factor;
+  }
+
+private:
+  virtual CSSorter* Clone() const { return new CSSCalendarQueue(*this); };
+
+  ///////////////////////////CALENDAR QUEUE IMPLEMENTATION
+  inline long long bucketOf(const double& t) const
+  {
+    //Clamp the bucket number, distant events are found by the direct
+    //search anyway
+    const double limit = 1e18;
+    const double box = std::floor(t / width);
+    if (box > limit) return static_cast<long long>(limit);
+    if (box < -limit) return -static_cast<long long>(limit);
+    return static_cast<long long>(box);
+  }
+
+  inline int& bucketHead(const long long& b)
+  { return buckets[static_cast<unsigned long long>(b) & bucketMask]; }
+
+  //! Remove the peculiar time and re-bin every event.
+  void rebuildBuckets()
+  {
+    BOOST_FOREACH(eventQEntry& dat, Min)
+      dat.data.stream(pecTime);
+    pecTime = 0;
+
+    //Two buckets per particle, so a year covers several event
+    //generations
+    size_t nbuckets(1);
+    while (nbuckets < 2 * N) nbuckets <<= 1;
+    buckets.assign(nbuckets, -1);
+    bucketMask = nbuckets - 1;
+
+    double minVal(HUGE_VAL);
+    for (size_t i(1); i <= N; ++i)
+      minVal = std::min(minVal, Min[i].data.getdt());
+
+    currentBucket = std::isinf(minVal) ? 0 : bucketOf(minVal);
+
+    NP = 0;
+    bucketed = 0;
+    treeFinite = 0;
+    emptyScans = 0;
+    samples = 0;
+    lastSample = -HUGE_VAL;
+
+    for (size_t i(1); i <= N; ++i)
+      insertInEventQ(i);
+
+    orderNextEvent();
+  }
+
+  //! Adjust the bucket width to the measured event rate.
+  void retune()
+  {
+    const double newWidth = 3 * (lastSample - sampleStart) / (samples - 1);
+    samples = 0;
+
+    if ((newWidth > 0) && ((newWidth > 2 * width) || (newWidth < 0.5 * width)))
+      {
+	width = newWidth;
+	++retuneCount;
+	rebuildBuckets();
+      }
+  }
+
+  //! Shift the time origin by whole years to keep the times small.
+  void rebase()
+  {
+    const long long shift = currentBucket & ~static_cast<long long>(bucketMask);
+    const double dt = shift * width;
+
+    BOOST_FOREACH(eventQEntry& dat, Min)
+      {
+	dat.data.stream(dt);
+	if (dat.bucket != infBucket())
+	  dat.bucket -= shift;
+      }
+
+    currentBucket -= shift;
+    pecTime -= dt;
+    sampleStart -= dt;
+    lastSample -= dt;
+  }
+
+  inline void insertInEventQ(int p)
+  {
+    const double t = Min[p].data.getdt();
+
+    if (std::isinf(t))
+      {
+	Min[p].bucket = infBucket();
+	Insert(p);
+	return;
+      }
+
+    const long long b = bucketOf(t);
+
+    //This also handles negative time events
+    if (b <= currentBucket)
+      {
+	Min[p].bucket = currentBucket;
+	++treeFinite;
+	Insert(p);
+	return;
+      }
+
+    Min[p].bucket = b;
+    int& head = bucketHead(b);
+    Min[p].previous = -1;
+    Min[p].next = head;
+    if (head != -1)
+      Min[head].previous = p;
+    head = p;
+    ++bucketed;
+  }
+
+  inline void unlinkFromBucket(const int& e)
+  {
+    const int prev = Min[e].previous,
+      next = Min[e].next;
+
+    if (prev == -1)
+      bucketHead(Min[e].bucket) = next;
+    else
+      Min[prev].next = next;
+
+    if (next != -1)
+      Min[next].previous = prev;
+
+    --bucketed;
+  }
+
+  inline void deleteFromEventQ(const int& e)
+  {
+    if (Min[e].bucket <= currentBucket)
+      {
+	if (Min[e].bucket != infBucket())
+	  --treeFinite;
+	Delete(e);
+      }
+    else
+      unlinkFromBucket(e);
+  }
+
+  inline void orderNextEvent()
+  {
+    while (!treeFinite && bucketed)
+      {
+	if (emptyScans > bucketMask)
+	  {
+	    //A year of empty buckets, jump to the earliest event
+	    long long first = std::numeric_limits<long long>::max();
+	    BOOST_FOREACH(const int& head, buckets)
+	      for (int e = head; e != -1; e = Min[e].next)
+		first = std::min(first, Min[e].bucket);
+
+	    currentBucket = first - 1;
+	    emptyScans = 0;
+	  }
+
+	++currentBucket;
+
+	//Move this year's entries from the bucket to the tree
+	for (int e = bucketHead(currentBucket); e != -1;)
+	  {
+	    const int next = Min[e].next;
+	    if (Min[e].bucket == currentBucket)
+	      {
+		unlinkFromBucket(e);
+		++treeFinite;
+		Insert(e);
+	      }
+	    e = next;
+	  }
+
+	emptyScans = treeFinite ? 0 : emptyScans + 1;
+      }
+
+    if (currentBucket > static_cast<long long>(bucketMask))
+      rebase();
+  }
+
+  ///////////////////////////BINARY TREE IMPLEMENTATION
+  inline void UpdateCBT(const unsigned int& i)
+  {
+    unsigned int f = Leaf[i] / 2;
+
+    for(; (f > 0) && (CBT[f] == i); f /= 2)
+      {
+	unsigned int l = CBT[f*2],
+	  r = CBT[f*2+1];
+	CBT[f] = (Min[r].data > Min[l].data) ? l : r;
+      }
+
+    //Walk up finding the winners till it doesn't change or you hit
+    //the top of the tree
+    for( ; f>0; f /= 2)
+      {
+	unsigned int w = CBT[f], /* old winner */
+	  l = CBT[f*2],
+	  r = CBT[f*2+1];
+
+	CBT[f] = (Min[r].data > Min[l].data) ? l : r;
+
+	if (CBT[f] == w) return; /* end of the event time comparisons */
+      }
+  }
+
+  inline void Insert(const unsigned int& i)
+  {
+    if (NP)
+      {
+	int j = CBT[NP];
+	CBT [NP*2] = j;
+	CBT [NP*2+1] = i;
+	Leaf[j] = NP*2;
+	Leaf[i]= NP*2+1;
+	++NP;
+	UpdateCBT(j);
+      }
+    else
+      {
+	CBT[1]=i;
+	++NP;
+      }
+  }
+
+  inline void Delete(const unsigned int& i)
+  {
+    if (NP < 2) { CBT[1]=0; Leaf[0]=1; --NP; return; }
+
+    int l = NP * 2 - 1;
+
+    if (CBT[l-1] == i)
+      {
+	Leaf[CBT[l]] = l/2;
+	CBT[l/2] =CBT[l];
+	UpdateCBT(CBT[l]);
+	--NP;
+	return;
+      }
+
+    Leaf[CBT[l-1]] = l/2;
+    CBT[l/2] = CBT[l-1];
+    UpdateCBT(CBT[l-1]);
+
+    if (CBT[l] != i)
+      {
+	CBT[Leaf[i]] = CBT[l];
+	Leaf[CBT[l]] = Leaf[i];
+	UpdateCBT(CBT[l]);
+      }
+
+    --NP;
+  }
+
+  virtual void outputXML(magnet::xml::XmlStream& XML) const
+  { XML << magnet::xml::attr("Type") << CSSCalendarQueueName<T>::name(); }
+};
@@ -18,6 +18,7 @@
 #pragma once
 #include "datastruct.hpp"
 #include "sorter.hpp"
+#include "../../base/binaryconfig.hpp"
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <magnet/exception.hpp>
 #include <magnet/xmlwriter.hpp>
@@ -34,6 +35,16 @@ private:
 
   double pecTime;
 
+  //Layout of the block written by saveState
+  struct ExactState
+  {
+    double pecTime;
+    uint64_t NP;
+    uint64_t N;
+    uint64_t streamFreq;
+    uint64_t nUpdate;
+  };
+
 public:  
   CSSCBT(const dynamo::SimData* const& SD):
     CSSorter(SD, "CBT")
@@ -51,6 +62,7 @@ public:
 
   void resize(const size_t& a)
   {
+    checkSize(a);
     clear();
     streamFreq = N = a;
     CBT.resize(2 * N);
@@ -146,6 +158,76 @@ public:
 
   virtual CSSorter* Clone() const { return new CSSCBT(*this); }
 
+  bool saveState(dynamo::BinaryConfigWriter& file) const
+  {
+    const std::string type("CBT");
+    file.writeBlock("Exact/Sorter/Type", std::vector<char>(type.begin(), type.end()));
+
+    ExactState state;
+    state.pecTime = pecTime;
+    state.NP = NP;
+    state.N = N;
+    state.streamFreq = streamFreq;
+    state.nUpdate = nUpdate;
+    file.writeValue("Exact/Sorter", state);
+
+    file.writeBlock("Exact/Sorter/CBT", CBT);
+    file.writeBlock("Exact/Sorter/Leaf", Leaf);
+
+    std::vector<intPart> events;
+    std::vector<uint32_t> eventCounts(Min.size());
+    for (size_t i(0); i < Min.size(); ++i)
+      {
+	const size_t start = events.size();
+	Min[i].exportEvents(events);
+	eventCounts[i] = events.size() - start;
+      }
+
+    file.writeBlock("Exact/Sorter/EventCounts", eventCounts);
+    file.writeBlock("Exact/Sorter/Events", events);
+    return true;
+  }
+
+  bool loadState(const dynamo::BinaryConfigReader& file)
+  {
+    std::vector<char> type;
+    file.readBlock("Exact/Sorter/Type", type);
+    if (std::string(type.begin(), type.end()) != "CBT")
+      return false;
+
+    const ExactState state = file.readValue<ExactState>("Exact/Sorter");
+    if (state.N != N)
+      M_throw() << "The event queue of the checkpoint is for " << state.N
+		<< " particles, not " << N;
+
+    pecTime = state.pecTime;
+    NP = state.NP;
+    streamFreq = state.streamFreq;
+    nUpdate = state.nUpdate;
+
+    file.readBlock("Exact/Sorter/CBT", CBT);
+    file.readBlock("Exact/Sorter/Leaf", Leaf);
+
+    const size_t countBlock = file.findBlock("Exact/Sorter/EventCounts");
+    if (file.getCount(countBlock) != Min.size())
+      M_throw() << "The event lists of the checkpoint do not match the simulation";
+
+    const uint32_t* eventCounts = file.getBlock<uint32_t>(countBlock);
+    const size_t eventBlock = file.findBlock("Exact/Sorter/Events");
+    const intPart* events = file.getBlock<intPart>(eventBlock);
+    const intPart* const eventsEnd = events + file.getCount(eventBlock);
+
+    for (size_t i(0); i < Min.size(); ++i)
+      {
+	if (eventCounts[i] > size_t(eventsEnd - events))
+	  M_throw() << "The event lists of the checkpoint are truncated";
+	Min[i].importEvents(events, events + eventCounts[i]);
+	events += eventCounts[i];
+      }
+
+    return true;
+  }
+
 private:
   inline void UpdateCBT(unsigned int i)
   {
@@ -22,59 +22,71 @@
 #include "../../dynamics/locals/localEvent.hpp"
 #include "../../dynamics/globals/global.hpp"
 #include <boost/foreach.hpp>
+#include <boost/static_assert.hpp>
 #include <queue>
-
-//Datatype for a single event, stored in lists for each particle
+#include <stdint.h>
+
+/*! \brief Datatype for a single event, stored in lists for each particle.
+ *
+ * This is packed into 16 bytes, as the event lists are the largest
+ * data structure in the simulation. The event type is folded into the
+ * top bits of the partner ID, limiting the partner ID (and thus the
+ * number of particles) to maxID(), and the collision counter is
+ * compared modulo 2^32.
+ */
 class intPart
 {
 public:   
   inline intPart():
     dt(HUGE_VAL),
-    collCounter2(std::numeric_limits<unsigned long>::max()),
-    type(NONE),
-    p2(std::numeric_limits<size_t>::max())    
+    collCounter2(std::numeric_limits<uint32_t>::max()),
+    p2(maxID()),
+    type(NONE)
   {}
 
   inline intPart(const double& ndt, const EEventType& nT) throw():
     dt(ndt),
-    type(nT),
-    p2(0)
+    p2(0),
+    type(nT)
   {}
 
   inline intPart(const double& ndt, const unsigned long & direction) throw():
     dt(ndt),
     collCounter2(direction),
-    type(CELL),
-    p2(0)
+    p2(0),
+    type(CELL)
   {}
   
   inline intPart(const double& ndt, const EEventType& nT, 
 		 const size_t& nID2, const unsigned long & nCC2) throw():
     dt(ndt),
     collCounter2(nCC2),
-    type(nT),
-    p2(nID2)
+    p2(nID2),
+    type(nT)
     {}
 
   inline intPart(const IntEvent& coll, const unsigned long& nCC2) throw():
     dt(coll.getdt()),
     collCounter2(nCC2),
-    type(INTERACTION),
-    p2(coll.getParticle2ID())
+    p2(coll.getParticle2ID()),
+    type(INTERACTION)
   {}
 
   inline intPart(const GlobalEvent& coll) throw():
     dt(coll.getdt()),
-    type(GLOBAL),
-    p2(coll.getGlobalID())
+    p2(coll.getGlobalID()),
+    type(GLOBAL)
   {}
 
   inline intPart(const LocalEvent& coll) throw():
     dt(coll.getdt()),
-    type(LOCAL),
-    p2(coll.getLocalID())
+    p2(coll.getLocalID()),
+    type(LOCAL)
   {}
 
+  //! The largest partner ID which can be stored.
+  inline static size_t maxID() { return (size_t(1) << 27) - 1; }
+
   inline bool operator< (const intPart& ip) const throw()
   { return dt < ip.dt; }
 
@@ -84,11 +96,14 @@ public:
   inline void stream(const double& ndt) throw() { dt -= ndt; }
 
   mutable double dt;
-  unsigned long collCounter2;
-  EEventType type;
-  size_t p2;  
+  uint32_t collCounter2;
+  uint32_t p2 : 27;
+  EEventType type : 5;
 };
 
+BOOST_STATIC_ASSERT(CORRECT < 32);
+BOOST_STATIC_ASSERT(sizeof(intPart) == 16);
+
 typedef std::vector<intPart> qType;
 typedef std::priority_queue<intPart, qType, 
 			    std::greater<intPart> > pList_q_type;
@@ -161,6 +176,14 @@ public:
   {
     c.swap(rhs.c);
   }
+
+  //! Append the events to an array, see CSSorter::saveState.
+  inline void exportEvents(qType& events) const
+  { events.insert(events.end(), c.begin(), c.end()); }
+
+  //! Replace the events with those written by exportEvents.
+  inline void importEvents(const intPart* first, const intPart* last)
+  { c.assign(first, last); }
 };
 
 namespace std
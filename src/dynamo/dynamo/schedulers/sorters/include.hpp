@@ -17,5 +17,6 @@
 
 #include "cbt.hpp"
 #include "boundedPQ.hpp"
+#include "calendar.hpp"
 #include "MinMaxHeap.hpp"
 #include "SingleEvent.hpp"
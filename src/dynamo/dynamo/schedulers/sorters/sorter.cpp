@@ -24,6 +24,14 @@ CSSorter::CSSorter(const dynamo::SimData* const& SD, const char *aName):
   SimBase_const(SD, aName)
 {}
 
+void
+CSSorter::checkSize(const size_t& N)
+{
+  if (N > intPart::maxID())
+    M_throw() << "Cannot sort the events of " << N << " particles, the event"
+      " lists are limited to " << intPart::maxID() << " particles";
+}
+
 CSSorter* 
 CSSorter::getClass(const magnet::xml::Node& XML, const dynamo::SimData* Sim)
 {
@@ -45,6 +53,12 @@ CSSorter::getClass(const magnet::xml::Node& XML, const dynamo::SimData* Sim)
     return new CSSBoundedPQ<MinMaxHeapPList<7> >(Sim);
   if (std::string(XML.getAttribute("Type")) == CSSBoundedPQName<MinMaxHeapPList<8> >::name())
     return new CSSBoundedPQ<MinMaxHeapPList<8> >(Sim);
+  if (std::string(XML.getAttribute("Type")) == CSSCalendarQueueName<pList>::name())
+    return new CSSCalendarQueue<>(Sim);
+  if (std::string(XML.getAttribute("Type")) == CSSCalendarQueueName<PELSingleEvent>::name())
+    return new CSSCalendarQueue<PELSingleEvent>(Sim);
+  if (std::string(XML.getAttribute("Type")) == CSSCalendarQueueName<MinMaxHeapPList<3> >::name())
+    return new CSSCalendarQueue<MinMaxHeapPList<3> >(Sim);
   else if (std::string(XML.getAttribute("Type")) == std::string("CBT"))
     return new CSSCBT(Sim);
   else 
@@ -22,6 +22,7 @@
 
 namespace magnet { namespace xml { class Node; } } 
 namespace xml { class XmlStream; } 
+namespace dynamo { class BinaryConfigWriter; class BinaryConfigReader; }
 
 class CSSorter: public dynamo::SimBase_const
 {
@@ -58,12 +59,33 @@ public:
 
   //! Fetch the next event in the list, 
   virtual intPart   copyNextEvent() const               = 0;
+
+  /*! \brief Write the complete state of the sorter, including the
+   * event lists, to "Exact/Sorter/..." blocks of an exact checkpoint.
+   *
+   * \return False if this sorter cannot save its state, in which
+   * case the events are rebuilt when the simulation is restarted.
+   */
+  virtual bool saveState(dynamo::BinaryConfigWriter&) const { return false; }
+
+  /*! \brief Restore the state written by saveState.
+   *
+   * The sorter must already be sized for the simulation.
+   * \return False if the checkpoint holds no state for this type of
+   * sorter.
+   */
+  virtual bool loadState(const dynamo::BinaryConfigReader&) { return false; }
+
   virtual CSSorter* Clone()                          const = 0;
 
   static CSSorter* getClass(const magnet::xml::Node&, const dynamo::SimData*);
 
   friend magnet::xml::XmlStream& operator<<(magnet::xml::XmlStream&, const CSSorter&);
 
+protected:
+  //! Check the particle IDs fit in an intPart.
+  static void checkSize(const size_t&);
+
 private:
   virtual void outputXML(magnet::xml::XmlStream&) const = 0;
   
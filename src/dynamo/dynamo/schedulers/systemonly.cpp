@@ -58,6 +58,8 @@ CSSystemOnly::initialise()
 
   if (Sim->dynamics.getSystemEvents().empty())
     M_throw() << "A SystemOnlyScheduler used when there are no system events?";
+
+  if (restoreEventQueue()) return;
   
   sorter->clear();
   sorter->resize(Sim->N+1);
@@ -29,13 +29,13 @@
 #include "../dynamics/locals/local.hpp"
 #include "../dynamics/locals/localEvent.hpp"
 #include <magnet/xmlreader.hpp>
-#include <boost/bind.hpp>
-#include <boost/progress.hpp>
 #include <cmath> //for huge val
 
 SThreadedNBList::SThreadedNBList(const magnet::xml::Node& XML, 
 				 dynamo::SimData* const Sim):
-  CSNeighbourList(XML, Sim)
+  CSNeighbourList(XML, Sim),
+  _p1(NULL),
+  _p2(NULL)
 { 
   //The operator<<(XML) is virtual but the object is of type
   //CSNeighbourList when it is called
@@ -46,17 +46,35 @@ SThreadedNBList::SThreadedNBList(const magnet::xml::Node& XML,
 
 SThreadedNBList::SThreadedNBList(dynamo::SimData* const Sim, CSSorter* ns, 
 				 size_t threadCount):
-  CSNeighbourList(Sim, ns)
+  CSNeighbourList(Sim, ns),
+  _p1(NULL),
+  _p2(NULL)
 { 
   dout << "Threaded Variant Loaded" << std::endl; 
-  _threadPool.setThreadCount(threadCount);
+  setThreadCount(threadCount);
 }
 
 void 
 SThreadedNBList::operator<<(const magnet::xml::Node& XML)
 {
   CSNeighbourList::operator<<(XML);
-  _threadPool.setThreadCount(XML.getAttribute("ThreadCount").as<size_t>());
+  setThreadCount(XML.getAttribute("ThreadCount").as<size_t>());
+}
+
+void 
+SThreadedNBList::setThreadCount(size_t threadCount)
+{
+  _threadPool.setThreadCount(threadCount);
+  //With no threads in the pool, the tasks are run by the calling
+  //thread inside TaskGroup::wait(), so we still need one slice.
+  const size_t slices = std::max(threadCount, size_t(1));
+  _eventBuffers.resize(slices);
+
+  _sliceTasks.clear();
+  for (size_t slice(0); slice < slices; ++slice)
+    _sliceTasks.push_back(magnet::function::Task1<void, size_t>
+			  (magnet::function::MakeDelegate(this, &SThreadedNBList::threadPredictEvents), 
+			   slice));
 }
 
 void 
@@ -70,79 +88,42 @@ SThreadedNBList::outputXML(magnet::xml::XmlStream& XML) const
 }
 
 void 
-SThreadedNBList::addEvents(const Particle& part)
+SThreadedNBList::fullUpdate(const Particle& part)
 {
-  Sim->dynamics.getLiouvillean().updateParticle(part);
-  
-  //Add the global events
-  BOOST_FOREACH(const magnet::ClonePtr<Global>& glob, Sim->dynamics.getGlobals())
-    if (glob->isInteraction(part))
-      sorter->push(glob->getEvent(part), part.getID());
-  
+  //The sorting is charged to SORT by sort()
+  dynamo::EventProfile::Scope profile(_profile, dynamo::EventProfile::PREDICT);
+
 #ifdef DYNAMO_DEBUG
-  if (dynamic_cast<const CGNeighbourList*>
-      (Sim->dynamics.getGlobals()[NBListID].get_ptr())
-      == NULL)
-    M_throw() << "Not a CGNeighbourList!";
+  if (dynamic_cast<const CGNeighbourList*>(Sim->dynamics.getGlobals()[NBListID].get_ptr())
+      == NULL)  M_throw() << "Not a CGNeighbourList!";
 #endif
 
-  //Grab a reference to the neighbour list
   const CGNeighbourList& nblist(*static_cast<const CGNeighbourList*>
-				(Sim->dynamics.getGlobals()[NBListID]
-				 .get_ptr()));
-  
-  //Add the local cell events
-  nblist.getParticleLocalNeighbourhood
-    (part, magnet::function::MakeDelegate(this, &CScheduler::addLocalEvent));
+				(Sim->dynamics.getGlobals()[NBListID].get_ptr()));
 
-  //Add the interaction events
-  nblist.getParticleNeighbourhood
-    (part, magnet::function::MakeDelegate(this, &SThreadedNBList::streamParticles));  
+  _nbIDs1.clear();
+  _nbIDs2.clear();
+  nblist.getParticleNeighbourhood(part, magnet::function::MakeDelegate(this, &SThreadedNBList::addNBID1));
 
-  nblist.getParticleNeighbourhood
-    (part, magnet::function::MakeDelegate(this, &SThreadedNBList::addEvents2));  
-}
-
-void 
-SThreadedNBList::addEventsInit(const Particle& part)
-{  
+  //Stream all of the particles up to date
   Sim->dynamics.getLiouvillean().updateParticle(part);
+  BOOST_FOREACH(const size_t& ID, _nbIDs1) 
+    Sim->dynamics.getLiouvillean().updateParticle(Sim->particleList[ID]);
 
-  //Add the global events
-  BOOST_FOREACH(const magnet::ClonePtr<Global>& glob, Sim->dynamics.getGlobals())
-    if (glob->isInteraction(part))
-      sorter->push(glob->getEvent(part), part.getID());
-  
-#ifdef DYNAMO_DEBUG
-  if (dynamic_cast<const CGNeighbourList*>
-      (Sim->dynamics.getGlobals()[NBListID].get_ptr())
-      == NULL)
-    M_throw() << "Not a CGNeighbourList!";
-#endif
+  invalidateEvents(part);
 
-  //Grab a reference to the neighbour list
-  const CGNeighbourList& nblist(*static_cast<const CGNeighbourList*>
-				(Sim->dynamics.getGlobals()[NBListID]
-				 .get_ptr()));
-  
-  //Add the local cell events
-  nblist.getParticleLocalNeighbourhood
-    (part, magnet::function::MakeDelegate(this, &CScheduler::addLocalEvent));
+  _p1 = &part;
+  _p2 = NULL;
+  addEventsParallel();
 
-  //Add the interaction events
-  nblist.getParticleNeighbourhood
-    (part, magnet::function::MakeDelegate(this, &CScheduler::addInteractionEventInit));  
+  sort(part);
 }
 
-struct NBlistData {
-  void AddNBIDs(const Particle&p1, const size_t& ID) { nbIDs.push_back(ID); }
-  
-  std::vector<size_t> nbIDs;
-};
-
 void 
 SThreadedNBList::fullUpdate(const Particle& p1, const Particle& p2)
 {
+  dynamo::EventProfile::Scope profile(_profile, dynamo::EventProfile::PREDICT);
+
 #ifdef DYNAMO_DEBUG
   if (dynamic_cast<const CGNeighbourList*>(Sim->dynamics.getGlobals()[NBListID].get_ptr())
       == NULL)  M_throw() << "Not a CGNeighbourList!";
@@ -153,15 +134,20 @@ SThreadedNBList::fullUpdate(const Particle& p1, const Particle& p2)
 				(Sim->dynamics.getGlobals()[NBListID].get_ptr()));
 
   //Now fetch the neighborlist data
-  NBlistData nbIDs1, nbIDs2;  
-  nblist.getParticleNeighbourhood(p1, magnet::function::MakeDelegate(&nbIDs1, &NBlistData::AddNBIDs));
-  nblist.getParticleNeighbourhood(p2, magnet::function::MakeDelegate(&nbIDs2, &NBlistData::AddNBIDs));
+  _nbIDs1.clear();
+  _nbIDs2.clear();
+  nblist.getParticleNeighbourhood(p1, magnet::function::MakeDelegate(this, &SThreadedNBList::addNBID1));
+  nblist.getParticleNeighbourhood(p2, magnet::function::MakeDelegate(this, &SThreadedNBList::addNBID2));
   
-  //Stream all of the particles up to date
+  //Stream all of the particles up to date. This is done serially as
+  //the two neighbourhoods overlap and the streaming writes to the
+  //particles.
   Sim->dynamics.getLiouvillean().updateParticle(p1);
   Sim->dynamics.getLiouvillean().updateParticle(p2);
-  BOOST_FOREACH(const size_t& ID, nbIDs1.nbIDs) Sim->dynamics.getLiouvillean().updateParticle(Sim->particleList[ID]);
-  BOOST_FOREACH(const size_t& ID, nbIDs2.nbIDs) Sim->dynamics.getLiouvillean().updateParticle(Sim->particleList[ID]);
+  BOOST_FOREACH(const size_t& ID, _nbIDs1) 
+    Sim->dynamics.getLiouvillean().updateParticle(Sim->particleList[ID]);
+  BOOST_FOREACH(const size_t& ID, _nbIDs2) 
+    Sim->dynamics.getLiouvillean().updateParticle(Sim->particleList[ID]);
 
   //Both particles events must be invalidated at once
   ++eventCount[p1.getID()];
@@ -170,123 +156,89 @@ SThreadedNBList::fullUpdate(const Particle& p1, const Particle& p2)
   sorter->clearPEL(p1.getID());
   sorter->clearPEL(p2.getID());
 
-  //Add the interaction events, these can churn while try to add the other events
-  BOOST_FOREACH(const size_t& ID, nbIDs1.nbIDs) 
-    _threadPool.queueTask(magnet::function::Task::makeTask(&SThreadedNBList::threadAddIntEvent, 
-						     this, p1, ID, _P1SorterLock));
-
-  BOOST_FOREACH(const size_t& ID, nbIDs2.nbIDs) 
-    _threadPool.queueTask(magnet::function::Task::makeTask(&SThreadedNBList::threadAddIntEvent, 
-						     this, p2, ID, _P2SorterLock));
-
-  //Add the global events
-  BOOST_FOREACH(const magnet::ClonePtr<Global>& glob, Sim->dynamics.getGlobals())
-    {
-      if (glob->isInteraction(p1))
-	_threadPool.queueTask(magnet::function::Task::makeTask(&SThreadedNBList::addGlobal, 
-							 this, p1, glob, _P1SorterLock));
-
-      if (glob->isInteraction(p2))
-	_threadPool.queueTask(magnet::function::Task::makeTask(&SThreadedNBList::addGlobal, 
-							 this, p2, glob, _P2SorterLock));
-    }
-  
-  //Add the local cell events
-  nblist.getParticleLocalNeighbourhood
-    (p1, magnet::function::MakeDelegate(this, &SThreadedNBList::spawnThreadAddLocalEvent1));
-
-  nblist.getParticleLocalNeighbourhood
-    (p2, magnet::function::MakeDelegate(this, &SThreadedNBList::spawnThreadAddLocalEvent2));
-    
-  //Now wait for the pool
-  _threadPool.wait();
+  _p1 = &p1;
+  _p2 = &p2;
+  addEventsParallel();
 
+  dynamo::EventProfile::Scope sorting(_profile, dynamo::EventProfile::SORT);
   sorter->update(p1.getID());
   sorter->update(p2.getID());
 }
 
 void 
-SThreadedNBList::addGlobal(const Particle& part, const magnet::ClonePtr<Global>& glob, magnet::thread::Mutex& sorterLock)
+SThreadedNBList::addEventsParallel()
 {
-  GlobalEvent event = glob->getEvent(part);
-
-  magnet::thread::ScopedLock lock1(sorterLock);      
-  sorter->push(event, part.getID());
-}
+  //Set the threads predicting the interaction events. 
+  magnet::thread::TaskGroup group(_threadPool);
+  for (size_t slice(0); slice < _sliceTasks.size(); ++slice)
+    group.spawn(_sliceTasks[slice]);
 
-void 
-SThreadedNBList::fullUpdate(const Particle& part)
-{
-  invalidateEvents(part);
-  addEvents(part);
-  sort(part);
-}
+  //While the pool churns, this thread adds the global and local
+  //events directly into the sorter. The pool threads never touch the
+  //sorter so no locking is required.
+  addNonInteractionEvents(*_p1);
+  if (_p2 != NULL) addNonInteractionEvents(*_p2);
 
-void 
-SThreadedNBList::spawnThreadAddLocalEvent1(const Particle& part, 
-					  const size_t& id) 
-{
-  if (Sim->dynamics.getLocals()[id]->isInteraction(part))
-    _threadPool.queueTask(magnet::function::Task::makeTask(&SThreadedNBList::threadAddLocalEvent, 
-							   this, part, id, _P1SorterLock));
-}
+  group.wait();
 
-void 
-SThreadedNBList::spawnThreadAddLocalEvent2(const Particle& part, 
-					  const size_t& id) 
-{
-  if (Sim->dynamics.getLocals()[id]->isInteraction(part))
-    _threadPool.queueTask(magnet::function::Task::makeTask(&SThreadedNBList::threadAddLocalEvent, 
-							   this, part, id, _P2SorterLock));
-}
-
-void 
-SThreadedNBList::threadAddIntEvent(const Particle& part, 
-				   const size_t id,
-				   magnet::thread::Mutex& sorterLock)
-{
-  const IntEvent& eevent(Sim->dynamics.getEvent(part, Sim->particleList[id]));
-  
-  if (eevent.getType() != NONE)
+  //Merge the per-thread buffers into the sorter
+  BOOST_FOREACH(const EventBuffer& buffer, _eventBuffers)
     {
-      magnet::thread::ScopedLock lock1(sorterLock);
-      sorter->push(intPart(eevent, eventCount[id]), part.getID());
+      BOOST_FOREACH(const intPart& event, buffer.p1Events)
+	sorter->push(event, _p1->getID());
+
+      BOOST_FOREACH(const intPart& event, buffer.p2Events)
+	sorter->push(event, _p2->getID());
     }
 }
 
 void 
-SThreadedNBList::threadAddLocalEvent(const Particle& part, 
-				     const size_t id,
-				     magnet::thread::Mutex& sorterLock)
+SThreadedNBList::addNonInteractionEvents(const Particle& part)
 {
-  LocalEvent Event = Sim->dynamics.getLocals()[id]->getEvent(part);
-
-  {
-    magnet::thread::ScopedLock lock1(sorterLock);
-    sorter->push(Event, part.getID());  
-  }
-}
+  //Add the global events
+  BOOST_FOREACH(const magnet::ClonePtr<Global>& glob, Sim->dynamics.getGlobals())
+    if (glob->isInteraction(part))
+      sorter->push(glob->getEvent(part), part.getID());
 
+  const CGNeighbourList& nblist(*static_cast<const CGNeighbourList*>
+				(Sim->dynamics.getGlobals()[NBListID].get_ptr()));
 
-void 
-SThreadedNBList::threadStreamParticles(const size_t id) const
-{
-  Sim->dynamics.getLiouvillean().updateParticle(Sim->particleList[id]);
+  //Add the local cell events
+  nblist.getParticleLocalNeighbourhood
+    (part, magnet::function::MakeDelegate(this, &CScheduler::addLocalEvent));
 }
 
 void 
-SThreadedNBList::streamParticles(const Particle& part, 
-				 const size_t& id) const
+SThreadedNBList::threadPredictEvents(const size_t slice)
 {
-  Sim->dynamics.getLiouvillean().updateParticle(Sim->particleList[id]);
-}
-
-void 
-SThreadedNBList::addEvents2(const Particle& part, 
-			    const size_t& id) const
+  EventBuffer& buffer(_eventBuffers[slice]);
+  buffer.p1Events.clear();
+  buffer.p2Events.clear();
+
+  //The neighbours of both particles are treated as one work list,
+  //which is divided evenly between the slices
+  const size_t n1 = _nbIDs1.size();
+  const size_t total = n1 + _nbIDs2.size();
+  const size_t start = (total * slice) / _eventBuffers.size();
+  const size_t end = (total * (slice + 1)) / _eventBuffers.size();
+
+  //Each part of the slice is predicted as one batch
+  if (start < std::min(end, n1))
+    predictEvents(*_p1, &_nbIDs1[start], std::min(end, n1) - start, 
+		  buffer, buffer.p1Events);
+
+  if (std::max(start, n1) < end)
+    predictEvents(*_p2, &_nbIDs2[std::max(start, n1) - n1], end - std::max(start, n1),
+		  buffer, buffer.p2Events);
+}
+
+void
+SThreadedNBList::predictEvents(const Particle& part, const size_t* ids, size_t N,
+			       EventBuffer& buffer, std::vector<intPart>& events)
 {
-  const IntEvent& eevent(Sim->dynamics.getEvent(part, Sim->particleList[id]));
-  
-  if (eevent.getType() != NONE)
-    sorter->push(intPart(eevent, eventCount[id]), part.getID());
+  buffer.events.clear();
+  Sim->dynamics.getEvents(part, ids, N, buffer.events);
+
+  BOOST_FOREACH(const IntEvent& eevent, buffer.events)
+    events.push_back(intPart(eevent, eventCount[eevent.getParticle2ID()]));
 }
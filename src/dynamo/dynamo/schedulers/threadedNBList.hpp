@@ -18,8 +18,23 @@
 #pragma once
 
 #include "neighbourlist.hpp"
-#include <magnet/thread/threadpool.hpp>
-
+#include "sorters/datastruct.hpp"
+#include <magnet/thread/workstealing.hpp>
+#include <vector>
+
+/*! \brief A neighbour list scheduler which recalculates the
+ * interaction events of a particle using a pool of threads.
+ *
+ * The neighbour IDs of the updated particle(s) are gathered into a
+ * single work list which is split into one contiguous slice per
+ * thread. Each thread writes the events it finds into its own
+ * EventBuffer, so no locking is required while the events are being
+ * predicted. Once all threads have finished, the buffers are merged
+ * into the sorter by the calling thread. The slice tasks are spawned
+ * into a TaskGroup of a work-stealing pool, and the tasks, buffers
+ * and work lists are only ever reused, never freed, so after the
+ * first few events the recalculation performs no heap allocation.
+ */
 class SThreadedNBList: public CSNeighbourList
 {
 public:
@@ -27,44 +42,69 @@ public:
 
   SThreadedNBList(dynamo::SimData* const, CSSorter*, size_t threadCount);
 
-  virtual void addEvents(const Particle&);
-  
   virtual void operator<<(const magnet::xml::Node&);
 
   virtual void fullUpdate(const Particle& part);
 
   virtual void fullUpdate(const Particle& p1, const Particle& p2);
 
-  void threadAddLocalEvent(const Particle& part, 
-			   const size_t id,
-			   magnet::thread::Mutex& sorterLock);
-
-  void threadAddIntEvent(const Particle& part, 
-			 const size_t id,
-			 magnet::thread::Mutex& sorterLock);
-
-  void spawnThreadAddLocalEvent1(const Particle& part, 
-				const size_t& id);
-
-  void spawnThreadAddLocalEvent2(const Particle& part, 
-				 const size_t& id);
-
-  void threadStreamParticles(const size_t id) const;
-
-  void streamParticles(const Particle& part, const size_t& id) const;
-
-  void addEvents2(const Particle& part, const size_t& id) const;
-
 protected:
   virtual void outputXML(magnet::xml::XmlStream&) const;
 
-  void addEventsInit(const Particle&);
-
-  void addGlobal(const Particle& p1, const magnet::ClonePtr<Global>& glob, magnet::thread::Mutex& sorterLock);
-
-  magnet::thread::ThreadPool _threadPool;
-
-  magnet::thread::Mutex _P1SorterLock;
-  magnet::thread::Mutex _P2SorterLock;
-  
+  /*! \brief Per-thread storage for the predicted interaction
+   * events. 
+   *
+   * The padding keeps the buffers of neighbouring threads on
+   * separate cache lines, as each push_back writes to the vector's
+   * end pointer.
+   */
+  struct EventBuffer
+  {
+    std::vector<intPart> p1Events;
+    std::vector<intPart> p2Events;
+    //! Reused storage for the events of each batch.
+    std::vector<IntEvent> events;
+    char _padding[64];
+  };
+
+  void setThreadCount(size_t);
+
+  //! Delegate target to collect the neighbours of the first particle.
+  void addNBID1(const Particle&, const size_t& ID) { _nbIDs1.push_back(ID); }
+  //! Delegate target to collect the neighbours of the second particle.
+  void addNBID2(const Particle&, const size_t& ID) { _nbIDs2.push_back(ID); }
+
+  /*! \brief Predict the interaction events of a slice of the work list.
+   *
+   * This is the task executed by each thread of the pool, it only
+   * reads the simulation state and writes to _eventBuffers[slice].
+   */
+  void threadPredictEvents(const size_t slice);
+
+  //! Predict the events of part with a batch of its neighbours.
+  void predictEvents(const Particle& part, const size_t* ids, size_t N,
+		     EventBuffer& buffer, std::vector<intPart>& events);
+
+  /*! \brief Calculate and push all events for _p1 (and _p2 if not
+   * NULL) into the sorter.
+   *
+   * The neighbour work lists must have been filled and the particles
+   * streamed before this is called.
+   */
+  void addEventsParallel();
+
+  void addNonInteractionEvents(const Particle& part);
+
+  magnet::thread::WorkStealingPool _threadPool;
+
+  std::vector<EventBuffer> _eventBuffers;
+
+  //! One reusable task per slice of the work list.
+  std::vector<magnet::function::Task1<void, size_t> > _sliceTasks;
+
+  std::vector<size_t> _nbIDs1;
+  std::vector<size_t> _nbIDs2;
+
+  const Particle* _p1;
+  const Particle* _p2;
 };
@@ -20,6 +20,7 @@
 #include <magnet/xmlreader.hpp>
 #include <magnet/thread/refPtr.hpp>
 #include <magnet/units.hpp>
+#include <dynamo/base/binaryconfig.hpp>
 #include <vector>
 #include <string>
 #include <algorithm>
@@ -77,6 +78,26 @@ public:
   inline virtual void outputParticleXMLData(magnet::xml::XmlStream& XML, 
 					    const size_t pID) const {}
 
+  //! Write any per-particle data of this Property to a block of a
+  //! binary configuration file.
+  inline virtual void outputParticleBinaryData(dynamo::BinaryConfigWriter&) const {}
+
+  //! Load any per-particle data of this Property from a binary
+  //! configuration file.
+  inline virtual void loadParticleBinaryData(const dynamo::BinaryConfigReader&) {}
+
+  //! Append the values of this Property, exactly as they are held
+  //! in the simulation, to \p values.
+  inline virtual void saveValues(std::vector<double>& values) const {}
+
+  //! Restore the values written by saveValues.
+  //! \return A pointer past the last value used.
+  inline virtual const double* loadValues(const double* values) { return values; }
+
+  //! Reorder the per-particle data of this Property, the particle
+  //! with ID \p i takes the data of the particle with ID oldID[i].
+  inline virtual void permuteParticles(const std::vector<size_t>& oldID) {}
+
 protected:
   virtual void outputXML(magnet::xml::XmlStream& XML) const 
   { M_throw() << "Unimplemented"; }
@@ -111,6 +132,12 @@ public:
 					const double rescale)
   { _val *= std::pow(rescale, _units.getUnitsPower(dim));  }
 
+  inline virtual void saveValues(std::vector<double>& values) const
+  { values.push_back(_val); }
+
+  inline virtual const double* loadValues(const double* values)
+  { _val = *values; return values + 1; }
+
 private:
   //! The name of this class is its value. So when other classes
   //! output the name of the property, this counts as outputing the
@@ -184,6 +211,40 @@ public:
 
   inline void outputParticleXMLData(magnet::xml::XmlStream& XML, const size_t pID) const
   { XML << magnet::xml::attr(_name) << getProperty(pID); }
+
+  //! The values are stored in a block named after the property.
+  inline void outputParticleBinaryData(dynamo::BinaryConfigWriter& file) const
+  {
+    file.beginBlock("Property/" + _name, sizeof(double));
+    if (!_values.empty())
+      file.write(&_values[0], sizeof(double) * _values.size());
+    file.endBlock();
+  }
+
+  inline void loadParticleBinaryData(const dynamo::BinaryConfigReader& file)
+  {
+    const size_t block = file.findBlock("Property/" + _name);
+    const double* values = file.getBlock<double>(block);
+    _values.assign(values, values + file.getCount(block));
+  }
+
+  inline virtual void saveValues(std::vector<double>& values) const
+  { values.insert(values.end(), _values.begin(), _values.end()); }
+
+  inline virtual const double* loadValues(const double* values)
+  { 
+    std::copy(values, values + _values.size(), _values.begin());
+    return values + _values.size();
+  }
+
+  inline virtual void permuteParticles(const std::vector<size_t>& oldID)
+  {
+    Container values;
+    values.reserve(_values.size());
+    for (size_t ID(0); ID < oldID.size(); ++ID)
+      values.push_back(_values[oldID[ID]]);
+    _values.swap(values);
+  }
   
   
 protected:
@@ -224,6 +285,20 @@ class PropertyStore
 
   typedef Container::iterator iterator;
 
+  //! \brief Collect the values of all Property-s, see outputExactState.
+  inline std::vector<double> saveValues() const
+  {
+    std::vector<double> values;
+    for (Container::const_iterator iPtr = _numericProperties.begin(); 
+	 iPtr != _numericProperties.end(); ++iPtr)
+      (*iPtr)->saveValues(values);
+
+    for (Container::const_iterator iPtr = _namedProperties.begin(); 
+	 iPtr != _namedProperties.end(); ++iPtr)
+      (*iPtr)->saveValues(values);
+    return values;
+  }
+
 public:
   typedef Container::const_iterator const_iterator;
 
@@ -330,6 +405,65 @@ public:
       (*iPtr)->outputParticleXMLData(XML, pID);
   }
 
+  //! \brief Write the per-particle data of the Property-s to blocks
+  //! of a binary configuration file.
+  inline void outputParticleBinaryData(dynamo::BinaryConfigWriter& file) const
+  {
+    for (const_iterator iPtr = _namedProperties.begin(); 
+	 iPtr != _namedProperties.end(); ++iPtr)
+      (*iPtr)->outputParticleBinaryData(file);
+  }
+
+  //! \brief Load the per-particle data of the Property-s from the
+  //! blocks of a binary configuration file.
+  //!
+  //! This must be called after the Property-s are loaded from the
+  //! XML of the file, which then has no particle data.
+  inline void loadParticleBinaryData(const dynamo::BinaryConfigReader& file)
+  {
+    for (iterator iPtr = _namedProperties.begin(); 
+	 iPtr != _namedProperties.end(); ++iPtr)
+      (*iPtr)->loadParticleBinaryData(file);
+  }
+
+  //! \brief Reorder the per-particle data of the Property-s.
+  //!
+  //! The particle with ID \p i takes the data of the particle with
+  //! ID oldID[i], see SReorder.
+  inline void permuteParticles(const std::vector<size_t>& oldID)
+  {
+    for (iterator iPtr = _namedProperties.begin(); 
+	 iPtr != _namedProperties.end(); ++iPtr)
+      (*iPtr)->permuteParticles(oldID);
+  }
+
+  //! \brief Write the values of all Property-s, exactly as they are
+  //! held in the simulation, to an exact checkpoint.
+  //!
+  //! The values written to the configuration file are converted to
+  //! its units, which does not round trip exactly.
+  inline void outputExactState(dynamo::BinaryConfigWriter& file) const
+  { file.writeBlock("Exact/Properties", saveValues()); }
+
+  //! \brief Restore the values written by outputExactState.
+  inline void loadExactState(const dynamo::BinaryConfigReader& file)
+  {
+    const size_t block = file.findBlock("Exact/Properties");
+    const size_t count = saveValues().size();
+    if (file.getCount(block) != count)
+      M_throw() << "The checkpoint holds " << file.getCount(block) 
+		<< " property values, but the configuration has " << count;
+
+    const double* values = file.getBlock<double>(block);
+    for (iterator iPtr = _numericProperties.begin(); 
+	 iPtr != _numericProperties.end(); ++iPtr)
+      values = (*iPtr)->loadValues(values);
+
+    for (iterator iPtr = _namedProperties.begin(); 
+	 iPtr != _namedProperties.end(); ++iPtr)
+      values = (*iPtr)->loadValues(values);
+  }
+
   /*! \brief Method for pushing constructed properties into the
    * PropertyStore.
    *
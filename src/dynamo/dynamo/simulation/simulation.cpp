@@ -27,6 +27,9 @@
 #include "../outputplugins/tickerproperty/ticker.hpp"
 #include "../dynamics/systems/sysTicker.hpp"
 #include <magnet/exception.hpp>
+#include <magnet/stream/bzip2.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include <boost/foreach.hpp>
 #include <iomanip>
 
@@ -149,6 +152,12 @@ Simulation::initialise()
   dout << "Initialising the dynamics" << std::endl;
   dynamics.initialise();
 
+  if (restartFile)
+    {
+      dout << "Restoring the exact state of the checkpoint" << std::endl;
+      loadExactState(*restartFile);
+    }
+
   ensemble->initialise();
     
   fflush(stdout);
@@ -165,6 +174,9 @@ Simulation::initialise()
   BOOST_FOREACH(magnet::ClonePtr<OutputPlugin> & Ptr, outputPlugins)
     Ptr->initialise();
 
+  //The checkpoint is no longer needed
+  restartFile.reset();
+
   dout << "System initialised" << std::endl;
 
   status = INITIALISED;
@@ -226,7 +238,7 @@ Simulation::outputData(std::string filename)
   io::filtering_ostream coutputFile;
   
   if (std::string(filename.end()-4, filename.end()) == ".bz2")
-    coutputFile.push(io::bzip2_compressor());
+    coutputFile.push(magnet::stream::ParallelBzip2Compressor(threads));
   
   coutputFile.push(io::file_sink(filename));
   
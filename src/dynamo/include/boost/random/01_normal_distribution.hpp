@@ -97,9 +97,7 @@ public:
   friend std::basic_ostream<CharT,Traits>&
   operator<<(std::basic_ostream<CharT,Traits>& os, const normal_distribution_01& nd)
   {
-    os << nd._mean << " " << nd._sigma << " "
-       << nd._valid << " " << " " << nd._r1 << " " 
-       << nd._r2;
+    os << nd._valid << " " << nd._r1 << " " << nd._r2;
     return os;
   }
 
@@ -107,8 +105,7 @@ public:
   friend std::basic_istream<CharT,Traits>&
   operator>>(std::basic_istream<CharT,Traits>& is, normal_distribution_01& nd)
   {
-    is >> std::ws >> nd._mean >> std::ws >> nd._sigma
-       >> std::ws >> nd._valid >> std::ws >> nd._r1 
+    is >> std::ws >> nd._valid >> std::ws >> nd._r1 
        >> std::ws >> nd._r2;
     return is;
   }
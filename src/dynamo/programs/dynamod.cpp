@@ -59,7 +59,7 @@ main(int argc, char *argv[])
 	("help,h", "Produces this message OR if --packer-mode/-m is set, it lists the specific options available for that packer mode.")
 	("out-config-file,o", 
 	 po::value<string>()->default_value("config.out.xml.bz2"), 
-	 "Configuration output file.")
+	 "Configuration output file (.xml, .xml.bz2 or binary .dyn).")
 	("random-seed,s", po::value<unsigned int>(),
 	 "Seed value for the random number generator.")
 	("rescale-T,r", po::value<double>(), 
@@ -0,0 +1,364 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <magnet/exception.hpp>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <cstddef>
+#include <stdint.h>
+
+namespace magnet {
+  namespace containers {
+    namespace detail {
+      //! \brief Key extraction policy for the OpenHashSet.
+      template<class Key> struct SetKeyOf
+      {
+	static const Key& get(const Key& val) { return val; }
+      };
+
+      //! \brief Key extraction policy for the OpenHashMap.
+      template<class Key, class T> struct MapKeyOf
+      {
+	static const Key& get(const std::pair<Key, T>& val) { return val.first; }
+      };
+
+      /*! \brief A flat, open addressing hash table using linear
+       * probing.
+       *
+       * All values are stored in a single contiguous array, so an
+       * insert or erase never allocates unless the table has to
+       * grow. Erasing uses backward shift deletion, so no tombstones
+       * accumulate and lookups never have to skip over deleted
+       * entries.
+       *
+       * One key value, the "empty key", must be reserved by the
+       * user to mark unused slots. It is passed to the constructor
+       * and must never be inserted.
+       *
+       * Iterators (and references) are invalidated by any insert
+       * (which may rehash) and by any erase (which may shift entries
+       * backwards).
+       *
+       * The iteration order is the order of the (mixed) hashes. If the
+       * contents of one table are inserted in that order into another
+       * table which has to grow as it is filled, the values all land
+       * in one cluster and the inserts become O(N). Call reserve()
+       * before bulk inserts of data which may be in hash order.
+       *
+       * \tparam Key The key type, must be equality comparable.
+       * \tparam Value The stored value type.
+       * \tparam KeyOf A policy to extract the Key from a Value.
+       * \tparam Hash A hash functor for the Key. The result is mixed
+       * again before use, so a trivial hash (e.g., the identity) is
+       * acceptable.
+       */
+      template<class Key, class Value, class KeyOf, class Hash>
+      class OpenHashTable
+      {
+      public:
+	typedef Key key_type;
+	typedef Value value_type;
+	typedef Hash hasher;
+	typedef size_t size_type;
+
+	template<class VT, class TablePtr>
+	class iterator_base
+	{
+	public:
+	  typedef std::forward_iterator_tag iterator_category;
+	  typedef VT value_type;
+	  typedef std::ptrdiff_t difference_type;
+	  typedef VT* pointer;
+	  typedef VT& reference;
+
+	  iterator_base(): _table(NULL), _idx(0) {}
+	  iterator_base(TablePtr table, size_t idx): _table(table), _idx(idx) {}
+
+	  //! \brief Conversion from a mutable to a const iterator.
+	  template<class VT2, class TablePtr2>
+	  iterator_base(const iterator_base<VT2, TablePtr2>& o):
+	    _table(o._table), _idx(o._idx) {}
+
+	  VT& operator*() const { return _table->_values[_idx]; }
+	  VT* operator->() const { return &(_table->_values[_idx]); }
+
+	  iterator_base& operator++()
+	  {
+	    _idx = _table->nextUsed(_idx + 1);
+	    return *this;
+	  }
+
+	  iterator_base operator++(int)
+	  { iterator_base tmp(*this); ++(*this); return tmp; }
+
+	  template<class VT2, class TablePtr2>
+	  bool operator==(const iterator_base<VT2, TablePtr2>& o) const
+	  { return _idx == o._idx; }
+
+	  template<class VT2, class TablePtr2>
+	  bool operator!=(const iterator_base<VT2, TablePtr2>& o) const
+	  { return _idx != o._idx; }
+
+	private:
+	  template<class, class> friend class iterator_base;
+	  friend class OpenHashTable;
+	  TablePtr _table;
+	  size_t _idx;
+	};
+
+	typedef iterator_base<Value, OpenHashTable*> iterator;
+	typedef iterator_base<const Value, const OpenHashTable*> const_iterator;
+
+	OpenHashTable(const Value& emptyValue, const Hash& hash):
+	  _emptyValue(emptyValue), _hash(hash), _size(0), _mask(0), _shift(64),
+	  _maxLoadFactor(0.75)
+	{}
+
+	size_t size() const { return _size; }
+	bool empty() const { return !_size; }
+
+	size_t bucket_count() const { return _values.size(); }
+	size_t max_bucket_count() const { return size_t(1) << 31; }
+	float load_factor() const
+	{ return _values.empty() ? 0 : float(_size) / _values.size(); }
+	float max_load_factor() const { return _maxLoadFactor; }
+
+	void max_load_factor(float z)
+	{
+	  if ((z <= 0) || (z >= 1))
+	    M_throw() << "The maximum load factor must be in (0,1), not " << z;
+	  _maxLoadFactor = z;
+	  reserve(_size);
+	}
+
+	//! \brief Empty the table but keep its storage.
+	void clear()
+	{
+	  for (typename std::vector<Value>::iterator it = _values.begin();
+	       it != _values.end(); ++it)
+	    if (!isEmpty(*it)) *it = _emptyValue;
+	  _size = 0;
+	}
+
+	//! \brief Ensure \p n elements can be stored without a rehash.
+	void reserve(size_t n)
+	{
+	  size_t buckets = 16;
+	  while (buckets * _maxLoadFactor < n + 1)
+	    buckets *= 2;
+
+	  if (buckets > _values.size())
+	    rehash(buckets);
+	}
+
+	iterator begin() { return iterator(this, nextUsed(0)); }
+	iterator end() { return iterator(this, _values.size()); }
+	const_iterator begin() const { return const_iterator(this, nextUsed(0)); }
+	const_iterator end() const { return const_iterator(this, _values.size()); }
+
+	iterator find(const Key& key)
+	{ return iterator(this, findIndex(key)); }
+
+	const_iterator find(const Key& key) const
+	{ return const_iterator(this, findIndex(key)); }
+
+	size_t count(const Key& key) const
+	{ return findIndex(key) != _values.size(); }
+
+	std::pair<iterator, bool> insert(const Value& val)
+	{
+#ifdef MAGNET_DEBUG
+	  if (isEmpty(val))
+	    M_throw() << "Cannot insert the empty key into an OpenHashTable";
+#endif
+	  if ((_size + 1) > _values.size() * _maxLoadFactor)
+	    reserve(_size + 1);
+
+	  size_t idx = bucket(KeyOf::get(val));
+	  for (;;)
+	    {
+	      if (isEmpty(_values[idx]))
+		{
+		  _values[idx] = val;
+		  ++_size;
+		  return std::make_pair(iterator(this, idx), true);
+		}
+
+	      if (KeyOf::get(_values[idx]) == KeyOf::get(val))
+		return std::make_pair(iterator(this, idx), false);
+
+	      idx = (idx + 1) & _mask;
+	    }
+	}
+
+	size_t erase(const Key& key)
+	{
+	  size_t idx = findIndex(key);
+	  if (idx == _values.size()) return 0;
+	  eraseIndex(idx);
+	  return 1;
+	}
+
+	void erase(const_iterator it) { eraseIndex(it._idx); }
+
+	void swap(OpenHashTable& o)
+	{
+	  _values.swap(o._values);
+	  std::swap(_emptyValue, o._emptyValue);
+	  std::swap(_hash, o._hash);
+	  std::swap(_size, o._size);
+	  std::swap(_mask, o._mask);
+	  std::swap(_shift, o._shift);
+	  std::swap(_maxLoadFactor, o._maxLoadFactor);
+	}
+
+      protected:
+	bool isEmpty(const Value& val) const
+	{ return KeyOf::get(val) == KeyOf::get(_emptyValue); }
+
+	/*! \brief The home bucket of a key.
+	 *
+	 * Fibonacci hashing of the user hash: the top bits of the
+	 * product with 2^64/phi are well mixed even when the user hash
+	 * is the identity.
+	 */
+	size_t bucket(const Key& key) const
+	{
+	  return size_t((uint64_t(_hash(key)) * 0x9E3779B97F4A7C15ULL)
+			>> _shift);
+	}
+
+	size_t findIndex(const Key& key) const
+	{
+	  if (_values.empty()) return 0;
+
+	  size_t idx = bucket(key);
+	  for (;;)
+	    {
+	      const Value& val = _values[idx];
+	      if (KeyOf::get(val) == key) return idx;
+	      if (isEmpty(val)) return _values.size();
+	      idx = (idx + 1) & _mask;
+	    }
+	}
+
+	size_t nextUsed(size_t idx) const
+	{
+	  while ((idx < _values.size()) && isEmpty(_values[idx])) ++idx;
+	  return idx;
+	}
+
+	/*! \brief Remove the value at \p idx, shifting back any values
+	 * in the following probe sequence that could then sit closer to
+	 * their home bucket.
+	 */
+	void eraseIndex(size_t idx)
+	{
+	  size_t next = (idx + 1) & _mask;
+	  while (!isEmpty(_values[next]))
+	    {
+	      const size_t home = bucket(KeyOf::get(_values[next]));
+	      //Move the value back if its home bucket is not in the
+	      //cyclic range (idx, next]
+	      if (((next - home) & _mask) >= ((next - idx) & _mask))
+		{
+		  _values[idx] = _values[next];
+		  idx = next;
+		}
+	      next = (next + 1) & _mask;
+	    }
+
+	  _values[idx] = _emptyValue;
+	  --_size;
+	}
+
+	void rehash(size_t buckets)
+	{
+	  std::vector<Value> old(buckets, _emptyValue);
+	  old.swap(_values);
+	  _mask = buckets - 1;
+	  _shift = 64;
+	  while (buckets > 1) { buckets >>= 1; --_shift; }
+
+	  for (typename std::vector<Value>::const_iterator it = old.begin();
+	       it != old.end(); ++it)
+	    if (!isEmpty(*it))
+	      {
+		size_t idx = bucket(KeyOf::get(*it));
+		while (!isEmpty(_values[idx])) idx = (idx + 1) & _mask;
+		_values[idx] = *it;
+	      }
+	}
+
+	std::vector<Value> _values;
+	//! \brief The value used to mark unused slots.
+	Value _emptyValue;
+	Hash _hash;
+	size_t _size;
+	size_t _mask;
+	size_t _shift;
+	float _maxLoadFactor;
+      };
+    }
+
+    /*! \brief A flat open addressing hash set.
+     *
+     * A drop in replacement for the commonly used parts of
+     * std::tr1::unordered_set, see detail::OpenHashTable for the
+     * differences (the reserved empty key and the stricter iterator
+     * invalidation rules).
+     */
+    template<class Key, class Hash>
+    class OpenHashSet:
+      public detail::OpenHashTable<Key, Key, detail::SetKeyOf<Key>, Hash>
+    {
+      typedef detail::OpenHashTable<Key, Key, detail::SetKeyOf<Key>, Hash> Base;
+    public:
+      explicit OpenHashSet(const Key& emptyKey, const Hash& hash = Hash()):
+	Base(emptyKey, hash) {}
+    };
+
+    /*! \brief A flat open addressing hash map.
+     *
+     * A drop in replacement for the commonly used parts of
+     * std::tr1::unordered_map, see detail::OpenHashTable for the
+     * differences (the reserved empty key and the stricter iterator
+     * invalidation rules). The value_type is std::pair<Key, T> as
+     * the values must be assignable to be moved within the table;
+     * the key of a stored value must not be modified.
+     */
+    template<class Key, class T, class Hash>
+    class OpenHashMap:
+      public detail::OpenHashTable<Key, std::pair<Key, T>,
+				   detail::MapKeyOf<Key, T>, Hash>
+    {
+      typedef detail::OpenHashTable<Key, std::pair<Key, T>,
+				    detail::MapKeyOf<Key, T>, Hash> Base;
+    public:
+      typedef T mapped_type;
+
+      explicit OpenHashMap(const Key& emptyKey, const Hash& hash = Hash()):
+	Base(std::make_pair(emptyKey, T()), hash) {}
+
+      T& operator[](const Key& key)
+      { return Base::insert(std::make_pair(key, T())).first->second; }
+    };
+  }
+}
@@ -22,48 +22,114 @@
 
 #include <stdint.h>
 #include <limits>
+#ifdef __BMI2__
+# include <immintrin.h>
+#endif
 
 namespace magnet {
   namespace math {
-    
+    namespace detail {
+      //! \brief Dilate the lower 21 bits of an integer using a table
+      //! of the dilated bytes.
+      inline uint64_t dilate_3_table(uint64_t r)
+      {
+	static const uint32_t table[256] = {
+	  0x000000, 0x000001, 0x000008, 0x000009, 0x000040, 0x000041, 0x000048, 0x000049,
+	  0x000200, 0x000201, 0x000208, 0x000209, 0x000240, 0x000241, 0x000248, 0x000249,
+	  0x001000, 0x001001, 0x001008, 0x001009, 0x001040, 0x001041, 0x001048, 0x001049,
+	  0x001200, 0x001201, 0x001208, 0x001209, 0x001240, 0x001241, 0x001248, 0x001249,
+	  0x008000, 0x008001, 0x008008, 0x008009, 0x008040, 0x008041, 0x008048, 0x008049,
+	  0x008200, 0x008201, 0x008208, 0x008209, 0x008240, 0x008241, 0x008248, 0x008249,
+	  0x009000, 0x009001, 0x009008, 0x009009, 0x009040, 0x009041, 0x009048, 0x009049,
+	  0x009200, 0x009201, 0x009208, 0x009209, 0x009240, 0x009241, 0x009248, 0x009249,
+	  0x040000, 0x040001, 0x040008, 0x040009, 0x040040, 0x040041, 0x040048, 0x040049,
+	  0x040200, 0x040201, 0x040208, 0x040209, 0x040240, 0x040241, 0x040248, 0x040249,
+	  0x041000, 0x041001, 0x041008, 0x041009, 0x041040, 0x041041, 0x041048, 0x041049,
+	  0x041200, 0x041201, 0x041208, 0x041209, 0x041240, 0x041241, 0x041248, 0x041249,
+	  0x048000, 0x048001, 0x048008, 0x048009, 0x048040, 0x048041, 0x048048, 0x048049,
+	  0x048200, 0x048201, 0x048208, 0x048209, 0x048240, 0x048241, 0x048248, 0x048249,
+	  0x049000, 0x049001, 0x049008, 0x049009, 0x049040, 0x049041, 0x049048, 0x049049,
+	  0x049200, 0x049201, 0x049208, 0x049209, 0x049240, 0x049241, 0x049248, 0x049249,
+	  0x200000, 0x200001, 0x200008, 0x200009, 0x200040, 0x200041, 0x200048, 0x200049,
+	  0x200200, 0x200201, 0x200208, 0x200209, 0x200240, 0x200241, 0x200248, 0x200249,
+	  0x201000, 0x201001, 0x201008, 0x201009, 0x201040, 0x201041, 0x201048, 0x201049,
+	  0x201200, 0x201201, 0x201208, 0x201209, 0x201240, 0x201241, 0x201248, 0x201249,
+	  0x208000, 0x208001, 0x208008, 0x208009, 0x208040, 0x208041, 0x208048, 0x208049,
+	  0x208200, 0x208201, 0x208208, 0x208209, 0x208240, 0x208241, 0x208248, 0x208249,
+	  0x209000, 0x209001, 0x209008, 0x209009, 0x209040, 0x209041, 0x209048, 0x209049,
+	  0x209200, 0x209201, 0x209208, 0x209209, 0x209240, 0x209241, 0x209248, 0x209249,
+	  0x240000, 0x240001, 0x240008, 0x240009, 0x240040, 0x240041, 0x240048, 0x240049,
+	  0x240200, 0x240201, 0x240208, 0x240209, 0x240240, 0x240241, 0x240248, 0x240249,
+	  0x241000, 0x241001, 0x241008, 0x241009, 0x241040, 0x241041, 0x241048, 0x241049,
+	  0x241200, 0x241201, 0x241208, 0x241209, 0x241240, 0x241241, 0x241248, 0x241249,
+	  0x248000, 0x248001, 0x248008, 0x248009, 0x248040, 0x248041, 0x248048, 0x248049,
+	  0x248200, 0x248201, 0x248208, 0x248209, 0x248240, 0x248241, 0x248248, 0x248249,
+	  0x249000, 0x249001, 0x249008, 0x249009, 0x249040, 0x249041, 0x249048, 0x249049,
+	  0x249200, 0x249201, 0x249208, 0x249209, 0x249240, 0x249241, 0x249248, 0x249249
+	};
+
+	return uint64_t(table[r & 0xFF])
+	  | (uint64_t(table[(r >> 8) & 0xFF]) << 24)
+	  | (uint64_t(table[(r >> 16) & 0x1F]) << 48);
+      }
+
+      //! \brief Contract a dilated integer by shifting and masking.
+      inline uint64_t undilate_3_shift(uint64_t t)
+      {
+	t &= 0x1249249249249249ULL;
+	t = (t ^ (t >> 2)) & 0x10C30C30C30C30C3ULL;
+	t = (t ^ (t >> 4)) & 0x100F00F00F00F00FULL;
+	t = (t ^ (t >> 8)) & 0x001F0000FF0000FFULL;
+	t = (t ^ (t >> 16)) & 0x001F00000000FFFFULL;
+	t = (t ^ (t >> 32)) & 0x00000000001FFFFFULL;
+	return t;
+      }
+    }
+
     /*! \brief A dilated integer class for easy morton order manipulations in 3D
      *
      * Please see the original papers "Converting to and from Dilated
      * Integers"(10.1109/TC.2007.70814) and "Fast Additions on Masked
      * Integers"(10.1145/1149982.1149987) for more information and a 2D implementation
+     *
+     * The dilated integers are stored in 64 bits, so three of them
+     * form a 63 bit morton number. If the BMI2 instructions are
+     * enabled (e.g., -mbmi2 or -march=native) the conversions are a
+     * single pdep/pext instruction, otherwise the dilation uses a
+     * table and the contraction shifts and masks.
      */
     class DilatedInteger
     {
     public:
-      //Number of bits in the dilated integer (10 is max for 3 dilated ints)
-      static const uint32_t digits = 10;
+      //Number of bits in the dilated integer (21 is max for 3 dilated ints)
+      static const uint32_t digits = 21;
       
       //A mask for the number of bits in the dilated integer (also max value)
-      static const uint32_t undilatedMask = 0xFFFFFFFF >> (32 - digits);
+      static const uint64_t undilatedMask = 0xFFFFFFFFFFFFFFFFULL >> (64 - digits);
       
       //A mask for the dilated integer (also dilated max value)
-      static const uint32_t dilatedMask = 0x49249249 & (0xFFFFFFFF >> (32 - 3 * digits));
+      static const uint64_t dilatedMask = 0x9249249249249249ULL & (0xFFFFFFFFFFFFFFFFULL >> (64 - 3 * digits));
       
       // Constructors
       inline DilatedInteger() {}
 
-      inline DilatedInteger(const uint32_t val):
+      inline DilatedInteger(const uint64_t val):
 	value(dilate_3(val & undilatedMask)) {}
       
       //Constructor that takes the actual Dilated int as the arg
-      inline DilatedInteger(const uint32_t val, void*):
+      inline DilatedInteger(const uint64_t val, void*):
 	value(val) {}
 
       inline DilatedInteger(const DilatedInteger& d):
 	value(d.value) {}
       
-      inline const uint32_t& getDilatedVal() const { return value; }
+      inline const uint64_t& getDilatedVal() const { return value; }
       
-      inline uint32_t getRealVal() const { return undilate_3(value); }
+      inline uint64_t getRealVal() const { return undilate_3(value); }
       
-      inline void setDilatedVal(const uint32_t& i) { value = i & dilatedMask; }
+      inline void setDilatedVal(const uint64_t& i) { value = i & dilatedMask; }
       
-      inline void operator=(const uint32_t& i) { value = dilate_3(i & undilatedMask); }
+      inline void operator=(const uint64_t& i) { value = dilate_3(i & undilatedMask); }
       inline void operator=(const DilatedInteger& i) { value = i.value; }
       
       inline void zero() { value = 0; }
@@ -116,25 +182,24 @@ namespace magnet {
       { return value >= d.value; }
       
     private:
-      uint32_t value; // stored as normalized integer at mask’s  1 bits.
+      uint64_t value; // stored as normalized integer at mask’s  1 bits.
       
-      //Could technically return a uint16_t
-      inline uint32_t undilate_3(uint32_t t) const 
+      inline uint64_t undilate_3(uint64_t t) const 
       {
-	t = (t * 0x00015) & 0x0E070381;
-	t = (t * 0x01041) & 0x0FF80001;
-	t = (t * 0x40001) & 0x0FFC0000;
-	return t >> 18;
+#ifdef __BMI2__
+	return _pext_u64(t, dilatedMask);
+#else
+	return detail::undilate_3_shift(t);
+#endif
       }
       
-      //Could technically accept a uint16_t
-      inline uint32_t dilate_3(uint32_t r) const
+      inline uint64_t dilate_3(uint64_t r) const
       {
-	r =  (r * 0x10001) & 0xFF0000FF; 
-	r =  (r * 0x00101) & 0x0F00F00F;
-	r =  (r * 0x00011) & 0xC30C30C3;
-	r =  (r * 0x00005) & 0x49249249;
-	return r;
+#ifdef __BMI2__
+	return _pdep_u64(r, dilatedMask);
+#else
+	return detail::dilate_3_table(r);
+#endif
       }
       
     };
@@ -143,7 +208,7 @@ namespace magnet {
     {
       inline DilatedVector() {}
       
-      inline DilatedVector(const uint32_t& MortonNum)
+      inline DilatedVector(const uint64_t& MortonNum)
       {
 	for (uint32_t i(0); i < 3; ++i)
 	  data[i].setDilatedVal(MortonNum >> i);
@@ -165,7 +230,7 @@ namespace magnet {
 	data[2] = z;
       }
       
-      inline uint32_t getMortonNum()
+      inline uint64_t getMortonNum() const
       { 
 	return data[0].getDilatedVal() 
 	  + (data[1].getDilatedVal() << 1) 
@@ -0,0 +1,382 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <magnet/exception.hpp>
+#include <magnet/function/task.hpp>
+#include <magnet/thread/workstealing.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/write.hpp>
+#include <boost/shared_ptr.hpp>
+#include <bzlib.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace magnet {
+  namespace stream {
+    namespace detail {
+      /*! \brief Compress a block of data into a complete bzip2
+       * stream.
+       *
+       * \param in The data to compress.
+       * \param out The string to replace with the compressed stream.
+       * \param level The bzip2 block size/compression level [1,9].
+       */
+      inline void bzip2CompressBlock(const std::string& in, std::string& out, int level)
+      {
+	//The worst case expansion given by the bzip2 documentation
+	unsigned int outLen = in.size() + in.size() / 100 + 601;
+	out.resize(outLen);
+
+	int ret = BZ2_bzBuffToBuffCompress(&out[0], &outLen,
+					   const_cast<char*>(in.data()), in.size(),
+					   level, 0, 0);
+	if (ret != BZ_OK)
+	  M_throw() << "bzip2 compression failed with error code " << ret;
+
+	out.resize(outLen);
+      }
+
+      /*! \brief Decompress one or more concatenated bzip2 streams.
+       *
+       * Like the bzip2 tool, any trailing data which does not start
+       * with a bzip2 stream header is ignored.
+       *
+       * \return False if the data is not a sequence of complete
+       * bzip2 streams.
+       */
+      inline bool bzip2DecompressStreams(const char* in, size_t len, std::string& out)
+      {
+	std::vector<char> buffer(1 << 16);
+
+	if (len && ((len < 3) || std::memcmp(in, "BZh", 3)))
+	  return false;
+
+	while (len >= 3 && !std::memcmp(in, "BZh", 3))
+	  {
+	    bz_stream strm;
+	    std::memset(&strm, 0, sizeof(strm));
+	    if (BZ2_bzDecompressInit(&strm, 0, 0) != BZ_OK) return false;
+
+	    strm.next_in = const_cast<char*>(in);
+	    strm.avail_in = len;
+
+	    int ret;
+	    do {
+	      strm.next_out = &buffer[0];
+	      strm.avail_out = buffer.size();
+	      ret = BZ2_bzDecompress(&strm);
+
+	      const bool stalled = (ret == BZ_OK) && !strm.avail_in && strm.avail_out;
+	      if (((ret != BZ_OK) && (ret != BZ_STREAM_END)) || stalled)
+		{
+		  //Corrupt or truncated data
+		  BZ2_bzDecompressEnd(&strm);
+		  return false;
+		}
+
+	      out.append(&buffer[0], buffer.size() - strm.avail_out);
+	    } while (ret != BZ_STREAM_END);
+
+	    in += len - strm.avail_in;
+	    len = strm.avail_in;
+	    BZ2_bzDecompressEnd(&strm);
+	  }
+
+	return true;
+      }
+
+      /*! \brief Find the offsets of the bzip2 stream headers in a
+       * buffer.
+       *
+       * A stream header is "BZh" followed by the block size digit and
+       * the magic number of either a block or the end of the stream.
+       * These patterns are byte aligned at the start of a stream but
+       * may also occur by chance inside the compressed data, so the
+       * offsets are only candidates. The first offset is always zero.
+       */
+      inline std::vector<size_t> bzip2StreamStarts(const char* data, size_t len)
+      {
+	static const unsigned char blockMagic[6] = {0x31, 0x41, 0x59, 0x26, 0x53, 0x59};
+	static const unsigned char endMagic[6] = {0x17, 0x72, 0x45, 0x38, 0x50, 0x90};
+
+	std::vector<size_t> starts(1, 0);
+	const char* const end = data + len;
+	for (const char* p = data + 1; end - p >= 10; ++p)
+	  {
+	    p = static_cast<const char*>(std::memchr(p, 'B', end - p - 9));
+	    if (p == NULL) break;
+
+	    if (!std::memcmp(p, "BZh", 3) && (p[3] >= '1') && (p[3] <= '9')
+		&& (!std::memcmp(p + 4, blockMagic, 6) || !std::memcmp(p + 4, endMagic, 6)))
+	      starts.push_back(p - data);
+	  }
+
+	return starts;
+      }
+
+      /*! \brief Runs the compression or decompression of a batch of
+       * blocks over a thread pool.
+       */
+      class Bzip2Batch
+      {
+      public:
+	typedef function::Task1<void, size_t> BlockTask;
+
+	Bzip2Batch(thread::WorkStealingPool* pool, size_t size):
+	  in(size), out(size), ok(size), _pool(pool)
+	{}
+
+	//! \brief The number of blocks in a batch for a thread pool.
+	static size_t batchSize(thread::WorkStealingPool* pool)
+	{ return 2 * ((pool != NULL) ? pool->getThreadCount() + 1 : 1); }
+
+	//! \brief Compress the first \p n blocks of in into out.
+	void compress(size_t n, int level)
+	{
+	  _level = level;
+	  run(n, function::MakeDelegate(this, &Bzip2Batch::compressBlock));
+	}
+
+	/*! \brief Decompress the first \p n spans of compressed data
+	 * into out.
+	 *
+	 * \return False if any of the spans failed to decompress.
+	 */
+	bool decompress(size_t n, const char* const* spans, const size_t* lengths)
+	{
+	  _spans = spans;
+	  _lengths = lengths;
+	  run(n, function::MakeDelegate(this, &Bzip2Batch::decompressBlock));
+	  for (size_t i(0); i < n; ++i)
+	    if (!ok[i]) return false;
+	  return true;
+	}
+
+	std::vector<std::string> in;
+	std::vector<std::string> out;
+	std::vector<char> ok;
+
+      private:
+	void run(size_t n, const function::Delegate1<size_t, void>& func)
+	{
+	  std::vector<BlockTask> tasks;
+	  for (size_t i(0); i < n; ++i)
+	    tasks.push_back(BlockTask(func, i));
+
+	  if (_pool == NULL)
+	    for (size_t i(0); i < n; ++i)
+	      tasks[i]();
+	  else
+	    {
+	      thread::TaskGroup group(*_pool);
+	      for (size_t i(0); i < n; ++i)
+		group.spawn(tasks[i]);
+	      group.wait();
+	    }
+	}
+
+	void compressBlock(size_t i)
+	{ bzip2CompressBlock(in[i], out[i], _level); }
+
+	void decompressBlock(size_t i)
+	{
+	  out[i].clear();
+	  ok[i] = bzip2DecompressStreams(_spans[i], _lengths[i], out[i]);
+	}
+
+	thread::WorkStealingPool* _pool;
+	int _level;
+	const char* const* _spans;
+	const size_t* _lengths;
+      };
+    }
+
+    /*! \brief A boost::iostreams output filter which compresses to
+     * bzip2 using a thread pool.
+     *
+     * The data is split into blocks which are compressed
+     * independently into complete bzip2 streams and written out in
+     * order. This is the format written by pbzip2, the concatenated
+     * streams are a valid bzip2 file which any bzip2 tool can read,
+     * and the streams may be decompressed in parallel (see
+     * parallelBzip2Decompress).
+     *
+     * The blocks are collected into batches of twice the number of
+     * threads available, which are compressed together. Without a
+     * pool the blocks are compressed by the writing thread.
+     *
+     * \code
+     * boost::iostreams::filtering_ostream out;
+     * out.push(magnet::stream::ParallelBzip2Compressor(&pool));
+     * out.push(boost::iostreams::file_sink("data.bz2"));
+     * \endcode
+     */
+    class ParallelBzip2Compressor
+    {
+    public:
+      typedef char char_type;
+      struct category:
+	boost::iostreams::multichar_output_filter_tag,
+	boost::iostreams::closable_tag
+      {};
+
+      /*! \param pool The thread pool to compress on, may be NULL.
+       * \param level The bzip2 block size/compression level [1,9].
+       * \param blockSize The amount of data compressed into each
+       * stream, the default fills a single bzip2 block at level 9.
+       */
+      explicit ParallelBzip2Compressor(thread::WorkStealingPool* pool = NULL,
+				       int level = 9, size_t blockSize = 900000):
+	_state(new State(pool, level, blockSize))
+      {
+	if ((level < 1) || (level > 9))
+	  M_throw() << "bzip2 compression levels are in [1,9], not " << level;
+	if (!blockSize)
+	  M_throw() << "The block size must be positive";
+      }
+
+      template<class Sink>
+      std::streamsize write(Sink& snk, const char* s, std::streamsize n)
+      {
+	State& st = *_state;
+	std::streamsize done(0);
+	while (done < n)
+	  {
+	    std::string& block = st.batch.in[st.current];
+	    const size_t count = std::min(size_t(n - done), st.blockSize - block.size());
+	    block.append(s + done, count);
+	    done += count;
+
+	    if ((block.size() == st.blockSize) && (++st.current == st.batch.in.size()))
+	      flush(snk, st.current);
+	  }
+	return n;
+      }
+
+      template<class Sink>
+      void close(Sink& snk)
+      {
+	State& st = *_state;
+	size_t count = st.current;
+	if ((count < st.batch.in.size()) && !st.batch.in[count].empty())
+	  ++count;
+
+	//An empty input still produces a (valid) empty stream
+	if (!count && !st.written)
+	  count = 1;
+
+	flush(snk, count);
+      }
+
+    private:
+      struct State
+      {
+	State(thread::WorkStealingPool* pool, int level_, size_t blockSize_):
+	  batch(pool, detail::Bzip2Batch::batchSize(pool)),
+	  level(level_), blockSize(blockSize_), current(0), written(false)
+	{}
+
+	detail::Bzip2Batch batch;
+	int level;
+	size_t blockSize;
+	size_t current;
+	bool written;
+      };
+
+      template<class Sink>
+      void flush(Sink& snk, size_t count)
+      {
+	State& st = *_state;
+	st.batch.compress(count, st.level);
+
+	for (size_t i(0); i < count; ++i)
+	  {
+	    const std::string& data = st.batch.out[i];
+	    std::streamsize done(0);
+	    while (done < std::streamsize(data.size()))
+	      done += boost::iostreams::write(snk, data.data() + done, data.size() - done);
+	    st.batch.in[i].clear();
+	  }
+
+	st.current = 0;
+	st.written = true;
+      }
+
+      boost::shared_ptr<State> _state;
+    };
+
+    /*! \brief Decompress bzip2 data, using a thread pool if the data
+     * is made of several streams (e.g., written by
+     * ParallelBzip2Compressor or pbzip2).
+     *
+     * The data is split at the candidate stream headers and the
+     * pieces are decompressed in batches over the pool. If a piece
+     * fails to decompress, a header was found by chance inside a
+     * stream and the data is decompressed again by the calling thread.
+     *
+     * \param data The compressed data.
+     * \param len The length of the compressed data.
+     * \param out The decompressed data is appended to this string.
+     * \param pool The thread pool to decompress on, may be NULL.
+     */
+    inline void parallelBzip2Decompress(const char* data, size_t len, std::string& out,
+					thread::WorkStealingPool* pool = NULL)
+    {
+      const size_t initialSize = out.size();
+
+      if (pool != NULL)
+	{
+	  std::vector<size_t> starts = detail::bzip2StreamStarts(data, len);
+	  starts.push_back(len);
+
+	  std::vector<const char*> spans;
+	  std::vector<size_t> lengths;
+	  for (size_t i(0); i + 1 < starts.size(); ++i)
+	    {
+	      spans.push_back(data + starts[i]);
+	      lengths.push_back(starts[i + 1] - starts[i]);
+	    }
+
+	  detail::Bzip2Batch batch(pool, detail::Bzip2Batch::batchSize(pool));
+	  const size_t batchSize = batch.out.size();
+
+	  bool ok(true);
+	  for (size_t first(0); ok && (first < spans.size()); first += batchSize)
+	    {
+	      const size_t n = std::min(batchSize, spans.size() - first);
+	      ok = batch.decompress(n, &spans[first], &lengths[first]);
+
+	      if (ok)
+		for (size_t i(0); i < n; ++i)
+		  {
+		    out.append(batch.out[i]);
+		    std::string().swap(batch.out[i]);
+		  }
+	    }
+
+	  if (ok) return;
+	  out.resize(initialSize);
+	}
+
+      if (!detail::bzip2DecompressStreams(data, len, out))
+	M_throw() << "The bzip2 data is corrupt or truncated";
+    }
+  }
+}
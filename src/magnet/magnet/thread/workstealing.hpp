@@ -0,0 +1,559 @@
+/*  dynamo:- Event driven molecular dynamics simulator
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*! \file workstealing.hpp
+ * \brief Contains the definition of WorkStealingPool and TaskGroup.
+ */
+
+#pragma once
+
+#include <sstream>
+#include <iostream>
+#include <vector>
+
+#include <magnet/exception.hpp>
+#include <magnet/function/task.hpp>
+#include <magnet/thread/mutex.hpp>
+#include <magnet/thread/threadgroup.hpp>
+
+namespace magnet {
+  namespace thread {
+    class TaskGroup;
+    class WorkStealingPool;
+
+    namespace detail {
+      //! \brief Hint to the processor that we are in a spin-wait loop.
+      inline void cpu_relax()
+      {
+#if defined(__i386__) || defined(__x86_64__)
+	__asm__ __volatile__("pause" ::: "memory");
+#else
+	__sync_synchronize();
+#endif
+      }
+
+      /*! \brief An entry in a WorkStealingDeque.
+       *
+       * The task is not owned by the deque unless the owned flag is
+       * set, in which case it is deleted once it has been run.
+       */
+      struct TaskEntry
+      {
+	function::Task* task;
+	TaskGroup* group;
+	bool owned;
+      };
+
+      /*! \brief A fixed capacity, lock-free work-stealing deque.
+       *
+       * This is the Chase-Lev deque. The owning thread pushes and pops
+       * tasks from the bottom of the deque (LIFO, for cache locality),
+       * while any other thread may steal from the top (FIFO, which
+       * tends to steal the largest pieces of work). Only a single
+       * thread may push/pop at a time, but any number of threads may
+       * steal concurrently.
+       *
+       * The capacity is fixed so that no allocation is ever performed
+       * while tasks are being queued. When the deque is full push()
+       * fails and the caller should run the task itself.
+       */
+      class WorkStealingDeque
+      {
+      public:
+	WorkStealingDeque(): _top(0), _bottom(0) {}
+
+	//! \brief Owner only: push a task onto the bottom of the deque.
+	inline bool push(const TaskEntry& entry)
+	{
+	  const long b = _bottom;
+	  if (b - _top >= long(_capacity)) return false;
+
+	  _buffer[b & _mask] = entry;
+	  //The entry must be visible before the new bottom
+	  __sync_synchronize();
+	  _bottom = b + 1;
+	  return true;
+	}
+
+	//! \brief Owner only: take the most recently pushed task.
+	inline bool pop(TaskEntry& entry)
+	{
+	  const long b = _bottom - 1;
+	  _bottom = b;
+	  //The store to bottom must be ordered before the load of top
+	  __sync_synchronize();
+	  const long t = _top;
+
+	  if (t > b)
+	    {
+	      //The deque was empty
+	      _bottom = b + 1;
+	      return false;
+	    }
+
+	  entry = _buffer[b & _mask];
+
+	  if (t == b)
+	    {
+	      //Last entry in the deque, race any thieves for it
+	      const bool won = __sync_bool_compare_and_swap(&_top, t, t + 1);
+	      _bottom = b + 1;
+	      return won;
+	    }
+
+	  return true;
+	}
+
+	//! \brief Any thread: take the oldest task from the deque.
+	inline bool steal(TaskEntry& entry)
+	{
+	  const long t = _top;
+	  __sync_synchronize();
+	  const long b = _bottom;
+
+	  if (t >= b) return false;
+
+	  entry = _buffer[t & _mask];
+	  return __sync_bool_compare_and_swap(&_top, t, t + 1);
+	}
+
+	inline bool empty() const { return _bottom <= _top; }
+
+      private:
+	static const size_t _capacity = 1024;
+	static const size_t _mask = _capacity - 1;
+
+	volatile long _top;
+	//! Keep the two ends of the deque on separate cache lines
+	char _padding[64];
+	volatile long _bottom;
+
+	TaskEntry _buffer[_capacity];
+      };
+    }
+
+    /*! \brief A fork-join scope for tasks queued in a WorkStealingPool.
+     *
+     * Tasks spawned in a TaskGroup are not copied or owned by the
+     * pool, they may (and should) be allocated on the stack of the
+     * spawning thread. The only requirement is that they remain valid
+     * until wait() returns.
+     *
+     * \code
+     * magnet::function::Task1<void, size_t> taskA(delegate, 0), taskB(delegate, 1);
+     * magnet::thread::TaskGroup group(pool);
+     * group.spawn(taskA);
+     * group.spawn(taskB);
+     * group.wait();
+     * \endcode
+     *
+     * The thread calling wait() does not sleep, it executes queued
+     * tasks until the group is complete. This means that groups may
+     * be nested inside tasks without deadlocking the pool.
+     */
+    class TaskGroup
+    {
+    public:
+      inline TaskGroup(WorkStealingPool& pool): _pool(pool), _pending(0) {}
+
+      //! \brief The destructor waits for all spawned tasks to finish.
+      inline ~TaskGroup() { while (_pending) helpOrRelax(); }
+
+      //! \brief Queue a task to be executed by the pool.
+      inline void spawn(function::Task& task);
+
+      /*! \brief Wait for all the tasks spawned in this group to
+       * complete, running queued tasks in the meantime.
+       *
+       * Throws if any task in the pool threw an exception.
+       */
+      inline void wait();
+
+      //! \brief The number of spawned tasks which have not completed.
+      inline size_t pending() const { return _pending; }
+
+    private:
+      friend class WorkStealingPool;
+
+      TaskGroup(const TaskGroup&);
+      TaskGroup& operator=(const TaskGroup&);
+
+      inline void helpOrRelax();
+
+      inline void taskAdded() { __sync_fetch_and_add(&_pending, 1); }
+      inline void taskCompleted() { __sync_fetch_and_sub(&_pending, 1); }
+
+      WorkStealingPool& _pool;
+      volatile long _pending;
+    };
+
+    /*! \brief A pool of worker threads using per-thread work-stealing
+     * deques.
+     *
+     * Every worker thread owns a lock-free WorkStealingDeque. Tasks
+     * spawned from a worker go onto its own deque, and idle workers
+     * steal from the deques of the others. Tasks spawned from a thread
+     * outside of the pool go onto an extra "external" deque which the
+     * workers also steal from.
+     *
+     * Idle workers first spin for a while looking for work, before
+     * parking on a condition variable. Spawning only touches the
+     * condition variable if a worker is actually parked.
+     *
+     * There are two interfaces. The fork-join interface
+     * (TaskGroup::spawn and TaskGroup::wait) performs no allocation
+     * and takes tasks by reference. For compatibility with ThreadPool,
+     * queueTask(function::Task*) takes ownership of a heap allocated
+     * task and wait() waits for all such tasks to complete.
+     *
+     * Like ThreadPool, this class will run with zero threads, in which
+     * case the waiting thread performs all of the tasks.
+     */
+    class WorkStealingPool
+    {
+    public:
+      /*! \brief Default Constructor
+       *
+       * This initialises the pool to 0 threads.
+       */
+      inline WorkStealingPool():
+	_external(new detail::WorkStealingDeque),
+	_externalLock(0),
+	_sleepers(0),
+	_wakeEpoch(0),
+	_stop_flag(false),
+	_exception_flag(false),
+	_defaultGroup(*this)
+      {}
+
+      /*! \brief Destructor
+       *
+       * Runs any remaining tasks, then joins all threads in the pool.
+       */
+      inline ~WorkStealingPool() throw()
+      {
+	try { _defaultGroup.wait(); } catch (...) {}
+	stop();
+	delete _external;
+      }
+
+      /*! \brief Set the number of threads in the pool.
+       *
+       * All tasks are completed and all threads are stopped before
+       * the pool is repopulated.
+       */
+      inline void setThreadCount(size_t x)
+      {
+	if (x == _workers.size()) return;
+
+	wait();
+	stop();
+	_stop_flag = false;
+
+	for (size_t i(0); i < x; ++i)
+	  _workers.push_back(new Worker(this, i));
+
+	for (size_t i(0); i < x; ++i)
+	  _threads.create_thread(function::Task::makeTask(&WorkStealingPool::beginThread, this, _workers[i]));
+      }
+
+      //! \brief The current number of threads in the pool.
+      inline size_t getThreadCount() const { return _workers.size(); }
+
+      /*! \brief Queue a heap allocated task, which is deleted once it
+       * has been executed.
+       *
+       * \sa ThreadPool::queueTask
+       */
+      inline void queueTask(function::Task* task)
+      { push(task, &_defaultGroup, true); }
+
+      //! \brief Queue a vector of heap allocated tasks, the vector is cleared.
+      inline void queueTasks(std::vector<function::Task*>& tasks)
+      {
+	for (std::vector<function::Task*>::const_iterator iPtr = tasks.begin();
+	     iPtr != tasks.end(); ++iPtr)
+	  queueTask(*iPtr);
+	tasks.clear();
+      }
+
+      /*! \brief Wait for all tasks queued with queueTask() to complete.
+       *
+       * The calling thread helps with the execution of tasks while it
+       * waits.
+       */
+      inline void wait() { _defaultGroup.wait(); }
+
+      /*! \brief Attempt to execute a single queued task.
+       *
+       * \return false if no task could be found.
+       */
+      inline bool runPendingTask()
+      {
+	detail::TaskEntry entry;
+	if (!findTask(entry)) return false;
+	execute(entry);
+	return true;
+      }
+
+    private:
+      friend class TaskGroup;
+
+      WorkStealingPool(const WorkStealingPool&);
+      WorkStealingPool& operator=(const WorkStealingPool&);
+
+      struct Worker
+      {
+	Worker(WorkStealingPool* pool, size_t id):
+	  _pool(pool), _id(id), _seed(id * 2654435761u + 1) {}
+
+	detail::WorkStealingDeque _deque;
+	WorkStealingPool* _pool;
+	size_t _id;
+	unsigned int _seed;
+      };
+
+      /*! \brief The Worker of the calling thread, or NULL if the
+       * calling thread is not a member of any pool.
+       */
+      inline static Worker*& currentWorker()
+      {
+	static __thread Worker* worker = NULL;
+	return worker;
+      }
+
+      //! \brief The Worker of the calling thread if it belongs to this pool
+      inline Worker* localWorker()
+      {
+	Worker* worker = currentWorker();
+	return ((worker != NULL) && (worker->_pool == this)) ? worker : NULL;
+      }
+
+      inline void lockExternal()
+      {
+	while (__sync_lock_test_and_set(&_externalLock, 1))
+	  while (_externalLock) detail::cpu_relax();
+      }
+
+      inline void unlockExternal() { __sync_lock_release(&_externalLock); }
+
+      inline void push(function::Task* task, TaskGroup* group, bool owned)
+      {
+	detail::TaskEntry entry;
+	entry.task = task;
+	entry.group = group;
+	entry.owned = owned;
+
+	group->taskAdded();
+
+	bool queued;
+	Worker* worker = localWorker();
+	if (worker != NULL)
+	  queued = worker->_deque.push(entry);
+	else
+	  {
+	    lockExternal();
+	    queued = _external->push(entry);
+	    unlockExternal();
+	  }
+
+	if (!queued)
+	  {
+	    //The deque is full, just run the task now
+	    execute(entry);
+	    return;
+	  }
+
+	//The push must be visible before we check for sleeping threads
+	__sync_synchronize();
+	if (_sleepers)
+	  {
+	    magnet::thread::ScopedLock lock1(_sleepMutex);
+	    ++_wakeEpoch;
+	    _wakeCondition.notify_one();
+	  }
+      }
+
+      inline bool findTask(detail::TaskEntry& entry)
+      {
+	Worker* worker = localWorker();
+
+	if (worker != NULL)
+	  {
+	    if (worker->_deque.pop(entry)) return true;
+	  }
+	else if (!_external->empty())
+	  {
+	    lockExternal();
+	    const bool found = _external->pop(entry);
+	    unlockExternal();
+	    if (found) return true;
+	  }
+
+	//Now try to steal, starting from a random victim
+	const size_t nVictims = _workers.size();
+	size_t start = 0;
+	if (worker != NULL)
+	  {
+	    worker->_seed = worker->_seed * 1103515245u + 12345u;
+	    start = (worker->_seed >> 16) % (nVictims + 1);
+	  }
+
+	for (size_t i(0); i <= nVictims; ++i)
+	  {
+	    const size_t victim = (start + i) % (nVictims + 1);
+	    detail::WorkStealingDeque& deque = (victim == nVictims)
+	      ? *_external : _workers[victim]->_deque;
+
+	    if ((worker != NULL) && (&deque == &(worker->_deque))) continue;
+	    if (deque.steal(entry)) return true;
+	  }
+
+	return false;
+      }
+
+      inline bool workAvailable() const
+      {
+	if (!_external->empty()) return true;
+	for (size_t i(0); i < _workers.size(); ++i)
+	  if (!_workers[i]->_deque.empty()) return true;
+	return false;
+      }
+
+      inline void execute(detail::TaskEntry& entry)
+      {
+	try { (*entry.task)(); }
+	catch(std::exception& cep)
+	  {
+	    magnet::thread::ScopedLock lock1(_exception_mutex);
+	    _exception_data << "\nTHREAD: Task threw an exception:-"
+			    << cep.what();
+	    _exception_flag = true;
+	  }
+
+	if (entry.owned) delete entry.task;
+
+	//This must be the last access to the entry, as the group may be
+	//destroyed as soon as its pending count reaches zero.
+	entry.group->taskCompleted();
+      }
+
+      inline void checkExceptions()
+      {
+	if (!_exception_flag) return;
+
+	magnet::thread::ScopedLock lock1(_exception_mutex);
+	std::string data = _exception_data.str();
+	_exception_data.str("");
+	_exception_flag = false;
+	M_throw() << "Thread Exception found while waiting for tasks/threads to finish"
+		  << data;
+      }
+
+      /*! \brief Thread worker loop.
+       *
+       * A worker runs tasks while it can find them. When it cannot,
+       * it spins for a while before parking itself on the wake
+       * condition.
+       */
+      inline void beginThread(Worker* worker)
+      {
+	currentWorker() = worker;
+	const size_t spinLimit = 2048;
+
+	while (!_stop_flag)
+	  {
+	    if (runPendingTask()) continue;
+
+	    bool found = false;
+	    for (size_t spin(0); (spin < spinLimit) && !found && !_stop_flag; ++spin)
+	      {
+		detail::cpu_relax();
+		found = runPendingTask();
+	      }
+
+	    if (found || _stop_flag) continue;
+
+	    //Park the thread
+	    magnet::thread::ScopedLock lock1(_sleepMutex);
+	    __sync_fetch_and_add(&_sleepers, 1);
+	    const unsigned long epoch = _wakeEpoch;
+
+	    //The increment of _sleepers is a full barrier, so either we
+	    //see any task pushed before it, or the pusher sees us asleep.
+	    if (!workAvailable())
+	      while ((epoch == _wakeEpoch) && !_stop_flag)
+		_wakeCondition.wait(lock1);
+
+	    __sync_fetch_and_sub(&_sleepers, 1);
+	  }
+
+	currentWorker() = NULL;
+      }
+
+      /*! \brief Halt the pool and terminate all the threads.
+       */
+      inline void stop()
+      {
+	{
+	  magnet::thread::ScopedLock lock1(_sleepMutex);
+	  _stop_flag = true;
+	  ++_wakeEpoch;
+	}
+
+	_wakeCondition.notify_all();
+	_threads.join_all();
+
+	for (size_t i(0); i < _workers.size(); ++i)
+	  delete _workers[i];
+	_workers.clear();
+      }
+
+      std::vector<Worker*> _workers;
+      detail::WorkStealingDeque* _external;
+      volatile int _externalLock;
+
+      magnet::thread::ThreadGroup _threads;
+
+      magnet::thread::Mutex _sleepMutex;
+      magnet::thread::Condition _wakeCondition;
+      volatile long _sleepers;
+      volatile unsigned long _wakeEpoch;
+      volatile bool _stop_flag;
+
+      volatile bool _exception_flag;
+      std::ostringstream _exception_data;
+      magnet::thread::Mutex _exception_mutex;
+
+      TaskGroup _defaultGroup;
+    };
+
+    inline void
+    TaskGroup::spawn(function::Task& task)
+    { _pool.push(&task, this, false); }
+
+    inline void
+    TaskGroup::helpOrRelax()
+    { if (!_pool.runPendingTask()) detail::cpu_relax(); }
+
+    inline void
+    TaskGroup::wait()
+    {
+      while (_pending) helpOrRelax();
+      _pool.checkExceptions();
+    }
+  }
+}
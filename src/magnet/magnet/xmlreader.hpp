@@ -19,10 +19,8 @@
 
 #include <magnet/detail/rapidXML/rapidxml.hpp>
 #include <magnet/exception.hpp>
+#include <magnet/stream/bzip2.hpp>
 #include <boost/iostreams/device/file.hpp>
-#include <boost/iostreams/filtering_stream.hpp>
-#include <boost/iostreams/filter/bzip2.hpp>
-#include <boost/iostreams/chain.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/copy.hpp>
 #include <boost/filesystem.hpp>
@@ -292,38 +290,52 @@ namespace magnet {
       /*! \brief Construct an XML Document from a file.
        *
        * \param fileName Path to the file to load.
+       * \param pool A thread pool used to decompress ".xml.bz2" files
+       * made of several bzip2 streams (see
+       * stream::parallelBzip2Decompress), may be NULL.
        */
-      inline Document(std::string fileName)
+      inline Document(std::string fileName, thread::WorkStealingPool* pool = NULL)
       {
 	namespace io = boost::iostreams;
 
 	if (!boost::filesystem::exists(fileName))
 	  M_throw() << "Could not find the XML file named " << fileName
 		    << "\nPlease check the file exists.";
-	{ //This scopes out the file objects
-	  
-	  //We use the boost iostreams library to load the file into a
-	  //string which may be compressed.
-	  
-	  //We make our filtering iostream
-	  io::filtering_istream inputFile;
-	  
-	  //Now check if we should add a decompressor filter
-	  if (std::string(fileName.end()-8, fileName.end()) == ".xml.bz2")
-	      inputFile.push(io::bzip2_decompressor());
-	  else if (!(std::string(fileName.end()-4, fileName.end()) == ".xml"))
-	    M_throw() << "Unrecognized extension for xml file";
-
-	  //Finally, add the file as a source
-	  inputFile.push(io::file_source(fileName));
-	  
-	  //Force the copy to occur
-	  io::copy(inputFile, io::back_inserter(_data));
-	}
+
+	if (std::string(fileName.end()-8, fileName.end()) == ".xml.bz2")
+	  {
+	    //Load the compressed file and decompress it in parallel
+	    std::string compressed;
+	    compressed.reserve(boost::filesystem::file_size(fileName));
+	    {
+	      io::file_source inputFile(fileName, std::ios::in | std::ios::binary);
+	      io::copy(inputFile, io::back_inserter(compressed));
+	    }
+
+	    stream::parallelBzip2Decompress(compressed.data(), compressed.size(), _data, pool);
+	  }
+	else if (std::string(fileName.end()-4, fileName.end()) == ".xml")
+	  { //This scopes out the file objects
+	    io::file_source inputFile(fileName);
+	    io::copy(inputFile, io::back_inserter(_data));
+	  }
+	else
+	  M_throw() << "Unrecognized extension for xml file";
 
 	_doc.parse<rapidxml::parse_trim_whitespace>(&_data[0]);
       }
-      
+
+      /*! \brief Construct an XML Document from text held in memory.
+       *
+       * \param data The XML text, which is copied into the Document.
+       * \param length The length of the text.
+       */
+      inline Document(const char* data, size_t length):
+	_data(data, length)
+      {
+	_doc.parse<rapidxml::parse_trim_whitespace>(&_data[0]);
+      }
+
       /*! \brief Return the first Node with a certain name in the
        * Document.
        * 
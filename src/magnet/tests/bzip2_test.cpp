@@ -0,0 +1,116 @@
+#include <iostream>
+#include <cstdlib>
+#include <magnet/stream/bzip2.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/copy.hpp>
+
+namespace io = boost::iostreams;
+
+//Compressible data, similar to a configuration file
+std::string makeData(size_t size)
+{
+  std::string data;
+  while (data.size() < size)
+    {
+      std::ostringstream os;
+      os << "<Pt ID=\"" << data.size() << "\"><P x=\"" << std::rand()
+	 << "\" y=\"" << std::rand() << "\"/></Pt>\n";
+      data += os.str();
+    }
+  data.resize(size);
+  return data;
+}
+
+std::string compress(const std::string& data, magnet::thread::WorkStealingPool* pool, size_t blockSize)
+{
+  std::string out;
+  {
+    io::filtering_ostream os;
+    os.push(magnet::stream::ParallelBzip2Compressor(pool, 9, blockSize));
+    os.push(io::back_inserter(out));
+    os.write(data.data(), data.size());
+  }
+  return out;
+}
+
+//Decompress with the boost filter, the output must be readable by
+//existing tools
+std::string boostDecompress(const std::string& data)
+{
+  std::string out;
+  io::filtering_istream is;
+  is.push(io::bzip2_decompressor());
+  is.push(io::array_source(data.data(), data.size()));
+  io::copy(is, io::back_inserter(out));
+  return out;
+}
+
+std::string boostCompress(const std::string& data)
+{
+  std::string out;
+  {
+    io::filtering_ostream os;
+    os.push(io::bzip2_compressor());
+    os.push(io::back_inserter(out));
+    os.write(data.data(), data.size());
+  }
+  return out;
+}
+
+bool check(const std::string& name, const std::string& a, const std::string& b)
+{
+  if (a == b) return true;
+  std::cout << name << " failed, " << a.size() << " bytes != " << b.size() << " bytes\n";
+  return false;
+}
+
+int main()
+{
+  magnet::thread::WorkStealingPool pool;
+  pool.setThreadCount(3);
+
+  bool passed = true;
+
+  const size_t sizes[] = {0, 1, 99999, 100000, 100001, 3000000};
+  for (size_t i(0); i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+      const std::string data = makeData(sizes[i]);
+
+      //Many small blocks, so there are several batches of streams
+      const std::string parallel = compress(data, &pool, 100000);
+      const std::string serial = compress(data, NULL, 100000);
+      passed &= check("Serial and parallel compression", parallel, serial);
+      passed &= check("Decompression by boost", boostDecompress(parallel), data);
+
+      std::string out;
+      magnet::stream::parallelBzip2Decompress(parallel.data(), parallel.size(), out, &pool);
+      passed &= check("Parallel decompression", out, data);
+
+      out.clear();
+      magnet::stream::parallelBzip2Decompress(parallel.data(), parallel.size(), out, NULL);
+      passed &= check("Serial decompression", out, data);
+
+      //A single stream written by another tool
+      const std::string single = boostCompress(data);
+      out.clear();
+      magnet::stream::parallelBzip2Decompress(single.data(), single.size(), out, &pool);
+      passed &= check("Parallel decompression of a single stream", out, data);
+
+      //Truncated data must be detected
+      if (parallel.size() > 100)
+	try {
+	  out.clear();
+	  magnet::stream::parallelBzip2Decompress(parallel.data(), parallel.size() - 10, out, &pool);
+	  std::cout << "Truncated data was not detected\n";
+	  passed = false;
+	} catch (std::exception&) {}
+    }
+
+  if (!passed) return 1;
+
+  std::cout << "All tests passed\n";
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <cstdlib>
+#include <magnet/math/dilatedint.hpp>
+
+using namespace magnet::math;
+
+uint64_t naiveDilate(uint64_t val)
+{
+  uint64_t result = 0;
+  for (size_t bit(0); bit < DilatedInteger::digits; ++bit)
+    result |= ((val >> bit) & 1) << (3 * bit);
+  return result;
+}
+
+uint64_t random21()
+{
+  return ((uint64_t(std::rand()) << 16) ^ std::rand()) & DilatedInteger::undilatedMask;
+}
+
+int main()
+{
+  size_t errors = 0;
+
+  for (size_t i(0); i < 1000000; ++i)
+    {
+      //Every value up to 2^16, then random values over all 21 bits
+      const uint64_t val = (i < 65536) ? i : random21();
+
+      if (detail::dilate_3_table(val) != naiveDilate(val))
+	{ std::cout << "Table dilation failed for " << val << "\n"; ++errors; }
+
+      if (detail::undilate_3_shift(naiveDilate(val)) != val)
+	{ std::cout << "Shift contraction failed for " << val << "\n"; ++errors; }
+
+      //Uses pdep/pext if BMI2 is enabled
+      const DilatedInteger d(val);
+      if ((d.getDilatedVal() != naiveDilate(val)) || (d.getRealVal() != val))
+	{ std::cout << "DilatedInteger conversion failed for " << val << "\n"; ++errors; }
+
+      if (errors > 10) return 1;
+    }
+
+  //The arithmetic is modulo 2^21
+  for (size_t i(0); i < 100000; ++i)
+    {
+      const uint64_t a = random21(), b = random21();
+      const DilatedInteger da(a), db(b);
+
+      if ((da + db).getRealVal() != ((a + b) & DilatedInteger::undilatedMask))
+	{ std::cout << "Addition failed for " << a << " + " << b << "\n"; ++errors; }
+
+      if ((da - db).getRealVal() != ((a - b) & DilatedInteger::undilatedMask))
+	{ std::cout << "Subtraction failed for " << a << " - " << b << "\n"; ++errors; }
+
+      DilatedInteger inc(da), dec(da);
+      ++inc;
+      --dec;
+      if ((inc.getRealVal() != ((a + 1) & DilatedInteger::undilatedMask))
+	  || (dec.getRealVal() != ((a - 1) & DilatedInteger::undilatedMask)))
+	{ std::cout << "Increment/decrement failed for " << a << "\n"; ++errors; }
+
+      //Morton numbers interleave the bits of the coordinates
+      const uint64_t c = random21();
+      const DilatedVector v(a, b, c);
+      const uint64_t morton = naiveDilate(a) | (naiveDilate(b) << 1) | (naiveDilate(c) << 2);
+      if (v.getMortonNum() != morton)
+	{ std::cout << "Morton number failed for " << a << "," << b << "," << c << "\n"; ++errors; }
+
+      const DilatedVector w(morton);
+      if ((w.data[0].getRealVal() != a) || (w.data[1].getRealVal() != b)
+	  || (w.data[2].getRealVal() != c))
+	{ std::cout << "Morton number decoding failed for " << morton << "\n"; ++errors; }
+
+      if (errors > 10) return 1;
+    }
+
+  if (errors) return 1;
+
+  std::cout << "All tests passed\n";
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//A microbenchmark comparing the OpenHashSet against the node based
+//std::tr1::unordered_set for the access pattern of the capture maps
+//of the square well interactions.
+//
+//The set is filled with N particle pairs, then pairs are repeatedly
+//looked up, erased and reinserted (a well exit followed by a well
+//entry). The memory use of the tr1 container is measured with a
+//counting allocator (excluding the malloc overhead per node), the
+//OpenHashSet memory is its single array.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <time.h>
+#include <stdint.h>
+#include <boost/tr1/unordered_set.hpp>
+#include <magnet/containers/OpenHash.hpp>
+
+inline double wallTime()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+size_t allocatedBytes = 0;
+
+template<class T>
+struct CountingAllocator: public std::allocator<T>
+{
+  template<class U> struct rebind { typedef CountingAllocator<U> other; };
+
+  CountingAllocator() {}
+  template<class U> CountingAllocator(const CountingAllocator<U>&) {}
+
+  T* allocate(size_t n, const void* = 0)
+  {
+    allocatedBytes += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, size_t n)
+  {
+    allocatedBytes -= n * sizeof(T);
+    std::allocator<T>().deallocate(p, n);
+  }
+};
+
+typedef std::pair<uint32_t, uint32_t> Key;
+
+struct KeyHash
+{
+  uint64_t operator()(const Key& key) const
+  { return (uint64_t(key.first) << 32) | key.second; }
+};
+
+typedef std::tr1::unordered_set<Key, KeyHash, std::equal_to<Key>,
+				CountingAllocator<Key> > NodeSet;
+typedef magnet::containers::OpenHashSet<Key, KeyHash> OpenSet;
+
+template<class Set>
+void bench(Set& set, const char* name, const std::vector<Key>& keys, size_t updates)
+{
+  double start = wallTime();
+  for (size_t i(0); i < keys.size(); ++i)
+    set.insert(keys[i]);
+  double fill = wallTime() - start;
+
+  size_t found = 0;
+  start = wallTime();
+  for (size_t i(0); i < updates; ++i)
+    {
+      const Key& key = keys[(i * 2654435761u) % keys.size()];
+      found += set.count(key);
+      set.erase(key);
+      set.insert(key);
+    }
+  double update = wallTime() - start;
+
+  std::cout << std::setw(20) << name
+	    << std::setw(14) << keys.size() / fill / 1e6
+	    << std::setw(14) << updates / update / 1e6
+	    << std::setw(14) << (found == updates ? "" : "(lookup error)")
+	    << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  size_t N = (argc > 1) ? std::atol(argv[1]) : 2000000;
+  size_t updates = 10000000;
+
+  //Random bonded pairs between particles of a system of N/4 particles
+  std::srand(1);
+  std::vector<Key> keys;
+  {
+    OpenSet unique(Key(0, 0));
+    while (keys.size() < N)
+      {
+	uint32_t a = std::rand() % (N / 4), b = std::rand() % (N / 4);
+	if (a == b) continue;
+	Key key(std::min(a, b), std::max(a, b));
+	if (unique.insert(key).second) keys.push_back(key);
+      }
+  }
+
+  std::cout << N << " pairs\n"
+	    << std::setw(20) << "Container"
+	    << std::setw(14) << "Fill (M/s)"
+	    << std::setw(14) << "Update (M/s)" << std::endl;
+
+  size_t nodeBytes;
+  {
+    NodeSet set;
+    bench(set, "tr1::unordered_set", keys, updates);
+    nodeBytes = allocatedBytes;
+  }
+
+  OpenSet set(Key(0, 0));
+  bench(set, "OpenHashSet", keys, updates);
+  size_t openBytes = set.bucket_count() * sizeof(Key);
+
+  std::cout << "Memory per pair: tr1::unordered_set " << double(nodeBytes) / N
+	    << " bytes (plus malloc overhead), OpenHashSet "
+	    << double(openBytes) / N << " bytes" << std::endl;
+  return 0;
+}
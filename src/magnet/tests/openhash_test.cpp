@@ -0,0 +1,102 @@
+#include <iostream>
+#include <map>
+#include <cstdlib>
+#include <magnet/containers/OpenHash.hpp>
+
+struct IdentityHash
+{
+  size_t operator()(const size_t& key) const { return key; }
+};
+
+typedef magnet::containers::OpenHashMap<size_t, int, IdentityHash> Map;
+typedef std::map<size_t, int> RefMap;
+
+bool compare(const Map& map, const RefMap& ref)
+{
+  if (map.size() != ref.size())
+    { std::cout << "Size mismatch " << map.size() << " != " << ref.size(); return false; }
+
+  size_t count = 0;
+  for (Map::const_iterator it = map.begin(); it != map.end(); ++it, ++count)
+    {
+      RefMap::const_iterator rit = ref.find(it->first);
+      if ((rit == ref.end()) || (rit->second != it->second))
+	{ std::cout << "Iteration found a bad entry " << it->first; return false; }
+    }
+
+  if (count != ref.size())
+    { std::cout << "Iteration visited " << count << " entries, not " << ref.size(); return false; }
+
+  for (RefMap::const_iterator rit = ref.begin(); rit != ref.end(); ++rit)
+    {
+      Map::const_iterator it = map.find(rit->first);
+      if ((it == map.end()) || (it->second != rit->second))
+	{ std::cout << "Lookup failed for " << rit->first; return false; }
+    }
+
+  return true;
+}
+
+int main()
+{
+  Map map(size_t(-1));
+  RefMap ref;
+
+  std::srand(42);
+  //A small key range forces long probe sequences and lots of
+  //backward shift deletions through clusters
+  for (size_t step(0); step < 200000; ++step)
+    {
+      size_t key = std::rand() % 4096;
+      switch (std::rand() % 4)
+	{
+	case 0:
+	case 1:
+	  {
+	    int val = std::rand();
+	    std::pair<Map::iterator, bool> res = map.insert(std::make_pair(key, val));
+	    if (res.second != ref.insert(std::make_pair(key, val)).second)
+	      { std::cout << "insert() disagrees for " << key; return 1; }
+	    if (res.first->first != key)
+	      { std::cout << "insert() returned a bad iterator for " << key; return 1; }
+	    break;
+	  }
+	case 2:
+	  if (map.erase(key) != ref.erase(key))
+	    { std::cout << "erase(key) disagrees for " << key; return 1; }
+	  break;
+	case 3:
+	  {
+	    Map::iterator it = map.find(key);
+	    if (it != map.end())
+	      {
+		map.erase(it);
+		ref.erase(key);
+	      }
+	    else
+	      {
+		map[key] = 7;
+		ref[key] = 7;
+	      }
+	    break;
+	  }
+	}
+
+      if (map.count(key) != ref.count(key))
+	{ std::cout << "count() disagrees for " << key; return 1; }
+
+      if (!(step % 10000) && !compare(map, ref)) return 1;
+    }
+
+  if (!compare(map, ref)) return 1;
+
+  if (map.load_factor() > map.max_load_factor())
+    { std::cout << "Load factor exceeded " << map.load_factor(); return 1; }
+
+  size_t buckets = map.bucket_count();
+  map.clear();
+  ref.clear();
+  if (!compare(map, ref) || (map.bucket_count() != buckets)) return 1;
+
+  return 0;
+}
@@ -0,0 +1,137 @@
+/*  dynamo:- Event driven molecular dynamics simulator 
+    http://www.marcusbannerman.co.uk/dynamo
+    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+
+    This program is free software: you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    version 3 as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//A microbenchmark comparing the task dispatch latency and throughput
+//of the mutex/condition based ThreadPool against the
+//WorkStealingPool. 
+//
+//Latency is measured as the round trip time of queueing a single
+//empty task and waiting for it. Throughput is the rate at which many
+//small tasks are executed. The WorkStealingPool is tested both
+//through the ThreadPool compatible interface (heap allocated tasks)
+//and the fork-join interface (stack allocated tasks).
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <time.h>
+#include <magnet/thread/threadpool.hpp>
+#include <magnet/thread/workstealing.hpp>
+
+inline double wallTime()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+volatile size_t counter;
+
+void emptyTask(size_t) {}
+
+void smallTask(size_t i) 
+{
+  size_t sum = 0;
+  for (size_t j(0); j < 64; ++j) sum += j * i;
+  counter += (sum == 1);
+}
+
+template<class Pool>
+void heapTaskBench(Pool& pool, const char* name, size_t latencyLoops, size_t throughputTasks)
+{
+  double start = wallTime();
+  for (size_t i(0); i < latencyLoops; ++i)
+    {
+      pool.queueTask(magnet::function::Task::makeTask(emptyTask, i));
+      pool.wait();
+    }
+  double latency = (wallTime() - start) / latencyLoops;
+
+  start = wallTime();
+  for (size_t i(0); i < throughputTasks; ++i)
+    pool.queueTask(magnet::function::Task::makeTask(smallTask, i));
+  pool.wait();
+  double throughput = throughputTasks / (wallTime() - start);
+
+  std::cout << std::setw(28) << name 
+	    << std::setw(16) << latency * 1e6
+	    << std::setw(16) << throughput << std::endl;
+}
+
+void forkJoinBench(magnet::thread::WorkStealingPool& pool, size_t latencyLoops, size_t throughputTasks)
+{
+  magnet::function::Task1<void, size_t> 
+    empty(magnet::function::Delegate1<size_t, void>(&emptyTask), 0);
+
+  double start = wallTime();
+  for (size_t i(0); i < latencyLoops; ++i)
+    {
+      magnet::thread::TaskGroup group(pool);
+      group.spawn(empty);
+      group.wait();
+    }
+  double latency = (wallTime() - start) / latencyLoops;
+
+  //Tasks are spawned in batches, reusing the same stack allocated tasks
+  const size_t batch = 256;
+  std::vector<magnet::function::Task1<void, size_t> > tasks
+    (batch, magnet::function::Task1<void, size_t>(magnet::function::Delegate1<size_t, void>(&smallTask), 1));
+
+  start = wallTime();
+  for (size_t i(0); i < throughputTasks / batch; ++i)
+    {
+      magnet::thread::TaskGroup group(pool);
+      for (size_t j(0); j < batch; ++j)
+	group.spawn(tasks[j]);
+      group.wait();
+    }
+  double throughput = batch * (throughputTasks / batch) / (wallTime() - start);
+
+  std::cout << std::setw(28) << "WorkStealingPool fork-join"
+	    << std::setw(16) << latency * 1e6
+	    << std::setw(16) << throughput << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  size_t maxThreads = (argc > 1) ? std::atoi(argv[1]) : 8;
+  const size_t latencyLoops = 20000;
+  const size_t throughputTasks = 200000;
+
+  std::cout << std::setw(28) << "Pool" 
+	    << std::setw(16) << "Latency (us)" 
+	    << std::setw(16) << "Tasks/s" << std::endl;
+
+  for (size_t threads(1); threads <= maxThreads; threads *= 2)
+    {
+      std::cout << "Threads = " << threads << std::endl;
+      {
+	magnet::thread::ThreadPool pool;
+	pool.setThreadCount(threads);
+	heapTaskBench(pool, "ThreadPool", latencyLoops, throughputTasks);
+      }
+      {
+	magnet::thread::WorkStealingPool pool;
+	pool.setThreadCount(threads);
+	heapTaskBench(pool, "WorkStealingPool queueTask", latencyLoops, throughputTasks);
+	forkJoinBench(pool, latencyLoops, throughputTasks);
+      }
+    }
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <magnet/thread/workstealing.hpp>
+
+std::vector<float> sums;
+
+void function1(int i)
+{  
+  float sum = 0;
+  for (int j = 0; j < i; ++j)
+    sum += j;
+
+  sums[i] = sum;
+}
+
+//A recursive fork-join task, the tasks are all allocated on the stack
+struct Fibonacci
+{
+  Fibonacci(magnet::thread::WorkStealingPool& pool): _pool(pool) {}
+
+  void run(std::pair<size_t, size_t*> arg)
+  {
+    if (arg.first < 2) { *arg.second = arg.first; return; }
+
+    size_t a, b;
+    magnet::function::Task1<void, std::pair<size_t, size_t*> >
+      taskA(magnet::function::MakeDelegate(this, &Fibonacci::run), std::make_pair(arg.first - 1, &a)),
+      taskB(magnet::function::MakeDelegate(this, &Fibonacci::run), std::make_pair(arg.first - 2, &b));
+
+    magnet::thread::TaskGroup group(_pool);
+    group.spawn(taskA);
+    group.spawn(taskB);
+    group.wait();
+
+    *arg.second = a + b;
+  }
+
+  magnet::thread::WorkStealingPool& _pool;
+};
+
+void thrower(int) { throw std::runtime_error("Expected exception"); }
+
+int main()
+{
+  int N = 1000;
+  sums.resize(N);
+
+  for (size_t threads(0); threads < 5; ++threads)
+    {
+      magnet::thread::WorkStealingPool pool;
+      pool.setThreadCount(threads);
+
+      std::cerr << "Using " << pool.getThreadCount() << " threads\n";
+
+      //The ThreadPool compatible interface
+      for (size_t loop(0); loop < 100; ++loop)
+	{
+	  for (int i = 0; i < N; ++i)   
+	    pool.queueTask(magnet::function::Task::makeTask(function1, i));
+	  
+	  pool.wait();
+	  
+	  for (int i = N-1; i >= 0; --i)
+	    {
+	      float tmp = sums[i];
+	      function1(i);
+	      if (sums[i] != tmp) 
+		{
+		  std::cerr << "Failure in loop " << loop << "\n";
+		  throw std::runtime_error("Muck up in function 1");
+		}
+	    }
+	}
+
+      //Nested fork-join
+      Fibonacci fib(pool);
+      size_t result;
+      fib.run(std::make_pair(size_t(20), &result));
+      if (result != 6765)
+	throw std::runtime_error("Fork-join Fibonacci returned the wrong result");
+
+      //Exceptions must be passed back to the waiting thread
+      bool caught = false;
+      pool.queueTask(magnet::function::Task::makeTask(thrower, 0));
+      try { pool.wait(); }
+      catch (std::exception&) { caught = true; }
+      if (!caught)
+	throw std::runtime_error("Task exception was not rethrown by wait()");
+    }
+
+  std::cerr << "Finished\n";
+
+  return 0;
+}
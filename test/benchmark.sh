@@ -0,0 +1,133 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# The benchmark suite of dynarun (bjam benchmark or make benchmark).
+# A fixed matrix of systems is generated by dynamod with a fixed
+# random seed, equilibrated once, and then each system is run NUMRUN
+# times for NCOLL events from the same starting configuration.
+#
+# The results are written to benchmark.<label>.dat, where the label
+# is the first argument or the git revision of the tree. Each system
+# is written on one line as
+#
+# "system N events/s stddev ns/event peakRSS(kB) sort-fraction
+#  lazy-deletions/event rejections/event exception-events"
+#
+# The sort fraction, lazy deletions and rejections come from the
+# EventProfile plugin and the exception events from the BoundedPQ
+# sorter. Two result files are compared by benchmark_compare.sh,
+# which flags the regressions beyond the measured noise.
+
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+Xml="xml"
+which $Xml > /dev/null || Xml="xmlstarlet"
+
+NUMRUN=${NUMRUN:-3}
+NCOLL=${NCOLL:-1000000}
+#The equilibration run before the benchmark of each system
+NEQUIL=${NEQUIL:-200000}
+#Unit cells per side, the crystal packed systems have 4*C^3 particles
+CELLS=${CELLS:-"5 10 20"}
+
+if [ ! -x $dynarun ] || [ ! -x $dynamod ]; then
+    echo "Could not find dynarun/dynamod, have you built them?"
+    exit 1
+fi
+
+which $Xml > /dev/null || { echo "Could not find XMLStarlet"; exit 1; }
+which gawk > /dev/null || { echo "Could not find gawk"; exit 1; }
+
+label=${1:-$(git describe --always --dirty 2> /dev/null || echo "unknown")}
+results=benchmark.$label.dat
+
+function xmlval {
+    bzcat output.xml.bz2 | $Xml sel -t -v "$1"
+}
+
+function benchmark {
+    #$1 is the name of the system, the remaining arguments are passed
+    #to dynamod to generate it
+    local name=$1
+    shift
+
+    $dynamod -s 1 "$@" -o bench.start.xml.bz2 > /dev/null 2>&1 \
+	|| { echo "Could not generate the $name system"; return; }
+    #The equilibrated configuration is binary, so every run restarts
+    #exactly from the same state
+    $dynarun -s 1 -E -c $NEQUIL bench.start.xml.bz2 \
+	-o bench.equil.dyn > /dev/null 2>&1 \
+	|| { echo "Could not equilibrate the $name system"; return; }
+
+    > bench.vals
+    for i in $(seq 1 $NUMRUN); do
+	echo -n "Running $name, run $i of $NUMRUN...."
+	if ! $dynarun -s 1 -c $NCOLL bench.equil.dyn \
+	    -o bench.end.dyn -L EventProfile > bench.log 2>&1; then
+	    echo "FAILED"
+	    return
+	fi
+	echo $(xmlval '/OutputData/Misc/Timing/CollPerSec/@val') \
+	    $(xmlval '/OutputData/Misc/Memusage/@MaxKiloBytes') \
+	    $(xmlval "/OutputData/EventProfile/Section[@Name='Sort']/@Fraction") \
+	    $(xmlval '/OutputData/EventProfile/@LazyDeletions') \
+	    $(xmlval 'sum(/OutputData/EventProfile/Event/@Rejections)') \
+	    $(grep "Exception Events" bench.log | tail -n 1 | gawk '{print $NF+0}') \
+	    | tee -a bench.vals
+    done
+
+    local N=$(xmlval '/OutputData/Misc/ParticleCount/@val')
+
+    #Averages over the runs, the memory is the peak of all runs
+    gawk -v name=$name -v N=$N -v ncoll=$NCOLL \
+	'{sum+=$1; sqrsum+=$1*$1; if ($2 > rss) rss=$2;
+          sort+=$3; lazy+=$4; rej+=$5; if ($6 > exc) exc=$6}
+         END {mean=sum/NR; dev=sqrsum/NR-mean*mean; if (dev < 0) dev=0;
+              printf "%s %d %g %g %g %d %g %g %g %d\n", name, N, mean, sqrt(dev),
+                     1e9/mean, rss, sort/NR, lazy/(NR*ncoll), rej/(NR*ncoll), exc}' \
+	bench.vals | tee -a $results
+}
+
+> $results
+echo "# dynarun benchmark of $label on $(hostname), $(date)" >> $results
+echo "# NCOLL=$NCOLL NUMRUN=$NUMRUN" >> $results
+echo "# system N events/s stddev ns/event peakRSS(kB) sort-fraction lazy-deletions/event rejections/event exception-events" >> $results
+
+for C in $CELLS; do
+    #Hard spheres from a gas to a dense fluid
+    for dens in 0.1 0.5 0.9; do
+	benchmark HS_d$dens -m 0 -d $dens -C $C
+    done
+
+    #Square wells
+    benchmark SW -m 1 -d 0.5 -C $C
+
+    #An isolated attractive polymer, the chain length grows with C
+    benchmark Polymer -m 2 --i1 $((4 * C))
+
+    #Granular spheres bouncing on a plate under gravity
+    benchmark Gravity -m 22 -C $C
+
+    #Inelastic spheres sheared by Lees-Edwards boundary conditions
+    benchmark LEBC -m 4 -d 0.5 --f1 0.9 -C $C
+
+    #Hard spheres confined between two walls
+    benchmark Walls -m 6 -d 0.5 -C $C
+done
+
+rm -f bench.start.xml.bz2 bench.equil.dyn bench.end.dyn \
+    bench.vals bench.log output.xml.bz2
@@ -0,0 +1,68 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Compares two result files of benchmark.sh, e.g.
+#
+#  ./benchmark_compare.sh benchmark.<old>.dat benchmark.<new>.dat
+#
+# A system is flagged as a REGRESSION if its events/s dropped by more
+# than SIGMA standard deviations of the combined noise of both
+# measurements AND by more than TOLERANCE (a fraction), so a single
+# noisy run is not reported. Speed ups are flagged as FASTER in the
+# same way. The peak memory is flagged if it grew by more than
+# MEMTOLERANCE. The exit status is 1 if any regression was found, so
+# this may be used with git bisect run.
+
+if [ $# != 2 ]; then
+    echo "Usage: $0 old.dat new.dat"
+    exit 2
+fi
+
+SIGMA=${SIGMA:-3}
+TOLERANCE=${TOLERANCE:-0.02}
+MEMTOLERANCE=${MEMTOLERANCE:-0.1}
+
+gawk -v sigma=$SIGMA -v tol=$TOLERANCE -v memtol=$MEMTOLERANCE '
+/^#/ {next}
+#The systems of the old results
+FNR == NR {key=$1" "$2; rate[key]=$3; dev[key]=$4; rss[key]=$6; next}
+{
+    key=$1" "$2;
+    if (!(key in rate)) {printf "%-12s %8d %12s\n", $1, $2, "NEW"; next}
+    seen[key]=1;
+
+    change=($3 - rate[key]) / rate[key];
+    noise=sigma * sqrt(dev[key]^2 + $4^2);
+    status="";
+    if ((rate[key] - $3 > noise) && (-change > tol))
+      {status="REGRESSION"; ++regressions}
+    else if (($3 - rate[key] > noise) && (change > tol))
+      status="FASTER";
+
+    memchange=(rss[key] > 0) ? ($6 - rss[key]) / rss[key] : 0;
+    if (memchange > memtol)
+      {status=(status ? status" " : "")"MEMORY"; ++regressions}
+
+    printf "%-12s %8d %12g -> %12g events/s %+7.2f%% (noise %g) %+7.2f%% RSS %s\n",
+      $1, $2, rate[key], $3, 100 * change, noise, 100 * memchange, status;
+}
+END {
+    for (key in rate)
+      if (!(key in seen)) {split(key, k, " "); printf "%-12s %8d %12s\n", k[1], k[2], "MISSING"}
+    if (regressions) {print regressions" regression(s) found"; exit 1}
+    print "No regressions found"
+}' "$1" "$2"
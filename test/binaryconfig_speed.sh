@@ -0,0 +1,48 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Compares loading and writing square well configurations (with
+# their capture maps) as bzip2 compressed XML and as binary
+# configuration files. Each configuration is converted by dynamod
+# between every pair of formats, the wall clock time and the peak
+# resident set size of each conversion are appended to
+# binaryconfig.<N>.dat as "input output seconds kilobytes".
+
+dynamod="../bin/dynamod"
+Time="/usr/bin/time"
+
+#Unit cells per side, the systems have 4*C^3 particles
+CELLS="20 40 63 100"
+FORMATS="xml.bz2 dyn"
+
+for C in $CELLS; do
+    N=$((4 * C * C * C))
+    $dynamod -m 1 -d 0.8 -C $C -o sw.xml.bz2 > /dev/null
+    $dynamod sw.xml.bz2 -o sw.dyn > /dev/null
+
+    > binaryconfig.$N.dat
+    echo "Square well fluid, $N particles"
+    for in in $FORMATS; do
+	for out in $FORMATS; do
+	    echo $in $out $($Time -f "%e %M" $dynamod sw.$in -o out.$out 2>&1 > /dev/null | tail -n 1) \
+		| tee -a binaryconfig.$N.dat
+	done
+    done
+    ls -l sw.xml.bz2 sw.dyn
+done
+
+rm -f sw.xml.bz2 sw.dyn out.xml.bz2 out.dyn
@@ -0,0 +1,53 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Measures the startup time of dynarun on square well fluids when the
+# capture map has to be rebuilt (the CaptureMap is stripped from the
+# configuration), as a function of the thread count. The startup time
+# with the stored capture map is given as a reference. Results are
+# appended to capturemap.<N>.dat as "threads seconds".
+
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+Xml="xml"
+which $Xml > /dev/null || Xml="xmlstarlet"
+
+THREADS="0 1 2 4 8"
+#Unit cells per side, the systems have 4*C^3 particles
+CELLS="20 40 63"
+
+function starttime {
+    local start=$(date +%s.%N)
+    $dynarun "$@" -c 1 -o /dev/null > /dev/null
+    local end=$(date +%s.%N)
+    echo "$end - $start" | gawk '{print $1 - $3}'
+}
+
+for C in $CELLS; do
+    N=$((4 * C * C * C))
+    $dynamod -m 1 -d 0.8 -C $C -o sw.stored.xml.bz2 > /dev/null
+    bzcat sw.stored.xml.bz2 | $Xml ed -d '//CaptureMap' | bzip2 > sw.rebuild.xml.bz2
+
+    > capturemap.$N.dat
+    echo "Square well fluid, $N particles"
+    echo "stored" $(starttime sw.stored.xml.bz2) | tee -a capturemap.$N.dat
+    for T in $THREADS; do
+	echo $T $(starttime sw.rebuild.xml.bz2 -N $T) | tee -a capturemap.$N.dat
+    done
+done
+
+rm -f sw.stored.xml.bz2 sw.rebuild.xml.bz2 output.xml.bz2
@@ -0,0 +1,55 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Measures the time dynarun takes to load and write out a large
+# compressed configuration as a function of the thread count, as the
+# bzip2 (de)compression is parallelised over the thread pool. The
+# binary configuration (which is not compressed) is given as a
+# reference. Results are appended to compression.<N>.dat as
+# "threads seconds".
+
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+
+THREADS="0 1 2 4 8"
+#Unit cells per side, the systems have 4*C^3 particles
+CELLS="63"
+
+function runtime {
+    local start=$(date +%s.%N)
+    $dynarun "$@" -c 1 > /dev/null
+    local end=$(date +%s.%N)
+    echo "$end - $start" | gawk '{print $1 - $3}'
+}
+
+for C in $CELLS; do
+    N=$((4 * C * C * C))
+    $dynamod -m 1 -d 0.8 -C $C -o sw.xml.bz2 > /dev/null
+    $dynamod sw.xml.bz2 -o sw.dyn > /dev/null
+
+    > compression.$N.dat
+    echo "Square well fluid, $N particles"
+    echo "binary" $(runtime sw.dyn -o out.dyn) | tee -a compression.$N.dat
+    for T in $THREADS; do
+	echo $T $(runtime sw.xml.bz2 -N $T -o out.xml.bz2) | tee -a compression.$N.dat
+    done
+
+    #The output must remain readable by the standard tools
+    bzip2 -t out.xml.bz2 || echo "bzip2 could not read the output"
+done
+
+rm -f sw.xml.bz2 sw.dyn out.xml.bz2 out.dyn output.xml.bz2
@@ -0,0 +1,65 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Compares the cell transition throughput of the Morton ordered cell
+# list (CellsMorton) against the plain cell list (Cells) for large
+# dilute hard sphere systems, where most events are cell transitions.
+# The largest system has more than 255 cells per side, which the
+# Morton cell list could not hold before it used 64 bit morton
+# numbers. Build with -mbmi2 (or -march=native) to use the pdep/pext
+# instructions for the dilated integers.
+#
+# Results are appended to morton.dat as
+# "N neighbourlist events/s cell-transitions/s mean-transition-time peakRSS(kB)".
+
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+Xml="xml"
+which $Xml > /dev/null || Xml="xmlstarlet"
+
+NCOLL=2000000
+DENSITY=0.1
+#Unit cells per side, the systems have 4*C^3 particles
+CELLS="20 50 80"
+
+function celltest {
+    #$1 is the neighbour list type
+    bzcat start.xml.bz2 \
+	| $Xml ed -u "//Globals/Global[@Name='SchedulerNBList']/@Type" -v "$1" \
+	| bzip2 > bench.xml.bz2
+
+    $dynarun bench.xml.bz2 -c $NCOLL -o end.dyn -L EventProfile > run.log 2>&1
+    local rate=$(bzcat output.xml.bz2 | $Xml sel -t -v '/OutputData/Misc/Timing/CollPerSec/@val')
+    local duration=$(bzcat output.xml.bz2 | $Xml sel -t -v '/OutputData/Misc/Timing/Duration/@val')
+    local count=$(bzcat output.xml.bz2 | $Xml sel -t -v "/OutputData/EventProfile/Event[@Type='CELL']/@Count")
+    local time=$(bzcat output.xml.bz2 | $Xml sel -t -v "/OutputData/EventProfile/Event[@Type='CELL']/@MeanTime")
+    local rss=$(bzcat output.xml.bz2 | $Xml sel -t -v '/OutputData/Misc/Memusage/@MaxKiloBytes')
+    echo $rate $(echo $count $duration | gawk '{print $1 / $2}') $time $rss
+}
+
+> morton.dat
+for C in $CELLS; do
+    N=$((4 * C * C * C))
+    $dynamod -s 1 -m 0 -d $DENSITY -C $C -o start.xml.bz2 > /dev/null
+
+    for NB in Cells CellsMorton; do
+	echo "$NB, $N particles"
+	echo $N $NB $(celltest $NB) | tee -a morton.dat
+    done
+done
+
+rm -f start.xml.bz2 bench.xml.bz2 end.dyn output.xml.bz2 run.log
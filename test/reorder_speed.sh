@@ -0,0 +1,68 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Measures the effect of the periodic particle reordering (dynarun
+# --reorder) on large hard sphere systems. The crystal generated by
+# dynamod is numbered in lattice order, so the systems are first
+# equilibrated for long enough that the particles have diffused away
+# from their neighbours in the numbering. The same equilibrated
+# configuration is then run with and without reordering.
+#
+# Results are appended to reorder.dat as
+# "N density reorder-period events/s peakRSS(kB)"
+# where a reorder period of 0 is the run without reordering.
+
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+Xml="xml"
+which $Xml > /dev/null || Xml="xmlstarlet"
+
+#Unit cells per side, the system has 4*C^3 (10^6 for C=63) particles
+C=${C:-63}
+DENSITIES=${DENSITIES:-"0.1 0.5"}
+#Events of the equilibration, which mixes up the particle order
+NEQUIL=${NEQUIL:-50000000}
+NCOLL=${NCOLL:-20000000}
+#The time between reorderings
+PERIOD=${PERIOD:-10}
+
+function reordertest {
+    #$1 is the reorder period, or 0 to not reorder
+    local opts=""
+    if [ $1 != 0 ]; then opts="--reorder $1"; fi
+
+    $dynarun equil.dyn -c $NCOLL $opts -o end.dyn > run.log 2>&1 \
+	|| { echo "FAILED"; return; }
+    local rate=$(bzcat output.xml.bz2 | $Xml sel -t -v '/OutputData/Misc/Timing/CollPerSec/@val')
+    local rss=$(bzcat output.xml.bz2 | $Xml sel -t -v '/OutputData/Misc/Memusage/@MaxKiloBytes')
+    echo $rate $rss
+}
+
+> reorder.dat
+for DENSITY in $DENSITIES; do
+    N=$((4 * C * C * C))
+    $dynamod -s 1 -m 0 -d $DENSITY -C $C -o start.xml.bz2 > /dev/null
+    echo "Equilibrating $N particles at a density of $DENSITY"
+    $dynarun -s 1 -E start.xml.bz2 -c $NEQUIL -o equil.dyn > /dev/null
+
+    for P in 0 $PERIOD; do
+	echo "Reorder period $P, $N particles at a density of $DENSITY"
+	echo $N $DENSITY $P $(reordertest $P) | tee -a reorder.dat
+    done
+done
+
+rm -f start.xml.bz2 equil.dyn end.dyn output.xml.bz2 run.log
@@ -0,0 +1,61 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Measures how long snapshots pause a large square well simulation.
+# The run is repeated without snapshots, with snapshots written on the
+# simulation thread and with snapshots written in the background as
+# compressed XML and binary files. The wall clock time of each run is
+# appended to snapshot.<N>.dat as "mode seconds", and for the
+# background snapshots the total and maximum time the simulation was
+# stalled (as reported in the Misc output) is appended too.
+
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+Xml="xml"
+which $Xml || Xml="xmlstarlet"
+
+#Unit cells per side, the systems have 4*C^3 particles
+CELLS="63"
+EVENTS=100000
+PERIOD=0.05
+
+function runtime {
+    local start=$(date +%s.%N)
+    $dynarun sw.dyn -c $EVENTS "$@" > /dev/null
+    local end=$(date +%s.%N)
+    echo "$end - $start" | gawk '{print $1 - $3}'
+}
+
+function stall {
+    bzcat output.xml.bz2 | $Xml sel -t -v '//Checkpoints/@Count' -o ' ' \
+	-v '//Checkpoints/@TotalStall' -o ' ' -v '//Checkpoints/@MaxStall'
+}
+
+for C in $CELLS; do
+    N=$((4 * C * C * C))
+    $dynamod -m 1 -d 0.8 -C $C -o sw.dyn > /dev/null
+
+    > snapshot.$N.dat
+    echo "Square well fluid, $N particles"
+    echo "none" $(runtime) | tee -a snapshot.$N.dat
+    echo "sync" $(runtime --snapshot $PERIOD --snapshot-sync) | tee -a snapshot.$N.dat
+    echo "xml.bz2" $(runtime --snapshot $PERIOD) $(stall) | tee -a snapshot.$N.dat
+    echo "dyn" $(runtime --snapshot $PERIOD --snapshot-file "Snapshot.%i.dyn") $(stall) \
+	| tee -a snapshot.$N.dat
+done
+
+rm -f sw.dyn Snapshot.*.xml.bz2 Snapshot.*.dyn config.out.xml.bz2 output.xml.bz2
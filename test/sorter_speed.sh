@@ -0,0 +1,72 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Measures the events per second of every event Sorter. Each system
+# is run from the same starting configuration for every sorter, so
+# the same stream of event times is replayed through each sorter.
+# Results are appended to sorters.<system>.dat as
+# "sorter mean stddev exception-events".
+
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+Xml="xml"
+which $Xml > /dev/null || Xml="xmlstarlet"
+
+NUMRUN=3
+NCOLL=1000000
+SORTERS="CBT BoundedPQ BoundedPQSingleEvent BoundedPQMinMax2 BoundedPQMinMax3 \
+BoundedPQMinMax4 BoundedPQMinMax8 CalendarQueue CalendarQueueSingleEvent \
+CalendarQueueMinMax3"
+
+function runtest {
+    > speedvals
+    > exceptvals
+    for i in $(seq 1 $NUMRUN); do
+	$dynarun $1 -c $NCOLL > run.log 2>&1
+	grep "Avg Coll" run.log | gawk '{print $4}' >> speedvals
+	grep "Exception Events" run.log | tail -n 1 | gawk '{print $NF}' >> exceptvals
+    done
+    echo $(cat speedvals | gawk 'BEGIN {sum=0; sqrsum=0} { sum += $1; sqrsum += $1*$1} END {print sum/NR, sqrt((sqrsum - sum * sum /NR) / NR)}') \
+	$(cat exceptvals | gawk 'BEGIN {max=0} {if ($1 > max) max=$1} END {print max}')
+}
+
+function sortertest {
+    #$1 is the starting configuration, $2 the name of the system
+    > sorters.$2.dat
+
+    for S in $SORTERS; do
+	bzcat $1 | $Xml ed -u '//Simulation/Scheduler/Sorter/@Type' -v "$S" \
+	    | bzip2 > bench.xml.bz2
+	echo "$S sorter on $2"
+	echo $S $(runtest bench.xml.bz2) | tee -a sorters.$2.dat
+    done
+
+    rm -f bench.xml.bz2 speedvals exceptvals run.log
+}
+
+#A dense hard sphere fluid, 32000 particles
+$dynamod -m 0 -d 0.9 -C 20 -o dense.start.xml.bz2 > /dev/null
+sortertest dense.start.xml.bz2 denseHS
+
+#A dilute hard sphere gas, where the event times are widely spread
+$dynamod -m 0 -d 0.01 -C 20 -o dilute.start.xml.bz2 > /dev/null
+sortertest dilute.start.xml.bz2 diluteHS
+
+#Spheres falling under gravity onto static spheres
+sortertest static-spheres.xml.bz2 gravity
+
+rm -f dense.start.xml.bz2 dilute.start.xml.bz2 config.out.xml.bz2 output.xml.bz2
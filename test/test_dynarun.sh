@@ -335,6 +335,96 @@ function HardSphereTest {
 	tmp.xml.bz2 run.log
 }
 
+function ThreadedHardSphereTest {
+    > run.log
+
+    $Dynamod -s 1 -m 0 &> run.log    
+    bzcat config.out.xml.bz2 | \
+	$Xml ed -u '//Simulation/Scheduler/@Type' -v "ThreadedNeighbourList" \
+	| $Xml ed -s '//Simulation/Scheduler' -t attr -n ThreadCount -v $1 \
+	| bzip2 > tmp.xml.bz2
+
+    $Dynarun -c 500000 tmp.xml.bz2 >> run.log 2>&1
+    $Dynarun -c 1000000 config.out.xml.bz2 >> run.log 2>&1
+    
+    if [ -e output.xml.bz2 ]; then
+	if [ $(bzcat output.xml.bz2 \
+	    | $Xml sel -t -v '/OutputData/Misc/totMeanFreeTime/@val' \
+	    | gawk '{printf "%.3f",$1}') != "0.130" ]; then
+	    echo "ThreadedHardSphereTest -: FAILED"
+	    exit 1
+	else
+	    echo "ThreadedHardSphereTest -: PASSED"
+	fi
+    else
+	echo "Error, no output.xml.bz2 in Threaded Hard Sphere test"
+	exit 1
+    fi
+    
+#Cleanup
+    rm -Rf config.end.xml.bz2 config.out.xml.bz2 output.xml.bz2 \
+	tmp.xml.bz2 run.log
+}
+
+function DomainDecompositionTest {
+    > run.log
+
+    $Dynamod -s 1 -m 0 &> run.log    
+    $Dynarun -c 500000 config.out.xml.bz2 >> run.log 2>&1
+    $Dynarun -c 1000000 --engine 4 $1 config.out.xml.bz2 >> run.log 2>&1
+    
+    if [ -e output.xml.bz2 ]; then
+	if [ $(bzcat output.xml.bz2 \
+	    | $Xml sel -t -v '/OutputData/Misc/totMeanFreeTime/@val' \
+	    | gawk '{printf "%.3f",$1}') != "0.130" ]; then
+	    echo "DomainDecompositionTest -: FAILED"
+	    exit 1
+	else
+	    echo "DomainDecompositionTest -: PASSED"
+	fi
+    else
+	echo "Error, no output.xml.bz2 in Domain Decomposition test"
+	exit 1
+    fi
+    
+#Cleanup
+    rm -Rf config.end.xml.bz2 config.out.xml.bz2 output.xml.bz2 \
+	run.log
+}
+
+function DomainTransportTest {
+    > run.log
+
+    $Dynamod -s 1 -m 0 &> run.log    
+    $Dynarun -c 500000 config.out.xml.bz2 >> run.log 2>&1
+    mv config.out.xml.bz2 config.start.xml.bz2
+
+    #Rank 1 runs in the background, only rank 0 writes the output
+    $Dynarun -c 1000000 --engine 4 --domains 2 --domain-rank 1 \
+	--domain-transport unix:domain.sock config.start.xml.bz2 > rank1.log 2>&1 &
+    $Dynarun -c 1000000 --engine 4 --domains 2 --domain-rank 0 \
+	--domain-transport unix:domain.sock config.start.xml.bz2 >> run.log 2>&1
+    wait
+    
+    if [ -e output.xml.bz2 ]; then
+	if [ $(bzcat output.xml.bz2 \
+	    | $Xml sel -t -v '/OutputData/Misc/totMeanFreeTime/@val' \
+	    | gawk '{printf "%.3f",$1}') != "0.130" ]; then
+	    echo "DomainTransportTest -: FAILED"
+	    exit 1
+	else
+	    echo "DomainTransportTest -: PASSED"
+	fi
+    else
+	echo "Error, no output.xml.bz2 in Domain Transport test"
+	exit 1
+    fi
+    
+#Cleanup
+    rm -Rf config.start.xml.bz2 config.out.xml.bz2 output.xml.bz2 \
+	run.log rank1.log domain.sock.*
+}
+
 function SquareWellTest {
     > run.log
 
@@ -367,6 +457,213 @@ function SquareWellTest {
 	tmp.xml.bz2 run.log
 }
 
+function CaptureMapRebuildTest {
+    > run.log
+
+    #No thermostat, so the trajectories are deterministic
+    $Dynamod -s1 -m 1 &> run.log    
+    $Dynarun -c 100000 config.out.xml.bz2 >> run.log 2>&1
+    mv config.out.xml.bz2 config.stored.xml.bz2
+    bzcat config.stored.xml.bz2 | $Xml ed -d '//CaptureMap' | bzip2 > config.rebuild.xml.bz2
+
+    #The rebuilt capture map must give the same trajectory as the
+    #stored one, the order the pairs are written out in may differ
+    $Dynarun -c 100000 config.stored.xml.bz2 -o config.end1.xml.bz2 >> run.log 2>&1
+    $Dynarun -c 100000 -N $1 config.rebuild.xml.bz2 -o config.end2.xml.bz2 >> run.log 2>&1
+
+    for i in 1 2; do
+	bzcat config.end$i.xml.bz2 | $Xml sel -t -v 'count(//CaptureMap/Pair)' > pairs$i
+	bzcat config.end$i.xml.bz2 | $Xml ed -d '//CaptureMap' > config$i
+    done
+
+    if [ -e config.end2.xml.bz2 ] && cmp -s pairs1 pairs2 && cmp -s config1 config2; then
+	echo "CaptureMapRebuildTest -: PASSED"
+    else
+	echo "CaptureMapRebuildTest -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf config.stored.xml.bz2 config.rebuild.xml.bz2 config.end1.xml.bz2 \
+	config.end2.xml.bz2 pairs1 pairs2 config1 config2 output.xml.bz2 run.log
+}
+
+function BinaryConfigTest {
+    > run.log
+
+    #No thermostat, so the trajectories are deterministic
+    $Dynamod -s1 -m 1 &> run.log    
+    $Dynarun -c 100000 config.out.xml.bz2 -o config.start.xml.bz2 >> run.log 2>&1
+
+    #Running from a binary configuration must give the same
+    #trajectory, and converting it back to XML must not lose anything
+    $Dynarun -c 100000 config.start.xml.bz2 -o config.end1.xml.bz2 >> run.log 2>&1
+    $Dynamod config.start.xml.bz2 -o config.start.dyn >> run.log 2>&1
+    $Dynarun -c 100000 config.start.dyn -o config.end2.dyn >> run.log 2>&1
+    $Dynamod config.end2.dyn -o config.end2.xml.bz2 >> run.log 2>&1
+
+    for i in 1 2; do
+	bzcat config.end$i.xml.bz2 | $Xml sel -t -v 'count(//CaptureMap/Pair)' > pairs$i
+	bzcat config.end$i.xml.bz2 | $Xml ed -d '//CaptureMap' -d '//History' -d '//Trajectory' > config$i
+    done
+
+    if [ -e config.end2.xml.bz2 ] && cmp -s pairs1 pairs2 && cmp -s config1 config2; then
+	echo "BinaryConfigTest -: PASSED"
+    else
+	echo "BinaryConfigTest -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf config.out.xml.bz2 config.start.xml.bz2 config.start.dyn \
+	config.end1.xml.bz2 config.end2.dyn config.end2.xml.bz2 \
+	pairs1 pairs2 config1 config2 output.xml.bz2 run.log
+}
+
+function SnapshotTest {
+    > run.log
+
+    #No thermostat, so the trajectories are deterministic
+    $Dynamod -s1 -m 1 &> run.log    
+    $Dynarun -c 100000 config.out.xml.bz2 -o config.start.xml.bz2 >> run.log 2>&1
+
+    #Snapshots written in the background (as XML and binary files)
+    #must match those written on the simulation thread
+    $Dynarun -c 100000 config.start.xml.bz2 --snapshot 1 --snapshot-sync \
+	--snapshot-file "sync.%i.xml.bz2" >> run.log 2>&1
+    $Dynarun -c 100000 config.start.xml.bz2 --snapshot 1 \
+	--snapshot-file "async.%i.xml.bz2" >> run.log 2>&1
+    $Dynarun -c 100000 config.start.xml.bz2 --snapshot 1 \
+	--snapshot-file "async.%i.dyn" >> run.log 2>&1
+
+    #The binary snapshot is compared after both are converted by dynamod
+    $Dynamod sync.2.xml.bz2 -o xml.xml.bz2 >> run.log 2>&1
+    $Dynamod async.2.dyn -o binary.xml.bz2 >> run.log 2>&1
+
+    bzcat sync.2.xml.bz2 > config1
+    bzcat async.2.xml.bz2 > config2
+    bzcat xml.xml.bz2 | $Xml ed -d '//CaptureMap' -d '//History' -d '//Trajectory' > config3
+    bzcat binary.xml.bz2 | $Xml ed -d '//CaptureMap' -d '//History' -d '//Trajectory' > config4
+
+    if [ -e sync.2.xml.bz2 ] && [ -e async.2.dyn ] \
+	&& cmp -s config1 config2 && cmp -s config3 config4 \
+	&& [ $(bzcat output.xml.bz2 | $Xml sel -t -v '//Checkpoints/@Count') -gt 2 ]; then
+	echo "SnapshotTest -: PASSED"
+    else
+	echo "SnapshotTest -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf config.out.xml.bz2 config.start.xml.bz2 sync.*.xml.bz2 \
+	async.*.xml.bz2 async.*.dyn xml.xml.bz2 binary.xml.bz2 config1 config2 \
+	config3 config4 output.xml.bz2 run.log
+}
+
+function RestartTest {
+    > run.log
+
+    #A thermostatted square well fluid, so the random number
+    #generators and the system events are part of the checkpoint
+    $Dynamod -s1 -m 1 -T 1.0 &> run.log
+    $Dynarun -c 20000 config.out.xml.bz2 -o config.start.dyn >> run.log 2>&1
+
+    #A run split at a binary checkpoint must end in the same state as
+    #the uninterrupted run
+    $Dynarun -c 100000 config.start.dyn -o full.dyn >> run.log 2>&1
+    $Dynarun -c 50000 config.start.dyn -o half.dyn >> run.log 2>&1
+    $Dynarun -c 50000 half.dyn -o split.dyn >> run.log 2>&1
+
+    $Dynamod full.dyn -o full.xml.bz2 >> run.log 2>&1
+    $Dynamod split.dyn -o split.xml.bz2 >> run.log 2>&1
+    #The capture map is unordered, so it is not compared
+    bzcat full.xml.bz2 | $Xml ed -d '//CaptureMap' -d '//History' > config1
+    bzcat split.xml.bz2 | $Xml ed -d '//CaptureMap' -d '//History' > config2
+
+    if [ -e split.dyn ] && cmp -s config1 config2 \
+	&& grep -q "Restored the event queue" run.log; then
+	echo "RestartTest -: PASSED"
+    else
+	echo "RestartTest -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf config.out.xml.bz2 config.start.dyn full.dyn half.dyn split.dyn \
+	full.xml.bz2 split.xml.bz2 config1 config2 output.xml.bz2 run.log
+}
+
+function ReorderTest {
+    > run.log
+
+    #No thermostat, so the trajectories are deterministic. The walls
+    #test that the particles stay in their cells when renumbered.
+    $Dynamod -s1 -m 1 &> run.log
+    $Dynarun -c 100000 config.out.xml.bz2 -o config.start.xml.bz2 >> run.log 2>&1
+    $Dynamod -s1 -m 6 -o walls.start.xml.bz2 >> run.log 2>&1
+
+    #Renumbering the particles only perturbs the rounding, so over a
+    #short run the particles must end in the same place, and the
+    #output must keep the original numbering
+    for system in config walls; do
+	$Dynarun -h 0.5 $system.start.xml.bz2 -o $system.end1.xml.bz2 >> run.log 2>&1
+	$Dynarun -h 0.5 $system.start.xml.bz2 --reorder 0.05 -L MSD \
+	    -o $system.end2.xml.bz2 >> run.log 2>&1
+	for i in 1 2; do
+	    bzcat $system.end$i.xml.bz2 | $Xml sel -t -m '//Pt' -v 'P/@x' -o ' ' \
+		-v 'P/@y' -o ' ' -v 'P/@z' -n > $system.pos$i
+	done
+    done
+    bzcat config.end1.xml.bz2 | $Xml sel -t -v 'count(//CaptureMap/Pair)' > pairs1
+    bzcat config.end2.xml.bz2 | $Xml sel -t -v 'count(//CaptureMap/Pair)' > pairs2
+
+    if [ -e walls.end2.xml.bz2 ] && cmp -s pairs1 pairs2 \
+	&& [ $(paste config.pos1 config.pos2 walls.pos1 walls.pos2 | gawk \
+	'{for (i=1; i<=3; ++i) {d=$i-$(i+3); e=$(i+6)-$(i+9); if (d<0) d=-d; if (e<0) e=-e;
+          if (d>m) m=d; if (e>m) m=e}} END {print (NR > 0) && (m < 1e-8)}') == "1" ]; then
+	echo "ReorderTest -: PASSED"
+    else
+	echo "ReorderTest -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf config.out.xml.bz2 config.start.xml.bz2 walls.start.xml.bz2 \
+	config.end1.xml.bz2 config.end2.xml.bz2 walls.end1.xml.bz2 \
+	walls.end2.xml.bz2 config.pos1 config.pos2 walls.pos1 walls.pos2 \
+	pairs1 pairs2 output.xml.bz2 run.log
+}
+
+function EventProfileTest {
+    > run.log
+
+    #No thermostat, so only the interactions count as collisions
+    $Dynamod -s1 -m 1 &> run.log
+    $Dynarun -c 100000 config.out.xml.bz2 -o plain.xml.bz2 >> run.log 2>&1
+    $Dynarun -c 100000 config.out.xml.bz2 -o profiled.xml.bz2 \
+	-L EventProfile:SampleInterval=4 >> run.log 2>&1
+
+    #Profiling must not change the trajectory
+    bzcat plain.xml.bz2 | $Xml ed -d '//History' > config1
+    bzcat profiled.xml.bz2 | $Xml ed -d '//History' > config2
+
+    if cmp -s config1 config2 \
+	&& [ $(bzcat output.xml.bz2 \
+	| $Xml sel -t -v "//EventProfile/Event[@Type='INTERACTION']/@Count") \
+	= "100000" ] \
+	&& [ $(bzcat output.xml.bz2 \
+	| $Xml sel -t -v "//EventProfile/Event[@Type='CELL']/@Samples") -gt 0 ]; then
+	echo "EventProfileTest -: PASSED"
+    else
+	echo "EventProfileTest -: FAILED"
+	exit 1
+    fi
+
+#Cleanup
+    rm -Rf config.out.xml.bz2 plain.xml.bz2 profiled.xml.bz2 config1 config2 \
+	output.xml.bz2 run.log
+}
+
 function BinarySphereTest {
     > run.log
 
@@ -585,6 +882,10 @@ echo "Testing basic system, zero + infinite time events, hard sphere, PBC, Neigh
 cannon "NeighbourList" "CBT"
 echo "Testing basic system, zero + infinite time events, hard sphere, PBC, Neighbour lists + scheduler, globals, boundedPQ"
 cannon "NeighbourList" "BoundedPQ"
+echo "Testing basic system, zero + infinite time events, hard spheres, PBC, Dumb Scheduler, CalendarQueue"
+cannon "Dumb" "CalendarQueue"
+echo "Testing basic system, zero + infinite time events, hard sphere, PBC, Neighbour lists + scheduler, globals, CalendarQueue"
+cannon "NeighbourList" "CalendarQueue"
 
 echo ""
 echo "INTERACTIONS+Dynamod Systems"
@@ -594,6 +895,18 @@ echo "Testing binary hard spheres, NeighbourLists and BoundedPQ's"
 BinarySphereTest "Cells2"
 echo "Testing Square Wells, Thermostats, NeighbourLists and BoundedPQ's"
 SquareWellTest
+echo "Testing rebuilding the square well capture map on 2 threads"
+CaptureMapRebuildTest 2
+echo "Testing running from and converting binary configuration files"
+BinaryConfigTest
+echo "Testing writing snapshots in the background"
+SnapshotTest
+echo "Testing restarting exactly from binary checkpoints"
+RestartTest
+echo "Testing profiling the event loop"
+EventProfileTest
+echo "Testing the reordering of the particles"
+ReorderTest
 echo "Testing infinitely heavy particles"
 HeavySphereTest
 echo "Testing Lines, NeighbourLists and BoundedPQ's"
@@ -642,4 +955,10 @@ echo ""
 echo "THREADING TESTING"
 echo "Testing replica exchange with 3 threads"
 HS_replex_test "NeighbourList" "-N3"
+echo "Testing the ThreadedNeighbourList scheduler with 2 threads"
+ThreadedHardSphereTest 2
+echo "Testing the domain decomposition engine with 2 domains"
+DomainDecompositionTest "--domains 2 -N2"
 
+echo "Testing the domain decomposition engine with 2 processes"
+DomainTransportTest
@@ -0,0 +1,66 @@
+#!/bin/bash
+#    DYNAMO:- Event driven molecular dynamics simulator 
+#    http://www.marcusbannerman.co.uk/dynamo
+#    Copyright (C) 2011  Marcus N Campbell Bannerman <m.bannerman@gmail.com>
+#
+#    This program is free software: you can redistribute it and/or
+#    modify it under the terms of the GNU General Public License
+#    version 3 as published by the Free Software Foundation.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Measures the events per second of the ThreadedNeighbourList
+# scheduler as a function of the thread count, alongside the serial
+# NeighbourList scheduler. Results are appended to
+# threadedNBList.<system>.dat as "threads mean stddev".
+
+dynamod="../bin/dynamod"
+dynarun="../bin/dynarun"
+Xml="xml"
+which $Xml > /dev/null || Xml="xmlstarlet"
+
+NUMRUN=3
+NCOLL=1000000
+THREADS="1 2 4 8"
+
+function runtest {
+    > speedvals
+    for i in $(seq 1 $NUMRUN); do
+	$dynarun $1 -c $NCOLL | grep "Avg Coll" | gawk '{print $4}' >> speedvals
+    done
+    cat speedvals | gawk 'BEGIN {sum=0; sqrsum=0} { sum += $1; sqrsum += $1*$1} END {print sum/NR, sqrt((sqrsum - sum * sum /NR) / NR)}'
+}
+
+function threadtest {
+    #$1 is the starting configuration, $2 the name of the system
+    > threadedNBList.$2.dat
+
+    bzcat $1 | $Xml ed -u '//Simulation/Scheduler/@Type' -v "NeighbourList" \
+	| bzip2 > bench.serial.xml.bz2
+    echo "Serial NeighbourList scheduler on $2"
+    echo "serial" $(runtest bench.serial.xml.bz2) | tee -a threadedNBList.$2.dat
+
+    for T in $THREADS; do
+	bzcat $1 | $Xml ed -u '//Simulation/Scheduler/@Type' -v "ThreadedNeighbourList" \
+	    | $Xml ed -d '//Simulation/Scheduler/@ThreadCount' \
+	    | $Xml ed -s '//Simulation/Scheduler' -t attr -n ThreadCount -v $T \
+	    | bzip2 > bench.threaded.xml.bz2
+	echo "ThreadedNeighbourList scheduler with $T threads on $2"
+	echo $T $(runtest bench.threaded.xml.bz2) | tee -a threadedNBList.$2.dat
+    done
+
+    rm -f bench.serial.xml.bz2 bench.threaded.xml.bz2 speedvals
+}
+
+threadtest hvySpheres.xml.bz2 hvySpheres
+
+#A dense hard sphere fluid, 32000 particles
+$dynamod -m 0 -d 0.9 -C 20 -o dense.start.xml.bz2 > /dev/null
+threadtest dense.start.xml.bz2 denseHS
+rm -f dense.start.xml.bz2 config.out.xml.bz2 output.xml.bz2